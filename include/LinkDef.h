@@ -36,6 +36,8 @@
 #pragma link C++ namespace TCConfig;
 #pragma link C++ namespace TCUtils;
 #pragma link C++ class TCFileManager+;
+#pragma link C++ class TCHistoIndex+;
+#pragma link C++ class TCExtractor+;
 #pragma link C++ class TCReadConfig+;
 #pragma link C++ class TCConfigElement+;
 #pragma link C++ class TCReadARCalib+;
@@ -46,6 +48,19 @@
 #pragma link C++ class TCReadACQU+;
 #pragma link C++ class TCACQUFile+;
 #pragma link C++ class TCMySQLManager+;
+#pragma link C++ class TCSetTable+;
+#pragma link C++ class TCRunParameters+;
+#pragma link C++ class TCDBRow+;
+#pragma link C++ class TCDBResult+;
+#pragma link C++ class TCDBBackend+;
+#pragma link C++ class TCDBBackendMySQL+;
+#pragma link C++ class TCDBBackendSQLite+;
+#pragma link C++ struct TCSnapshotRun+;
+#pragma link C++ class TCSnapshot+;
+#pragma link C++ class TCCachedParameters+;
+#pragma link C++ class TCParameterCache+;
+#pragma link C++ class TCQueryShape+;
+#pragma link C++ class TCQueryStats+;
 #pragma link C++ class TCContainer+;
 #pragma link C++ class TCRun+;
 #pragma link C++ class TCCalibration+;
@@ -45,6 +45,11 @@ namespace TCConfig
     extern const Char_t* kCalibMainTableFormat; 
     extern const Char_t* kCalibDataTableHeader;
     extern const Char_t* kCalibDataTableSettings;
+    extern const Char_t* kCalibParentTableName;
+    extern const Char_t* kCalibParentTableFormat;
+    extern const Int_t kMaxOverlayDepth;
+    extern const Int_t kDumpChunkSize;
+    extern const Int_t kMaxInsertLength;
      
     // version numbers etc.
     extern const Char_t kCaLibVersion[];
@@ -0,0 +1,148 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCDBBackend                                                          //
+//                                                                      //
+// Database backends (connection and SQL dialect).                      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCDBBACKEND_H
+#define TCDBBACKEND_H
+
+#include "TSQLServer.h"
+#include "TSQLResult.h"
+#include "TSQLRow.h"
+#include "TSQLStatement.h"
+#include "TObjArray.h"
+#include "TError.h"
+
+
+class TCDBRow : public TSQLRow
+{
+
+private:
+    Int_t fNField;                  // number of fields
+    TString* fField;                //[fNField] field values
+    Bool_t* fNull;                  //[fNField] NULL flags of the fields
+
+public:
+    TCDBRow() : TSQLRow(), fNField(0), fField(0), fNull(0) { }
+    TCDBRow(Int_t nField);
+    virtual ~TCDBRow();
+
+    void SetField(Int_t i, const Char_t* value);
+
+    virtual void Close(Option_t* opt = "") { }
+    virtual ULong_t GetFieldLength(Int_t i);
+    virtual const char* GetField(Int_t i);
+
+    ClassDef(TCDBRow, 0) // Buffered database row
+};
+
+
+class TCDBResult : public TSQLResult
+{
+
+private:
+    Int_t fNField;                  // number of fields
+    TString* fFieldName;            //[fNField] field names
+    TObjArray* fRows;               // buffered rows
+    Int_t fNext;                    // index of the next row
+
+public:
+    TCDBResult() : TSQLResult(), fNField(0), fFieldName(0), fRows(0), fNext(0) { }
+    TCDBResult(Int_t nField);
+    virtual ~TCDBResult();
+
+    void SetFieldName(Int_t i, const Char_t* name) { fFieldName[i] = name; }
+    void AddRow(TCDBRow* row);
+
+    virtual void Close(Option_t* opt = "") { }
+    virtual Int_t GetFieldCount() { return fNField; }
+    virtual const char* GetFieldName(Int_t i) { return fFieldName[i].Data(); }
+    virtual TSQLRow* Next();
+
+    ClassDef(TCDBResult, 0) // Buffered database result
+};
+
+
+class TCDBBackend : public TObject
+{
+
+protected:
+    TString fURL;                   // database URL
+    TString fUser;                  // database user
+    TString fPass;                  // database password
+
+public:
+    TCDBBackend() : TObject(), fURL(), fUser(), fPass() { }
+    TCDBBackend(const Char_t* url, const Char_t* user, const Char_t* pass)
+        : TObject(), fURL(url), fUser(user), fPass(pass) { }
+    virtual ~TCDBBackend() { }
+
+    const Char_t* GetURL() const { return fURL.Data(); }
+    virtual const Char_t* GetType() const = 0;
+
+    virtual TSQLServer* Connect() const;
+    virtual TSQLResult* Query(TSQLServer* db, const Char_t* query) const;
+    virtual TString Quote(const Char_t* s) const;
+    virtual TString GetTableFormat(const Char_t* format) const { return TString(format); }
+    virtual TString GetTableTrigger(const Char_t* table) const { return TString(); }
+    virtual TString GetColumnsQuery(const Char_t* table) const = 0;
+    virtual Int_t GetColumnNameField() const = 0;
+    virtual TString GetTableQuery(const Char_t* table) const = 0;
+    virtual Bool_t HasParallelTransactions() const { return kTRUE; }
+
+    static TCDBBackend* Create(const Char_t* type, const Char_t* host, const Char_t* name,
+                               const Char_t* user, const Char_t* pass);
+
+    ClassDef(TCDBBackend, 0) // Database backend
+};
+
+
+class TCDBBackendMySQL : public TCDBBackend
+{
+
+public:
+    TCDBBackendMySQL() : TCDBBackend() { }
+    TCDBBackendMySQL(const Char_t* host, const Char_t* name, const Char_t* user, const Char_t* pass);
+    virtual ~TCDBBackendMySQL() { }
+
+    virtual const Char_t* GetType() const { return "mysql"; }
+    virtual TString Quote(const Char_t* s) const;
+    virtual TString GetColumnsQuery(const Char_t* table) const;
+    virtual Int_t GetColumnNameField() const { return 0; }
+    virtual TString GetTableQuery(const Char_t* table) const;
+
+    ClassDef(TCDBBackendMySQL, 0) // MySQL database backend
+};
+
+
+class TCDBBackendSQLite : public TCDBBackend
+{
+
+public:
+    TCDBBackendSQLite() : TCDBBackend() { }
+    TCDBBackendSQLite(const Char_t* filename);
+    virtual ~TCDBBackendSQLite() { }
+
+    virtual const Char_t* GetType() const { return "sqlite"; }
+    virtual TSQLServer* Connect() const;
+    virtual TSQLResult* Query(TSQLServer* db, const Char_t* query) const;
+    virtual TString GetTableFormat(const Char_t* format) const;
+    virtual TString GetTableTrigger(const Char_t* table) const;
+    virtual TString GetColumnsQuery(const Char_t* table) const;
+    virtual Int_t GetColumnNameField() const { return 1; }
+    virtual TString GetTableQuery(const Char_t* table) const;
+    virtual Bool_t HasParallelTransactions() const { return kFALSE; }  // one writer per file
+
+    ClassDef(TCDBBackendSQLite, 0) // SQLite database backend
+};
+
+#endif
+
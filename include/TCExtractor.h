@@ -0,0 +1,69 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCExtractor                                                          //
+//                                                                      //
+// Extract the CaLib histograms of input files into slim files.         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCEXTRACTOR_H
+#define TCEXTRACTOR_H
+
+#include "TFile.h"
+#include "TKey.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+#include "TClass.h"
+#include "TThread.h"
+#include "TMath.h"
+
+#include "TCReadConfig.h"
+
+
+class TCExtractor
+{
+
+private:
+    TString fInputFilePatt;                 // input file pattern
+    TString fOutputFilePatt;                // output file pattern
+    Int_t fNThreads;                        // number of extraction threads
+    TObjArray* fNames;                      // names of the extracted histograms
+    TObjArray* fFamilies;                   // name patterns of the element histogram families
+
+    Bool_t ExtractRun(Int_t run);
+    TH1* Pack(TObjArray* elem, const Char_t* pattern, TString* outMap);
+
+    static void* ExtractWorker(void* arg);
+
+public:
+    TCExtractor() : fInputFilePatt(), fOutputFilePatt(), fNThreads(1),
+                    fNames(0), fFamilies(0) { }
+    TCExtractor(const Char_t* inputPatt, const Char_t* outputPatt);
+    virtual ~TCExtractor();
+
+    void SetNThreads(Int_t n) { fNThreads = n > 0 ? n : 1; }
+    Int_t GetNThreads() const { return fNThreads; }
+    void AddHistogram(const Char_t* name);
+    void AddFamily(const Char_t* pattern);
+    void AddConfigHistograms();
+
+    Int_t Extract(Int_t nRun, const Int_t* runs);
+
+    static TString GetPackedName(const Char_t* pattern);
+    static Int_t GetPackedBin(const Char_t* map, Int_t index);
+    static Bool_t MatchPattern(const Char_t* pattern, const Char_t* name, Int_t* outIndex);
+
+    ClassDef(TCExtractor, 0) // Extract CaLib histograms into slim files
+};
+
+#endif
+
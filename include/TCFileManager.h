@@ -16,9 +16,23 @@
 
 #include "TFile.h"
 #include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TObjArray.h"
+#include "TMath.h"
+#include "TThread.h"
+#include "TMutex.h"
+#include "TObjString.h"
+#include "TMD5.h"
+#include "TKey.h"
+#include "TSystem.h"
+#include "THashList.h"
+#include "TStopwatch.h"
 
 #include "TCReadConfig.h"
 #include "TCMySQLManager.h"
+#include "TCHistoIndex.h"
+#include "TCExtractor.h"
 
 
 class TCFileManager
@@ -26,22 +40,108 @@ class TCFileManager
 
 private:
     TString fInputFilePatt;                 // input file pattern
-    TList* fFiles;                          // list of files
+    TObjArray* fFiles;                      // list of file names
     TString fCalibData;                     // calibration data
     TString fCalibration;                   // calibration identifier
     Int_t fNset;                            // number of sets
     Int_t* fSet;                            //[fNset] array of set numbers
+    Int_t fNRun;                            // number of runs
+    Int_t* fRun;                            //[fNRun] runs of the sets
+    TCHistoIndex* fIndex;                   // cumulative histogram index
+    TObjArray* fFamilies;                   // packed element histogram families
+    Int_t fNThreads;                        // number of summation threads
+    TString fCacheDir;                      // histogram cache directory
+    TString fFingerprint;                   // fingerprint of the input files
+    Int_t fNElem;                           // number of registered elements
+    TString* fElemName;                     //[fNElem] element histogram names
+    TH1** fElemHisto;                       //[fNElem] fetched element histograms
+    TString fElemProj;                      // element histogram projection
+    Char_t fElemAxis;                       // axis of the element slice ranges
+    Bool_t fElemUser;                       // element slice ranges in axis units
+    Double_t* fElemMin;                     //[fNElem] lower limits of element slice ranges
+    Double_t* fElemMax;                     //[fNElem] upper limits of element slice ranges
+    Int_t fBlockSize;                       // element histogram fetching block size
+    TFile** fFileHandle;                    // handles of the open files
+    Long64_t* fFileLastUse;                 // last use of the open files
+    Int_t* fFileUsers;                      // number of users of the open files
+    Int_t fNOpen;                           // number of open files
+    Int_t fMaxOpen;                         // maximum number of open files
+    Long64_t fUseCounter;                   // file use counter
+    TMutex* fPoolMutex;                     // open file pool mutex
+    Int_t* fFileOrder;                      // processing order of the files
+    Int_t fReadAhead;                       // number of files read ahead
+    Double_t fIOWait;                       // I/O wait time of the last summation [s]
+    TString fSliceProj;                     // projection of the fetched slices
+    Char_t fSliceAxis;                      // axis of the slice ranges
+    Bool_t fSliceUser;                      // slice ranges in axis units
+    const Double_t* fSliceMin;              // lower limits of the slice ranges
+    const Double_t* fSliceMax;              // upper limits of the slice ranges
     
     void BuildFileList();
+    void ReadFamilies();
+    void SortFiles();
+    void ReadAhead(Int_t i);
+    Int_t FindFamily(const Char_t* name, Int_t* outBin, TString* outProj, Char_t* outAxis);
+    Bool_t CheckFamily(TFile* f, const Char_t* name);
+    TFile* AcquireFile(Int_t i);
+    void ReleaseFile(Int_t i);
+    TString GetCacheFileName();
+    void ReadCache(Int_t n, const Char_t* const* names, TH1** outHisto);
+    void WriteCache(Int_t n, const Char_t* const* names, TH1** histo);
+    void SumFiles(Int_t n, const Char_t* const* names, TH1** outHisto,
+                  Int_t first, Int_t last);
+    void SumFilesParallel(Int_t n, const Char_t* const* names, TH1** outHisto);
+    void FetchHistograms(Int_t n, const Char_t* const* names, const Char_t* const* keys,
+                         TH1** outHisto);
+    TH1* Slice(TH1* h, Int_t i);
+
+    static Bool_t IsSameBinning(TH1* h1, TH1* h2);
+    static Bool_t AddSameBinning(TH1* sum, TH1* h);
+    static void* CheckWorker(void* arg);
+    static void* SumWorker(void* arg);
+    static void* ReduceWorker(void* arg);
 
 public:
     TCFileManager() : fInputFilePatt(0), fFiles(0), 
-                      fCalibData(), fCalibration(), fNset(0), fSet(0) { }
+                      fCalibData(), fCalibration(), fNset(0), fSet(0),
+                      fNRun(0), fRun(0), fIndex(0), fFamilies(0),
+                      fNThreads(1), fCacheDir(), fFingerprint(),
+                      fNElem(0), fElemName(0), fElemHisto(0), 
+                      fElemProj(), fElemAxis(0), fElemUser(kTRUE), fElemMin(0), fElemMax(0),
+                      fBlockSize(32),
+                      fFileHandle(0), fFileLastUse(0), fFileUsers(0),
+                      fNOpen(0), fMaxOpen(100), fUseCounter(0), fPoolMutex(0),
+                      fFileOrder(0), fReadAhead(4), fIOWait(0),
+                      fSliceProj(), fSliceAxis(0), fSliceUser(kTRUE), 
+                      fSliceMin(0), fSliceMax(0) { }
     TCFileManager(const Char_t* data, const Char_t* calibration, 
                   Int_t nSet, Int_t* set, const Char_t* filePat = 0);
     virtual ~TCFileManager();
 
+    void SetNThreads(Int_t n) { fNThreads = n > 0 ? n : 1; }
+    Int_t GetNThreads() const { return fNThreads; }
+    void SetCacheDir(const Char_t* dir) { fCacheDir = dir ? dir : ""; }
+    const Char_t* GetCacheDir() const { return fCacheDir.Data(); }
+    void SetBlockSize(Int_t n) { fBlockSize = n > 0 ? n : 0; }
+    Int_t GetBlockSize() const { return fBlockSize; }
+    void SetMaxOpenFiles(Int_t n) { fMaxOpen = n > 0 ? n : 1; }
+    Int_t GetMaxOpenFiles() const { return fMaxOpen; }
+    void SetReadAhead(Int_t n) { fReadAhead = n > 0 ? n : 0; }
+    Int_t GetReadAhead() const { return fReadAhead; }
+    Double_t GetIOWaitTime() const { return fIOWait; }
+
     TH1* GetHistogram(const Char_t* name);
+    void GetHistograms(Int_t n, const Char_t* const* names, TH1** outHisto);
+    TH1* GetSlice(const Char_t* name, const Char_t* proj, Char_t axis = 0,
+                  Double_t min = 0, Double_t max = -1, Bool_t user = kTRUE);
+    void GetSlices(Int_t n, const Char_t* const* names, TH1** outHisto,
+                   const Char_t* proj, Char_t axis, const Double_t* min, const Double_t* max,
+                   Bool_t user = kTRUE);
+    void SetElementHistograms(Int_t n, const Char_t* pattern, const Int_t* index = 0);
+    void SetElementProjection(const Char_t* proj, Char_t axis = 0,
+                              Double_t min = 0, Double_t max = -1);
+    void SetElementSlices(Int_t n, const Char_t* name, const Char_t* proj = "x");
+    TH1* GetElementHistogram(Int_t elem);
 
     ClassDef(TCFileManager, 0) // Histogram building class
 };
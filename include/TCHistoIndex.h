@@ -0,0 +1,69 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCHistoIndex                                                         //
+//                                                                      //
+// Cumulative histogram index over runs.                                //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCHISTOINDEX_H
+#define TCHISTOINDEX_H
+
+#include "TFile.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TNamed.h"
+#include "TObjArray.h"
+#include "TMath.h"
+#include "TSystem.h"
+
+
+class TCHistoIndex
+{
+
+private:
+    TString fFileName;                      // name of the index file
+    TFile* fFile;                           // index file
+    TString fPattern;                       // input file pattern
+    Int_t fStep;                            // checkpoint step
+    Int_t fNRun;                            // number of runs
+    Int_t* fRun;                            //[fNRun] run numbers (ascending)
+    TString* fStat;                         //[fNRun] file status of the runs
+
+    Int_t FindRun(Int_t run) const;
+    Bool_t CheckRuns(Int_t first, Int_t last);
+    TH1* GetCumulant(const Char_t* name, Int_t pos);
+    Bool_t AddRun(TH1* sum, const Char_t* name, Int_t pos, Double_t sign);
+
+    static TString GetFileStat(const Char_t* filename);
+    static TH1* CreateSum(TH1* h, const Char_t* name);
+    static Bool_t AddRaw(TH1* sum, TH1* h, Double_t sign);
+
+public:
+    TCHistoIndex() : fFileName(), fFile(0), fPattern(), fStep(0),
+                     fNRun(0), fRun(0), fStat(0) { }
+    TCHistoIndex(const Char_t* filename);
+    virtual ~TCHistoIndex();
+
+    Bool_t IsValid() const { return fFile && fNRun && fStep > 0; }
+    const Char_t* GetPattern() const { return fPattern.Data(); }
+    Int_t GetStep() const { return fStep; }
+    Int_t GetNRun() const { return fNRun; }
+
+    TH1* GetSum(const Char_t* name, Int_t nRun, const Int_t* runs);
+
+    static Bool_t Build(const Char_t* filename, const Char_t* pattern,
+                        Int_t nRun, const Int_t* runs,
+                        Int_t nName, const Char_t* const* names, Int_t step);
+
+    ClassDef(TCHistoIndex, 0) // Cumulative histogram index over runs
+};
+
+#endif
+
@@ -19,11 +19,16 @@
 #include "TSQLServer.h"
 #include "TSQLResult.h"
 #include "TSQLRow.h"
+#include "TSQLStatement.h"
 #include "TList.h"
 #include "TError.h"
 #include "TObjString.h"
 #include "TObjArray.h"
 #include "THashList.h"
+#include "TThread.h"
+#include "TMutex.h"
+#include "TCondition.h"
+#include "TStopwatch.h"
 
 #include "TCConfig.h"
 #include "TCCalibType.h"
@@ -31,6 +36,13 @@
 #include "TCReadACQU.h"
 #include "TCReadARCalib.h"
 #include "TCContainer.h"
+#include "TCUtils.h"
+#include "TCSetTable.h"
+#include "TCDBBackend.h"
+#include "TCSnapshot.h"
+#include "TCParameterCache.h"
+#include "TCQueryStats.h"
+#include "TCRunParameters.h"
 
 
 class TCMySQLManager
@@ -41,12 +53,62 @@ private:
     Bool_t fSilence;                            // silence mode toggle
     THashList* fData;                           // calibration data
     THashList* fTypes;                          // calibration types
+    THashList* fSetTables;                      // cached set tables
+    THashList* fStatements;                     // cached SQL of the prepared statements
+    THashList* fTableLayouts;                   // cached parameter layouts and existence of the tables
+    TCParameterCache* fParCache;                // cached parameters
+    THashList* fParents;                        // cached parent calibrations of the overlays
+    Long_t fParentsTime;                        // read time of the parent calibrations
+    TString fParCacheFile;                      // file of the cached parameters
+    Int_t fRevalidate;                          // revalidation interval of the cached set tables [s]
+    Int_t fCacheTrust;                          // time the cached set tables are trusted by the parameter cache [s]
+    Int_t fInsertChunk;                         // number of rows per multi-row insert
+    TCQueryStats* fQueryStats;                  // execution statistics of the queries
+    Double_t fSlowQuery;                        // execution time of slow queries [ms]
+    TCDBBackend* fBackend;                      // database backend
+    Int_t fNConn;                               // number of pooled connections
+    TSQLServer** fConn;                         //[fNConn] pooled connections
+    Long_t* fConnOwner;                         //[fNConn] threads owning the pooled connections
+    TMutex* fMutex;                             // cache mutex
+    TMutex* fPoolMutex;                         // connection pool mutex
+    TCondition* fConnFree;                      // signal of released pooled connections
     static TCMySQLManager* fgMySQLManager;      // pointer to static instance of this class
     
     Bool_t ReadCaLibData();
     Bool_t ReadCaLibTypes();
    
+    TSQLServer* GetConnection();
+    Int_t OpenConnections();
+    void CloseConnections();
+    Int_t RunParallel(Int_t type, Int_t nTask, void* arg, Bool_t transaction = kFALSE);
+    Bool_t RunTask(Int_t type, Int_t i, void* arg);
+    static void* ParallelWorker(void* arg);
+
     TSQLResult* SendQuery(const Char_t* query);
+    Bool_t ProcessStatement(TSQLStatement* stmt, const Char_t* sql, Bool_t store = kFALSE);
+    void RecordQuery(const Char_t* query, Double_t time, Long64_t rows);
+    Int_t InsertRows(const Char_t* table, const Char_t* columns, 
+                     Int_t nRow, const TString* values, Bool_t* outOK);
+    Bool_t StartTransaction();
+    Bool_t CommitTransaction();
+    void RollbackTransaction();
+    TCSetTable* GetSetTable(const Char_t* data, const Char_t* calibration, Bool_t resolve = kTRUE);
+    TCSetTable* ReadSetTable(const Char_t* table, const Char_t* calibration);
+    Bool_t ReadChangeTimes(const Char_t* table, const Char_t* calibration, 
+                           Int_t n, const Int_t* first_run, TString* outChanged);
+    THashList* ReadParentCalibrations();
+    TSQLStatement* PrepareStatement(const Char_t* type, const Char_t* table, Int_t length, Int_t nSet = 1,
+                                    TString* outSQL = 0);
+    TList* GetColumns(const Char_t* table);
+    Bool_t ContainsTable(const Char_t* table);
+    TString GetParameterColumns(const Char_t* table, Int_t length);
+    Bool_t IsPackedTable(const Char_t* table);
+    Bool_t PackDataTable(const Char_t* table);
+
+    static void SetParameters(TSQLStatement* stmt, Int_t first, Bool_t packed,
+                              const Double_t* par, Int_t length);
+    static void GetParameters(TSQLStatement* stmt, Int_t first, Bool_t packed,
+                              Double_t* par, Int_t length);
     
     Bool_t SearchTable(const Char_t* data, Char_t* outTableName);
     Bool_t SearchRunEntry(Int_t run, const Char_t* name, Char_t* outInfo);
@@ -65,9 +127,16 @@ private:
     Bool_t AddDataSet(const Char_t* data, const Char_t* calibration, const Char_t* desc,
                       Int_t first_run, Int_t last_run, Double_t par);
     Bool_t RemoveDataSet(const Char_t* data, const Char_t* calibration, Int_t set);
-    Bool_t SplitDataSet(const Char_t* data, const Char_t* calibration, Int_t set,
-                        Int_t lastRunFirstSet);
-    Bool_t MergeDataSets(const Char_t* data, const Char_t* calibration, 
+    Bool_t CloneDataSet(const Char_t* data, const Char_t* calibration, const Char_t* newCalibration,
+                        const Char_t* desc, Int_t first_run, Int_t last_run);
+    Bool_t CopyDataSets(const Char_t* data, const Char_t* calibration, const Char_t* newCalibration);
+    Bool_t MaterializeDataSets(const Char_t* data, const Char_t* calibration);
+    Bool_t MaterializeDataSets(TList* data, const Char_t* calibration);
+    Bool_t CheckSetRunRange(TList* data, const Char_t* calibration, 
+                            Int_t first_run, Int_t last_run);
+    Bool_t SplitDataSets(TList* data, const Char_t* calibration, Int_t set,
+                         Int_t lastRunFirstSet);
+    Bool_t MergeDataSets(TList* data, const Char_t* calibration, 
                          Int_t set1, Int_t set2);
 
 public:
@@ -79,10 +148,31 @@ public:
     
     const Char_t* GetDBName() const { return fDB ? fDB->GetDB() : 0; }
     const Char_t* GetDBHost() const { return fDB ? fDB->GetHost() : 0; }
+    TCDBBackend* GetBackend() const { return fBackend; }
+    TCParameterCache* GetParameterCache() const { return fParCache; }
+    void SetRevalidate(Int_t s) { fRevalidate = s; }
+    Int_t GetRevalidate() const { return fRevalidate; }
+    void SetCacheTrust(Int_t s) { fCacheTrust = s; }
+    Int_t GetCacheTrust() const { return fCacheTrust; }
+    void SetInsertChunk(Int_t n) { fInsertChunk = n > 0 ? n : 1; }
+    Int_t GetInsertChunk() const { return fInsertChunk; }
+    TCQueryStats* GetQueryStats() const { return fQueryStats; }
+    void SetSlowQuery(Double_t ms) { fSlowQuery = ms; }
+    Double_t GetSlowQuery() const { return fSlowQuery; }
+    void PrintQueryStats() const { fQueryStats->Print(); }
+    Bool_t SaveParameterCache();
+    static void SaveParameterCacheAtExit();
     THashList* GetDataTable() const { return fData; }
     THashList* GetTypeTable() const { return fTypes; }
+    void ClearSetTables(const Char_t* table = 0);
+    
+    void SetNConnections(Int_t n);
+    Int_t GetNConnections() const { return fNConn; }
+    TSQLServer* AcquireConnection();
+    void ReleaseConnection(TSQLServer* db);
     
     void CreateMainTable();
+    void CreateParentTable();
     void CreateDataTable(const Char_t* data, Int_t nElem);
  
     TList* GetAllCalibrations(const Char_t* data = "Data.Tagger.T0");
@@ -107,6 +197,16 @@ public:
                              Double_t* par, Int_t length);
     Bool_t WriteParameters(const Char_t* data, const Char_t* calibration, Int_t set, 
                            Double_t* par, Int_t length);
+    Bool_t WriteParametersSets(const Char_t* calibration, 
+                               Int_t nData, const Char_t* const* data,
+                               Int_t nSet, const Int_t* sets,
+                               Double_t* const* par, Int_t length);
+    TCRunParameters* ReadParametersRuns(const Char_t* calibration, 
+                                        Int_t nData, const Char_t* const* data,
+                                        Int_t nRun, const Int_t* runs);
+    TCRunParameters* ReadParametersRunRange(const Char_t* calibration,
+                                            Int_t nData, const Char_t* const* data,
+                                            Int_t first_run, Int_t last_run);
     
     Bool_t ChangeRunPath(Int_t first_run, Int_t last_run, const Char_t* path);
     Bool_t ChangeRunTarget(Int_t first_run, Int_t last_run, const Char_t* target);
@@ -125,6 +225,10 @@ public:
     Bool_t RemoveCalibration(const Char_t* calibration, const Char_t* data);
     Int_t RemoveAllCalibrations(const Char_t* calibration);
 
+    Bool_t CreateOverlay(const Char_t* calibration, const Char_t* parent);
+    TString GetParentCalibration(const Char_t* calibration);
+    Bool_t FlattenCalibration(const Char_t* calibration);
+
     Bool_t AddSet(const Char_t* type, const Char_t* calibration, const Char_t* desc,
                   Int_t first_run, Int_t last_run, Double_t par);
     Bool_t RemoveSet(const Char_t* type, const Char_t* calibration, Int_t set);
@@ -154,9 +258,11 @@ public:
     Int_t ImportCalibrations(TCContainer* container, const Char_t* newCalibName = 0,
                              const Char_t* data = 0);
     Bool_t CloneCalibration(const Char_t* calibration, const Char_t* newCalibrationName,
-                            const Char_t* newDesc, Int_t new_first_run, Int_t new_last_run);
+                            const Char_t* newDesc, Int_t new_first_run, Int_t new_last_run,
+                            Bool_t parallel = kFALSE);
     void Export(const Char_t* filename, Int_t first_run, Int_t last_run, 
                 const Char_t* calibration);
+    Bool_t ExportSnapshot(const Char_t* filename, const Char_t* calibration);
     void Import(const Char_t* filename, Bool_t runs, Bool_t calibrations,
                 const Char_t* newCalibName = 0);
 
@@ -0,0 +1,79 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCParameterCache                                                     //
+//                                                                      //
+// Client-side cache of calibration parameters.                         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCPARAMETERCACHE_H
+#define TCPARAMETERCACHE_H
+
+#include "TNamed.h"
+#include "THashList.h"
+#include "TMutex.h"
+#include "TFile.h"
+
+
+class TCCachedParameters : public TNamed
+{
+
+private:
+    Int_t fNPar;                    // number of parameters
+    Double_t* fPar;                 //[fNPar] parameters
+
+public:
+    TCCachedParameters() : TNamed(), fNPar(0), fPar(0) { }
+    TCCachedParameters(const Char_t* key, const Char_t* changed,
+                       const Double_t* par, Int_t length);
+    virtual ~TCCachedParameters() { if (fPar) delete [] fPar; }
+
+    const Char_t* GetChangeTime() const { return GetTitle(); }
+    Int_t GetNParameters() const { return fNPar; }
+    const Double_t* GetParameters() const { return fPar; }
+
+    virtual ULong_t Hash() const { return fName.Hash(); }
+
+    ClassDef(TCCachedParameters, 1) // Cached parameters of a set
+};
+
+
+class TCParameterCache : public TObject
+{
+
+private:
+    THashList* fEntries;            // cached parameters
+    TMutex* fMutex;                 // cache mutex
+    Long64_t fNHit;                 // number of cache hits
+    Long64_t fNMiss;                // number of cache misses
+
+public:
+    TCParameterCache();
+    virtual ~TCParameterCache();
+
+    Bool_t Get(const Char_t* table, const Char_t* calibration, Int_t first_run,
+               const Char_t* changed, Double_t* par, Int_t length);
+    void Set(const Char_t* table, const Char_t* calibration, Int_t first_run,
+             const Char_t* changed, const Double_t* par, Int_t length);
+    void Remove(const Char_t* table, const Char_t* calibration, Int_t first_run);
+    void Clear(const Char_t* table = 0);
+
+    Int_t GetNEntries() const { return fEntries->GetSize(); }
+    Long64_t GetNHit() const { return fNHit; }
+    Long64_t GetNMiss() const { return fNMiss; }
+
+    Int_t Load(const Char_t* filename, const Char_t* db);
+    Bool_t Save(const Char_t* filename, const Char_t* db);
+
+    static TString GetKey(const Char_t* table, const Char_t* calibration, Int_t first_run);
+
+    ClassDef(TCParameterCache, 0) // Client-side cache of calibration parameters
+};
+
+#endif
+
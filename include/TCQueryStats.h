@@ -0,0 +1,80 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCQueryStats                                                         //
+//                                                                      //
+// Execution statistics of the database queries.                        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCQUERYSTATS_H
+#define TCQUERYSTATS_H
+
+#include "TNamed.h"
+#include "THashList.h"
+#include "TMutex.h"
+
+
+class TCQueryShape : public TNamed
+{
+
+private:
+    Long64_t fNCall;                // number of calls
+    Long64_t fNSlow;                // number of slow calls
+    Long64_t fNRow;                 // number of returned or affected rows
+    Double_t fTotalTime;            // total execution time [s]
+    Double_t fMaxTime;              // maximum execution time [s]
+
+public:
+    TCQueryShape() : TNamed(), fNCall(0), fNSlow(0), fNRow(0),
+                     fTotalTime(0), fMaxTime(0) { }
+    TCQueryShape(const Char_t* shape);
+    TCQueryShape(const TCQueryShape& s);
+    virtual ~TCQueryShape() { }
+
+    void AddCall(Double_t time, Long64_t rows, Bool_t slow);
+
+    const Char_t* GetShape() const { return GetName(); }
+    Long64_t GetNCall() const { return fNCall; }
+    Long64_t GetNSlow() const { return fNSlow; }
+    Long64_t GetNRow() const { return fNRow; }
+    Double_t GetTotalTime() const { return fTotalTime; }
+    Double_t GetMeanTime() const { return fNCall ? fTotalTime / fNCall : 0; }
+    Double_t GetMaxTime() const { return fMaxTime; }
+
+    virtual ULong_t Hash() const { return fName.Hash(); }
+    virtual Bool_t IsSortable() const { return kTRUE; }
+    virtual Int_t Compare(const TObject* obj) const;
+
+    ClassDef(TCQueryShape, 1) // Execution statistics of a query shape
+};
+
+
+class TCQueryStats : public TObject
+{
+
+private:
+    THashList* fShapes;             // statistics of the query shapes
+    TMutex* fMutex;                 // statistics mutex
+
+public:
+    TCQueryStats();
+    virtual ~TCQueryStats();
+
+    void Add(const Char_t* query, Double_t time, Long64_t rows, Bool_t slow);
+    void Clear(Option_t* option = "");
+    TList* GetShapes();
+    Int_t GetNShapes() const { return fShapes->GetSize(); }
+    virtual void Print(Option_t* option = "") const;
+
+    static TString Normalize(const Char_t* query);
+
+    ClassDef(TCQueryStats, 0) // Execution statistics of the database queries
+};
+
+#endif
+
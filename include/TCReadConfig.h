@@ -61,6 +61,7 @@ public:
     Int_t GetConfigInt(TString configKey);
     Double_t GetConfigDouble(TString configKey);
     void GetConfigDoubleDouble(TString configKey, Double_t* out1, Double_t* out2);
+    THashTable* GetConfigTable() const { return fConfigTable; }
     
     static TCReadConfig* GetReader() 
     {
@@ -0,0 +1,65 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCRunParameters                                                      //
+//                                                                      //
+// Calibration parameters of many runs.                                 //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCRUNPARAMETERS_H
+#define TCRUNPARAMETERS_H
+
+#include "TObject.h"
+#include "TString.h"
+#include "TMath.h"
+
+
+class TCRunParameters : public TObject
+{
+
+private:
+    Int_t fNData;               // number of calibration data
+    TString* fData;             //[fNData] calibration data
+    Int_t* fNPar;               //[fNData] number of parameters of the data
+    Int_t* fNSet;               //[fNData] number of sets of the data
+    Double_t*** fPar;           // parameters of the sets of the data (shared by the runs)
+    Int_t fNRun;                // number of runs
+    Int_t* fRun;                //[fNRun] run numbers
+    Int_t* fRunOrder;           //[fNRun] indices of the runs in ascending run order
+    Int_t* fSet;                // set of the runs for all data
+
+public:
+    TCRunParameters() : TObject(), fNData(0), fData(0), fNPar(0), fNSet(0), fPar(0),
+                        fNRun(0), fRun(0), fRunOrder(0), fSet(0) { }
+    TCRunParameters(Int_t nData, const Char_t* const* data, Int_t nRun, const Int_t* runs);
+    virtual ~TCRunParameters();
+
+    void SetData(Int_t d, Int_t nPar, Int_t nSet);
+    void SetSetOfRun(Int_t d, Int_t i, Int_t set) { fSet[d*fNRun+i] = set; }
+    void SetParameters(Int_t d, Int_t set, const Double_t* par);
+    void ClearParameters(Int_t d, Int_t set);
+
+    Int_t GetNData() const { return fNData; }
+    const Char_t* GetData(Int_t d) const { return fData[d].Data(); }
+    Int_t GetNPar(Int_t d) const { return fNPar[d]; }
+    Int_t GetNRun() const { return fNRun; }
+    Int_t GetRun(Int_t i) const { return fRun[i]; }
+    Int_t GetSet(Int_t d, Int_t i) const { return fSet[d*fNRun+i]; }
+    const Double_t* GetParameters(Int_t d, Int_t i) const;
+    Bool_t GetParameters(const Char_t* data, Int_t run, Double_t* par, Int_t length) const;
+    Bool_t HasParameters(Int_t d, Int_t set) const 
+    { return set >= 0 && set < fNSet[d] && fPar[d][set]; }
+
+    Int_t FindData(const Char_t* data) const;
+    Int_t FindRun(Int_t run) const;
+
+    ClassDef(TCRunParameters, 0) // Calibration parameters of many runs
+};
+
+#endif
+
@@ -0,0 +1,57 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCSetTable                                                           //
+//                                                                      //
+// Run ranges and information of the sets of a calibration.             //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCSETTABLE_H
+#define TCSETTABLE_H
+
+#include "TNamed.h"
+
+
+class TCSetTable : public TNamed
+{
+
+private:
+    TString fCalibration;       // calibration identifier of the sets
+    Int_t fNSet;                // number of sets
+    Int_t* fFirstRun;           //[fNSet] first runs (ascending)
+    Int_t* fLastRun;            //[fNSet] last runs
+    TString* fDesc;             //[fNSet] descriptions
+    TString* fChanged;          //[fNSet] change times
+    Long_t fLoadTime;           // load time (seconds since the epoch)
+
+public:
+    TCSetTable() : TNamed(), fCalibration(), fNSet(0), fFirstRun(0), fLastRun(0), 
+                   fDesc(0), fChanged(0), fLoadTime(0) { }
+    TCSetTable(const Char_t* name, const Char_t* calibration, Int_t nSet);
+    TCSetTable(const TCSetTable& t);
+    virtual ~TCSetTable();
+ 
+    void SetSet(Int_t set, Int_t first_run, Int_t last_run,
+                const Char_t* desc, const Char_t* changed);
+
+    const Char_t* GetCalibration() const { return fCalibration.Data(); }
+    Int_t GetNSet() const { return fNSet; }
+    Int_t GetFirstRun(Int_t set) const { return fFirstRun[set]; }
+    Int_t GetLastRun(Int_t set) const { return fLastRun[set]; }
+    const Char_t* GetDescription(Int_t set) const { return fDesc[set].Data(); }
+    const Char_t* GetChangeTime(Int_t set) const { return fChanged[set].Data(); }
+    Long_t GetLoadTime() const { return fLoadTime; }
+    Int_t FindSet(Int_t run) const;
+
+    virtual ULong_t Hash() const { return fName.Hash(); }
+
+    ClassDef(TCSetTable, 0) // Run ranges and information of the sets of a calibration
+};
+
+#endif
+
@@ -0,0 +1,73 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCSnapshot                                                           //
+//                                                                      //
+// Read-only memory-mapped calibration snapshot file.                   //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TCSNAPSHOT_H
+#define TCSNAPSHOT_H
+
+#include "TObject.h"
+#include "TString.h"
+
+#include "TCContainer.h"
+
+
+// run information stored in a calibration snapshot
+struct TCSnapshotRun
+{
+    Int_t fRun;                     // run number
+    Int_t fNScR;                    // number of scaler reads
+    Long64_t fSize;                 // file size
+    Double_t fTargetPolDeg;         // target polarization degree
+    Double_t fBeamPolDeg;           // beam polarization degree
+    Char_t fTime[32];               // time
+    Char_t fFileName[256];          // file name
+    Char_t fTarget[24];             // target
+    Char_t fTargetPol[128];         // target polarization
+    Char_t fBeamPol[128];           // beam polarization
+};
+
+
+class TCSnapshot : public TObject
+{
+
+private:
+    TString fFileName;              // name of the snapshot file
+    Char_t* fMap;                   // mapped snapshot file
+    Long64_t fSize;                 // size of the mapped file
+    Int_t fNData;                   // number of calibration data
+    Int_t fNRun;                    // number of runs
+
+    Int_t FindData(const Char_t* data) const;
+
+public:
+    TCSnapshot() : TObject(), fFileName(), fMap(0), fSize(0), fNData(0), fNRun(0) { }
+    TCSnapshot(const Char_t* filename);
+    virtual ~TCSnapshot();
+
+    Bool_t IsValid() const { return fMap != 0; }
+    const Char_t* GetCalibration() const;
+    Int_t GetNData() const { return fNData; }
+    const Char_t* GetData(Int_t d) const;
+    Int_t GetNParameters(const Char_t* data) const;
+    Int_t GetNRun() const { return fNRun; }
+    Int_t FindRun(Int_t run) const;
+    const TCSnapshotRun* GetRun(Int_t run) const;
+    Int_t GetSet(const Char_t* data, Int_t run) const;
+    const Double_t* GetParameters(const Char_t* data, Int_t run, Int_t* outLength = 0) const;
+
+    static Bool_t Write(const Char_t* filename, TCContainer* container, const Char_t* calibration);
+
+    ClassDef(TCSnapshot, 0) // Read-only memory-mapped calibration snapshot file
+};
+
+#endif
+
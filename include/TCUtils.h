@@ -33,6 +33,8 @@ namespace TCUtils
     Bool_t IsCBHole(Int_t elem);
     Int_t GetVetoInFrontOfElement(Int_t id, Int_t maxTAPS);
     Double_t GetDiffPercent(Double_t oldValue, Double_t newValue);
+    void PackDoubles(const Double_t* in, Int_t n, UChar_t* out);
+    void UnpackDoubles(const UChar_t* in, Int_t n, Double_t* out);
 }
 
 #endif
@@ -0,0 +1,81 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// CaLibExtract                                                         //
+//                                                                      //
+// Extract the CaLib histograms of the input files of a calibration     //
+// into slim files.                                                     //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TCMySQLManager.h"
+#include "TCExtractor.h"
+
+
+//______________________________________________________________________________
+Int_t main(Int_t argc, Char_t* argv[])
+{
+    // Main method.
+    
+    // check arguments
+    if (argc < 3)
+    {
+        printf("Usage: calib_extract calib_data calibration [set1 set2 ...]\n");
+        printf("Extract the CaLib histograms of the runs of the given sets (default: all sets)\n");
+        printf("from the files File.Input.Rootfiles into the files File.Input.Slim.\n");
+        return 1;
+    }
+    const Char_t* data = argv[1];
+    const Char_t* calibration = argv[2];
+
+    // check connection to database
+    TCMySQLManager* m = TCMySQLManager::GetManager();
+    if (!m)
+    {
+        printf("No connection to CaLib database!\n");
+        return 1;
+    }
+
+    // get the sets (default: all sets)
+    Int_t nSet = argc - 3;
+    if (!nSet) nSet = m->GetNsets(data, calibration);
+    Int_t* set = new Int_t[nSet];
+    for (Int_t i = 0; i < nSet; i++) set[i] = argc > 3 ? atoi(argv[3+i]) : i;
+
+    // collect the runs of the sets
+    Int_t nRun = 0;
+    Int_t* runs = 0;
+    for (Int_t i = 0; i < nSet; i++)
+    {
+        Int_t n;
+        Int_t* r = m->GetRunsOfSet(data, calibration, set[i], &n);
+        if (!r) continue;
+        Int_t* tmp = new Int_t[nRun+n];
+        for (Int_t j = 0; j < nRun; j++) tmp[j] = runs[j];
+        for (Int_t j = 0; j < n; j++) tmp[nRun+j] = r[j];
+        if (runs) delete [] runs;
+        delete [] r;
+        runs = tmp;
+        nRun += n;
+    }
+    delete [] set;
+    if (!nRun)
+    {
+        printf("No runs found for calibration '%s' of '%s'!\n", calibration, data);
+        return 1;
+    }
+
+    // extract the histograms
+    TCExtractor e(0, 0);
+    Int_t nDone = e.Extract(nRun, runs);
+
+    // clean-up
+    delete [] runs;
+
+    return nDone == nRun ? 0 : 1;
+}
+
@@ -19,6 +19,7 @@
 #define KEY_ENTER_MINE 13
 #define KEY_ESC 27
 #define MAX_SCR_BAD_STRING 30000
+#define MAX_QUERY_STRING 1024
 
 
 // locally used enum for run entries
@@ -50,6 +51,7 @@ void SelectCalibration(const Char_t* mMsg = 0);
 void SelectCalibrationData();
 void SelectCalibrationType();
 void Administration();
+void QueryStatistics();
 
 //______________________________________________________________________________
 void Finish(Int_t sig)
@@ -475,6 +477,119 @@ WINDOW* FormatCalibTable(TCContainer& c, Int_t* outColLengthTot, WINDOW** outHea
     return table;
 }
 
+//______________________________________________________________________________
+WINDOW* FormatQueryTable(TList* shapes, Int_t* outColLengthTot, WINDOW** outHeader)
+{
+    // Format the query statistics table using the query shapes in 'shapes' and 
+    // return the created window.
+    // Save the maximum column length to 'outColLengthTot'.
+    // Save the header window in 'outHeader'.
+
+    // get number of query shapes
+    Int_t nShapes = shapes->GetSize();
+
+    // define col headers
+    const Char_t* colHead[] = { "Calls", "Total [ms]", "Mean [ms]", "Max [ms]", 
+                                "Rows", "Slow", "Query" };
+
+    // determine maximum col lengths
+    Char_t tmp_str[MAX_QUERY_STRING+1];
+    UInt_t colLength[7];
+
+    // loop over headers
+    for (Int_t i = 0; i < 7; i++) colLength[i] = strlen(colHead[i]);
+
+    // loop over query shapes
+    for (Int_t i = 0; i < nShapes; i++)
+    {
+        TCQueryShape* s = (TCQueryShape*) shapes->At(i);
+
+        // calls
+        sprintf(tmp_str, "%lld", s->GetNCall());
+        if (strlen(tmp_str) > colLength[0]) colLength[0] = strlen(tmp_str);
+
+        // total time
+        sprintf(tmp_str, "%.1f", 1000*s->GetTotalTime());
+        if (strlen(tmp_str) > colLength[1]) colLength[1] = strlen(tmp_str);
+        
+        // mean time
+        sprintf(tmp_str, "%.3f", 1000*s->GetMeanTime());
+        if (strlen(tmp_str) > colLength[2]) colLength[2] = strlen(tmp_str);
+        
+        // maximum time
+        sprintf(tmp_str, "%.3f", 1000*s->GetMaxTime());
+        if (strlen(tmp_str) > colLength[3]) colLength[3] = strlen(tmp_str);
+        
+        // rows
+        sprintf(tmp_str, "%lld", s->GetNRow());
+        if (strlen(tmp_str) > colLength[4]) colLength[4] = strlen(tmp_str);
+        
+        // slow calls
+        sprintf(tmp_str, "%lld", s->GetNSlow());
+        if (strlen(tmp_str) > colLength[5]) colLength[5] = strlen(tmp_str);
+        
+        // query
+        if (strlen(s->GetShape()) > colLength[6]) colLength[6] = strlen(s->GetShape());
+        if (colLength[6] > MAX_QUERY_STRING) colLength[6] = MAX_QUERY_STRING;
+    }
+    
+    // calculate the maximum col length (7*4 spaces)
+    Int_t colLengthTot = 7*4;
+    for (Int_t i = 0; i < 7; i++) colLengthTot += colLength[i];
+    *outColLengthTot = colLengthTot;
+
+    // create the table and the header window
+    WINDOW* table = newpad(nShapes > 0 ? nShapes : 1, colLengthTot);
+    WINDOW* header = newpad(1, colLengthTot);
+     
+    // add header content
+    wmove(header, 0, 0);
+    for (Int_t i = 0; i < 7; i++) 
+        WriteTableEntry(header, colHead[i], colLength[i], A_BOLD);
+
+    // add table content
+    for (Int_t i = 0; i < nShapes; i++)
+    {
+        TCQueryShape* s = (TCQueryShape*) shapes->At(i);
+
+        // move cursor
+        wmove(table, i, 0);
+
+        // calls
+        sprintf(tmp_str, "%lld", s->GetNCall());
+        WriteTableEntry(table, tmp_str, colLength[0]);
+
+        // total time
+        sprintf(tmp_str, "%.1f", 1000*s->GetTotalTime());
+        WriteTableEntry(table, tmp_str, colLength[1]);
+        
+        // mean time
+        sprintf(tmp_str, "%.3f", 1000*s->GetMeanTime());
+        WriteTableEntry(table, tmp_str, colLength[2]);
+        
+        // maximum time
+        sprintf(tmp_str, "%.3f", 1000*s->GetMaxTime());
+        WriteTableEntry(table, tmp_str, colLength[3]);
+        
+        // rows
+        sprintf(tmp_str, "%lld", s->GetNRow());
+        WriteTableEntry(table, tmp_str, colLength[4]);
+        
+        // slow calls
+        sprintf(tmp_str, "%lld", s->GetNSlow());
+        WriteTableEntry(table, tmp_str, colLength[5]);
+        
+        // query
+        strncpy(tmp_str, s->GetShape(), MAX_QUERY_STRING);
+        tmp_str[MAX_QUERY_STRING] = '\0';
+        WriteTableEntry(table, tmp_str, colLength[6]);
+    }
+    
+    *outHeader = header;
+
+    return table;
+}
+
 //______________________________________________________________________________
 void PrintStatusMessage(const Char_t* message)
 {
@@ -1954,12 +2069,13 @@ void Administration()
     // menu configuration
     const Char_t mTitle[] = "ADMINISTRATION";
     const Char_t mMsg[] = "Select an administration operation";
-    const Int_t mN = 6;
+    const Int_t mN = 7;
     const Char_t* mEntries[] = { "Export runs",
                                  "Export calibration",
                                  "Import runs",
                                  "Import calibration",
                                  "Clone calibration",
+                                 "Query statistics",
                                  "Go back" };
     
     // show menu
@@ -1973,8 +2089,128 @@ void Administration()
         case 2: ImportRuns();
         case 3: ImportCalibration();
         case 4: CloneCalibration();
-        case 5: MainMenu();
+        case 5: QueryStatistics();
+        case 6: MainMenu();
+    }
+}
+
+//______________________________________________________________________________
+void QueryStatistics()
+{
+    // Show the execution statistics of the database queries.
+    
+    // get the query shapes sorted by their total execution time
+    TList* shapes = TCMySQLManager::GetManager()->GetQueryStats()->GetShapes();
+    
+    // get number of query shapes
+    Int_t nShapes = shapes->GetSize();
+
+    // clear the screen
+    clear();
+
+    // draw header
+    DrawHeader();
+    
+    // draw title
+    attron(A_UNDERLINE);
+    mvprintw(4, 2, "QUERY STATISTICS");
+    attroff(A_UNDERLINE);
+    
+    // build the windows
+    Int_t colLengthTot;
+    WINDOW* header = 0;
+    WINDOW* table = FormatQueryTable(shapes, &colLengthTot, &header);
+
+    // user information
+    Char_t tmp[256];
+    sprintf(tmp, "%d query shapes found. Use UP/DOWN keys to scroll "
+                 "(PAGE-UP or 'p' / PAGE-DOWN or 'n' for fast mode) - hit 'c' to clear "
+                 "- hit ESC or 'q' to exit", nShapes);
+    PrintStatusMessage(tmp);
+ 
+    // refresh windows
+    refresh();
+    prefresh(header, 0, 0, 6, 2, 7, gNcol-3);
+    prefresh(table, 0, 0, 7, 2, gNrow-3, gNcol-3);
+   
+    Int_t first_row = 0;
+    Int_t first_col = 0;
+    Int_t winHeight = gNrow-3-7;
+    Int_t winWidth = gNcol;
+    Bool_t clearStats = kFALSE;
+
+    // wait for input
+    for (;;)
+    {
+        // get key
+        Int_t c = getch();
+        
+        //
+        // decide what to do
+        //
+        
+        // go up one entry
+        if (c == KEY_UP)
+        {
+            if (first_row > 0) first_row--;
+        }
+        // go down one entry
+        else if (c == KEY_DOWN)
+        {
+            if (first_row < nShapes-winHeight-1) first_row++;
+        }
+        // go up one page
+        else if (c == KEY_PPAGE || c == 'p')
+        {
+            if (first_row > winHeight-1) first_row -= winHeight+1;
+            else first_row = 0;
+        }
+        // go down one page
+        else if (c == KEY_NPAGE || c == 'n')
+        {
+            if (first_row < nShapes-winHeight-winHeight) first_row += winHeight+1;
+            else first_row = nShapes-winHeight-1;
+        }
+        // go right
+        else if (c == KEY_RIGHT)
+        {
+            if (first_col < colLengthTot-winWidth) first_col += 10;
+            else first_col = colLengthTot-winWidth;
+        }
+        // go left
+        else if (c == KEY_LEFT)
+        {
+            if (first_col > 0) first_col -= 10;
+            else continue;
+        }
+        // clear the statistics
+        else if (c == 'c')
+        {
+            clearStats = kTRUE;
+            break;
+        }
+        // exit
+        else if (c == KEY_ESC || c == 'q') break;
+
+        // update window
+        prefresh(header, 0, first_col, 6, 2, 7, gNcol-3);
+        prefresh(table, first_row, first_col, 7, 2, gNrow-3, gNcol-3);
     }
+    
+    // clean-up
+    delwin(table);
+    delwin(header);
+    delete shapes;
+
+    // clear the statistics and show them again
+    if (clearStats)
+    {
+        TCMySQLManager::GetManager()->GetQueryStats()->Clear();
+        QueryStatistics();
+    }
+
+    // go back to the administration menu
+    Administration();
 }
 
 //______________________________________________________________________________
@@ -278,9 +278,10 @@ void TCCalib::Write()
 {
     // Write the obtained calibration values to the database.
     
-    // write values to database
-    for (Int_t i = 0; i < fNset; i++)
-        TCMySQLManager::GetManager()->WriteParameters(fData.Data(), fCalibration.Data(), fSet[i], fNewVal, fNelem);
+    // write values of all sets to database
+    const Char_t* data[1] = { fData.Data() };
+    Double_t* par[1] = { fNewVal };
+    TCMySQLManager::GetManager()->WriteParametersSets(fCalibration.Data(), 1, data, fNset, fSet, par, fNelem);
         
     // save overview picture
     SaveCanvas(fCanvasResult, "Overview");
@@ -76,6 +76,9 @@ void TCCalibCBTimeWalk::Init()
         return;
     }
     else fHistoName = *TCReadConfig::GetReader()->GetConfig("CB.TimeWalk.Histo.Fit.Name");
+
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, TString::Format("%s_%%03d", fHistoName.Data()).Data());
     
     // get projection fit display delay
     fDelay = TCReadConfig::GetReader()->GetConfigInt("CB.TimeWalk.Fit.Delay");
@@ -105,14 +108,11 @@ void TCCalibCBTimeWalk::Fit(Int_t elem)
     Double_t lowLimit, highLimit;
     TCReadConfig::GetReader()->GetConfigDoubleDouble("CB.TimeWalk.Histo.Fit.Xaxis.Range", &lowLimit, &highLimit);
      
-    // create histogram name
-    sprintf(tmp, "%s_%03d", fHistoName.Data(), elem);
-   
     // delete old histogram
     if (fMainHisto) delete fMainHisto;
   
     // get histogram
-    fMainHisto = fFileManager->GetHistogram(tmp);
+    fMainHisto = fFileManager->GetElementHistogram(elem);
     if (!fMainHisto)
     {
         Error("Init", "Main histogram does not exist!\n");
@@ -343,13 +343,10 @@ void TCCalibCBTimeWalk::Write()
 {
     // Write the obtained calibration values to the database.
     
-    // write values to database
-    for (Int_t i = 0; i < fNset; i++)
-    {
-        TCMySQLManager::GetManager()->WriteParameters("Data.CB.Walk.Par0", fCalibration.Data(), fSet[i], fPar0, fNelem);
-        TCMySQLManager::GetManager()->WriteParameters("Data.CB.Walk.Par1", fCalibration.Data(), fSet[i], fPar1, fNelem);
-        TCMySQLManager::GetManager()->WriteParameters("Data.CB.Walk.Par2", fCalibration.Data(), fSet[i], fPar2, fNelem);
-        TCMySQLManager::GetManager()->WriteParameters("Data.CB.Walk.Par3", fCalibration.Data(), fSet[i], fPar3, fNelem);
-    }
+    // write values of all sets to database
+    const Char_t* data[4] = { "Data.CB.Walk.Par0", "Data.CB.Walk.Par1", 
+                              "Data.CB.Walk.Par2", "Data.CB.Walk.Par3" };
+    Double_t* par[4] = { fPar0, fPar1, fPar2, fPar3 };
+    TCMySQLManager::GetManager()->WriteParametersSets(fCalibration.Data(), 4, data, fNset, fSet, par, fNelem);
 }
 
@@ -133,6 +133,9 @@ void TCCalibDiscrThr::Init()
     
     // sum up all files contained in this runset
     fFileManager = new TCFileManager(fData, fCalibration.Data(), fNset, fSet);
+    
+    // register the element histograms
+    if (fADC) fFileManager->SetElementHistograms(fNelem, "ADC%d", fADC);
   
     // get the main calibration histogram
     if (!fADC)
@@ -188,8 +191,7 @@ void TCCalibDiscrThr::Fit(Int_t elem)
     if (fADC)
     {
         if (fFitHisto) delete fFitHisto;
-        sprintf(tmp, "ADC%d", fADC[elem]);
-        fFitHisto = fFileManager->GetHistogram(tmp);
+        fFitHisto = fFileManager->GetElementHistogram(elem);
     }
     else
     {
@@ -202,6 +204,7 @@ void TCCalibDiscrThr::Fit(Int_t elem)
     // create projection of the normalization histogram
     if (fMainHisto2)
     {
+        sprintf(tmp, "ProjHistoNorm_%i", elem);
         TH1* hNorm = (TH1D*) fMainHisto2->ProjectionX(tmp, elem+1, elem+1, "e");
         fFitHisto->Divide(hNorm);
         delete hNorm;
@@ -97,6 +97,14 @@ void TCCalibPIDDroop::Init()
         return;
     }
     else fHistoName = *TCReadConfig::GetReader()->GetConfig("PID.Droop.Histo.Fit.Name");
+
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, TString::Format("%s_%%03d", fHistoName.Data()).Data());
+
+    // only the energy range of the fits is needed
+    Double_t lowEnergy, highEnergy;
+    TCReadConfig::GetReader()->GetConfigDoubleDouble("PID.Droop.Fit.Energy.Range", &lowEnergy, &highEnergy);
+    fFileManager->SetElementProjection("xyz", 'x', lowEnergy, highEnergy);
     
     // get projection fit display delay
     fDelay = TCReadConfig::GetReader()->GetConfigInt("PID.Droop.Fit.Delay");
@@ -302,14 +310,11 @@ void TCCalibPIDDroop::Fit(Int_t elem)
     
     Char_t tmp[256];
     
-    // create histogram name
-    sprintf(tmp, "%s_%03d", fHistoName.Data(), elem);
-   
     // delete old histogram
     if (fMainHisto) delete fMainHisto;
   
     // get histogram
-    fMainHisto = fFileManager->GetHistogram(tmp);
+    fMainHisto = fFileManager->GetElementHistogram(elem);
     if (!fMainHisto)
     {
         Error("Init", "Main histogram does not exist!\n");
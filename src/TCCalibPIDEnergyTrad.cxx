@@ -87,6 +87,10 @@ void TCCalibPIDEnergyTrad::Init()
         return;
     }
     else fHistoName = *TCReadConfig::GetReader()->GetConfig("PID.Energy.Trad.Histo.Fit.Name");
+
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, TString::Format("%s_%%03d", fHistoName.Data()).Data());
+    fFileManager->SetElementProjection("yx");
     
     // get MC histogram file
     TString fileMC;
@@ -268,23 +272,16 @@ void TCCalibPIDEnergyTrad::Fit(Int_t elem)
     
     Char_t tmp[256];
     
-    // create histogram name
-    sprintf(tmp, "%s_%03d", fHistoName.Data(), elem);
-   
-    // get histogram
-    TH3* h3 = (TH3*) fFileManager->GetHistogram(tmp);
-    if (!h3)
+    // get 2D projection (summed-up directly)
+    if (fMainHisto) delete fMainHisto;
+    fMainHisto = fFileManager->GetElementHistogram(elem);
+    if (!fMainHisto)
     {
         Error("Init", "Main histogram does not exist!\n");
         return;
     }
-    
-    // create 2D projection
-    if (fMainHisto) delete fMainHisto;
     sprintf(tmp, "%02d_yxe", elem);
-    fMainHisto = (TH2D*) h3->Project3D(tmp);
     fMainHisto->SetTitle(tmp);
-    delete h3;
  
     // draw main histogram
     fCanvasFit->cd(1);
@@ -369,12 +366,10 @@ void TCCalibPIDEnergyTrad::Write()
 {
     // Write the obtained calibration values to the database.
     
-    // write values to database
-    for (Int_t i = 0; i < fNset; i++)
-    {
-        TCMySQLManager::GetManager()->WriteParameters("Data.PID.E0", fCalibration.Data(), fSet[i], fPed, fNelem);
-        TCMySQLManager::GetManager()->WriteParameters("Data.PID.E1", fCalibration.Data(), fSet[i], fGain, fNelem);
-    }
+    // write values of all sets to database
+    const Char_t* data[2] = { "Data.PID.E0", "Data.PID.E1" };
+    Double_t* par[2] = { fPed, fGain };
+    TCMySQLManager::GetManager()->WriteParametersSets(fCalibration.Data(), 2, data, fNset, fSet, par, fNelem);
     
     // save overview canvas
     SaveCanvas(fCanvasResult, "Overview");
@@ -61,6 +61,9 @@ void TCCalibPed::Init()
     // read ADC numbers
     ReadADC();
 
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, "ADC%d", fADC);
+
     // read old parameters (only from first set)
     TCMySQLManager::GetManager()->ReadParameters(fData, fCalibration.Data(), fSet[0], fOldVal, fNelem);
     
@@ -91,8 +94,7 @@ void TCCalibPed::Fit(Int_t elem)
     
     // load the pedestal histogram
     if (fFitHisto) delete fFitHisto;
-    sprintf(tmp, "ADC%d", fADC[elem]);
-    fFitHisto = fFileManager->GetHistogram(tmp);
+    fFitHisto = fFileManager->GetElementHistogram(elem);
     
     // dummy position
     fMean = 100;
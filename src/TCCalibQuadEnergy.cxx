@@ -437,19 +437,17 @@ void TCCalibQuadEnergy::Write()
 {
     // Write the obtained calibration values to the database.
     
-    // write values to database
-    for (Int_t i = 0; i < fNset; i++)
+    // write values of all sets to database
+    Double_t* par[2] = { fPar0, fPar1 };
+    if (this->InheritsFrom("TCCalibCBQuadEnergy"))
     {
-        if (this->InheritsFrom("TCCalibCBQuadEnergy"))
-        {
-            TCMySQLManager::GetManager()->WriteParameters("Data.CB.Energy.Quad.Par0", fCalibration.Data(), fSet[i], fPar0, fNelem);
-            TCMySQLManager::GetManager()->WriteParameters("Data.CB.Energy.Quad.Par1", fCalibration.Data(), fSet[i], fPar1, fNelem);
-        }
-        else if (this->InheritsFrom("TCCalibTAPSQuadEnergy"))
-        {
-            TCMySQLManager::GetManager()->WriteParameters("Data.TAPS.Energy.Quad.Par0", fCalibration.Data(), fSet[i], fPar0, fNelem);
-            TCMySQLManager::GetManager()->WriteParameters("Data.TAPS.Energy.Quad.Par1", fCalibration.Data(), fSet[i], fPar1, fNelem);
-        }
+        const Char_t* data[2] = { "Data.CB.Energy.Quad.Par0", "Data.CB.Energy.Quad.Par1" };
+        TCMySQLManager::GetManager()->WriteParametersSets(fCalibration.Data(), 2, data, fNset, fSet, par, fNelem);
+    }
+    else if (this->InheritsFrom("TCCalibTAPSQuadEnergy"))
+    {
+        const Char_t* data[2] = { "Data.TAPS.Energy.Quad.Par0", "Data.TAPS.Energy.Quad.Par1" };
+        TCMySQLManager::GetManager()->WriteParametersSets(fCalibration.Data(), 2, data, fNset, fSet, par, fNelem);
     }
 
     // save overview canvas
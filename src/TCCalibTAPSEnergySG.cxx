@@ -92,6 +92,9 @@ void TCCalibTAPSEnergySG::Init()
         return;
     }
     else fHistoName = *TCReadConfig::GetReader()->GetConfig("TAPS.Energy.SG.Histo.Fit.Name");
+
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, TString::Format("%s_%%03d", fHistoName.Data()).Data());
     
     // read old parameters (only from first set)
     TCMySQLManager::GetManager()->ReadParameters("Data.TAPS.SG.E0", fCalibration.Data(), fSet[0], fPedOld, fNelem);
@@ -145,14 +148,11 @@ void TCCalibTAPSEnergySG::Fit(Int_t elem)
     fRadius1 = 0.5 * (highLimit1 + lowLimit1);
     fRadius2 = 0.5 * (highLimit2 + lowLimit2);
 
-    // create histogram name
-    sprintf(tmp, "%s_%03d", fHistoName.Data(), elem);
-   
     // delete old histogram
     if (fMainHisto) delete fMainHisto;
   
     // get histogram
-    fMainHisto = fFileManager->GetHistogram(tmp);
+    fMainHisto = fFileManager->GetElementHistogram(elem);
     if (!fMainHisto)
     {
         Error("Init", "Main histogram does not exist!\n");
@@ -398,12 +398,10 @@ void TCCalibTAPSEnergySG::Write()
 {
     // Write the obtained calibration values to the database.
     
-    // write values to database
-    for (Int_t i = 0; i < fNset; i++)
-    {
-        TCMySQLManager::GetManager()->WriteParameters("Data.TAPS.SG.E0", fCalibration.Data(), fSet[i], fPedNew, fNelem);
-        TCMySQLManager::GetManager()->WriteParameters("Data.TAPS.SG.E1", fCalibration.Data(), fSet[i], fGainNew, fNelem);
-    }
+    // write values of all sets to database
+    const Char_t* data[2] = { "Data.TAPS.SG.E0", "Data.TAPS.SG.E1" };
+    Double_t* par[2] = { fPedNew, fGainNew };
+    TCMySQLManager::GetManager()->WriteParametersSets(fCalibration.Data(), 2, data, fNset, fSet, par, fNelem);
    
     // save overview canvas
     SaveCanvas(fCanvasResult, "Overview");
@@ -94,6 +94,9 @@ void TCCalibTAPSPSA::Init()
         return;
     }
     else fHistoName = *TCReadConfig::GetReader()->GetConfig("TAPS.PSA.Histo.Fit.Name");
+
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, TString::Format("%s_%%03d", fHistoName.Data()).Data());
     
     // get projection fit display delay
     fDelay = TCReadConfig::GetReader()->GetConfigInt("TAPS.PSA.Fit.Delay");
@@ -114,14 +117,11 @@ void TCCalibTAPSPSA::Fit(Int_t elem)
     TCReadConfig::GetReader()->GetConfigDoubleDouble("TAPS.PSA.Histo.Fit.Xaxis.Range", &lowLimitX, &highLimitX);
     TCReadConfig::GetReader()->GetConfigDoubleDouble("TAPS.PSA.Histo.Fit.Yaxis.Range", &lowLimitY, &highLimitY);
   
-    // create histogram name
-    sprintf(tmp, "%s_%03d", fHistoName.Data(), elem);
-   
     // delete old histogram
     if (fMainHisto) delete fMainHisto;
   
     // get histogram
-    fMainHisto = fFileManager->GetHistogram(tmp);
+    fMainHisto = fFileManager->GetElementHistogram(elem);
     if (!fMainHisto)
     {
         Error("Init", "Main histogram does not exist!\n");
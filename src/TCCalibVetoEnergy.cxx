@@ -67,6 +67,9 @@ void TCCalibVetoEnergy::Init()
         return;
     }
     else fHistoName = *TCReadConfig::GetReader()->GetConfig("Veto.Energy.Histo.Fit.Name");
+
+    // register the element histograms
+    fFileManager->SetElementHistograms(fNelem, TString::Format("%s_%%03d", fHistoName.Data()).Data());
     
     // get MC histogram file
     TString fileMC;
@@ -220,16 +223,11 @@ void TCCalibVetoEnergy::Fit(Int_t elem)
 {
     // Perform the fit of the element 'elem'.
     
-    Char_t tmp[256];
-    
-    // create histogram name
-    sprintf(tmp, "%s_%03d", fHistoName.Data(), elem);
-   
     // delete old histogram
     if (fMainHisto) delete fMainHisto;
 
     // get histogram
-    fMainHisto = (TH2*) fFileManager->GetHistogram(tmp);
+    fMainHisto = (TH2*) fFileManager->GetElementHistogram(elem);
     if (!fMainHisto)
     {
         Error("Init", "Main histogram does not exist!\n");
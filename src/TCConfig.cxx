@@ -59,6 +59,26 @@ namespace TCConfig
     // additional settings for the data tables
     const Char_t* kCalibDataTableSettings = ",PRIMARY KEY (calibration, first_run) ";
     
+    // name of the table of the parent calibrations of overlay calibrations
+    const Char_t* kCalibParentTableName = "calib_parent";
+
+    // format of the table of the parent calibrations
+    const Char_t* kCalibParentTableFormat = 
+                    "calibration VARCHAR(256) NOT NULL,"
+                    "parent VARCHAR(256) NOT NULL,"
+                    "changed TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP"
+                    "                  ON UPDATE CURRENT_TIMESTAMP,"
+                    "PRIMARY KEY (calibration) ";
+
+    // maximum length of the parent chain of overlay calibrations
+    const Int_t kMaxOverlayDepth = 32;
+
+    // number of rows read per query when dumping tables
+    const Int_t kDumpChunkSize = 1000;
+
+    // maximum length of a multi-row insert query
+    const Int_t kMaxInsertLength = 524288;
+    
     // version numbers
     const Char_t kCaLibVersion[] = "0.3.0beta";
     const Int_t kContainerFormatVersion = 4;
@@ -0,0 +1,327 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCDBBackend                                                          //
+//                                                                      //
+// Database backends (connection and SQL dialect).                      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TCDBBackend.h"
+
+ClassImp(TCDBRow)
+ClassImp(TCDBResult)
+ClassImp(TCDBBackend)
+ClassImp(TCDBBackendMySQL)
+ClassImp(TCDBBackendSQLite)
+
+
+//______________________________________________________________________________
+TCDBRow::TCDBRow(Int_t nField)
+    : TSQLRow()
+{
+    // Constructor of a row with 'nField' NULL fields.
+
+    fNField = nField;
+    fField = new TString[fNField];
+    fNull = new Bool_t[fNField];
+    for (Int_t i = 0; i < fNField; i++) fNull[i] = kTRUE;
+}
+
+//______________________________________________________________________________
+TCDBRow::~TCDBRow()
+{
+    // Destructor.
+
+    if (fField) delete [] fField;
+    if (fNull) delete [] fNull;
+}
+
+//______________________________________________________________________________
+void TCDBRow::SetField(Int_t i, const Char_t* value)
+{
+    // Set the value of the field 'i' to 'value' (0: NULL).
+
+    fField[i] = value ? value : "";
+    fNull[i] = value ? kFALSE : kTRUE;
+}
+
+//______________________________________________________________________________
+ULong_t TCDBRow::GetFieldLength(Int_t i)
+{
+    // Return the length of the field 'i'.
+
+    if (i < 0 || i >= fNField || fNull[i]) return 0;
+    else return fField[i].Length();
+}
+
+//______________________________________________________________________________
+const char* TCDBRow::GetField(Int_t i)
+{
+    // Return the value of the field 'i' or 0 if the field is NULL.
+
+    if (i < 0 || i >= fNField || fNull[i]) return 0;
+    else return fField[i].Data();
+}
+
+//______________________________________________________________________________
+TCDBResult::TCDBResult(Int_t nField)
+    : TSQLResult()
+{
+    // Constructor of an empty result with 'nField' fields per row.
+
+    fNField = nField;
+    fFieldName = new TString[fNField > 0 ? fNField : 1];
+    fRows = new TObjArray();
+    fRows->SetOwner(kTRUE);
+    fNext = 0;
+    fRowCount = 0;
+}
+
+//______________________________________________________________________________
+TCDBResult::~TCDBResult()
+{
+    // Destructor.
+
+    if (fFieldName) delete [] fFieldName;
+    if (fRows) delete fRows;
+}
+
+//______________________________________________________________________________
+void TCDBResult::AddRow(TCDBRow* row)
+{
+    // Add the row 'row' to the result. The result takes ownership of it.
+
+    fRows->Add(row);
+    fRowCount = fRows->GetEntriesFast();
+}
+
+//______________________________________________________________________________
+TSQLRow* TCDBResult::Next()
+{
+    // Return the next row or 0 if all rows were read.
+    // NOTE: the returned row must be destroyed by the caller.
+
+    if (fNext >= fRows->GetEntriesFast()) return 0;
+    return (TSQLRow*) fRows->RemoveAt(fNext++);
+}
+
+//______________________________________________________________________________
+TSQLServer* TCDBBackend::Connect() const
+{
+    // Open and return a new connection to the database.
+    // Return 0 if an error occurred.
+    // NOTE: the connection must be destroyed by the caller.
+
+    TSQLServer* db = TSQLServer::Connect(fURL.Data(), fUser.Data(), fPass.Data());
+    if (db && db->IsZombie())
+    {
+        delete db;
+        return 0;
+    }
+
+    return db;
+}
+
+//______________________________________________________________________________
+TSQLResult* TCDBBackend::Query(TSQLServer* db, const Char_t* query) const
+{
+    // Send the query 'query' to the database connection 'db' and return the
+    // result.
+    // NOTE: the result must be destroyed by the caller.
+
+    return db->Query(query);
+}
+
+//______________________________________________________________________________
+TString TCDBBackend::Quote(const Char_t* s) const
+{
+    // Return the string 's' as quoted SQL string literal or NULL if 's' is 0.
+
+    if (!s) return TString("NULL");
+
+    TString q(s);
+    q.ReplaceAll("'", "''");
+
+    return TString::Format("'%s'", q.Data());
+}
+
+//______________________________________________________________________________
+TCDBBackend* TCDBBackend::Create(const Char_t* type, const Char_t* host, const Char_t* name,
+                                 const Char_t* user, const Char_t* pass)
+{
+    // Create the database backend of the type 'type' ("mysql" or "sqlite")
+    // for the database 'name' on the host 'host' accessed by the user 'user'
+    // with the password 'pass'. The SQLite backend uses only 'name' as the
+    // database file name.
+    // Return 0 if the backend type is unknown.
+    // NOTE: the backend must be destroyed by the caller.
+
+    if (!strcmp(type, "mysql"))
+        return new TCDBBackendMySQL(host ? host : "", name, user ? user : "", pass ? pass : "");
+    else if (!strcmp(type, "sqlite"))
+        return new TCDBBackendSQLite(name);
+    else
+    {
+        ::Error("TCDBBackend::Create", "Unknown database backend '%s'!", type);
+        return 0;
+    }
+}
+
+//______________________________________________________________________________
+TCDBBackendMySQL::TCDBBackendMySQL(const Char_t* host, const Char_t* name,
+                                   const Char_t* user, const Char_t* pass)
+    : TCDBBackend(TString::Format("mysql://%s/%s", host, name).Data(), user, pass)
+{
+    // Constructor of the backend for the MySQL database 'name' on the host
+    // 'host' accessed by the user 'user' with the password 'pass'.
+
+}
+
+//______________________________________________________________________________
+TString TCDBBackendMySQL::GetColumnsQuery(const Char_t* table) const
+{
+    // Return the query listing the columns of the table 'table'.
+
+    return TString::Format("SHOW COLUMNS FROM %s", table);
+}
+
+//______________________________________________________________________________
+TString TCDBBackendMySQL::GetTableQuery(const Char_t* table) const
+{
+    // Return the query returning one row if the table 'table' exists.
+
+    return TString::Format("SHOW TABLES LIKE '%s'", table);
+}
+
+//______________________________________________________________________________
+TString TCDBBackendMySQL::Quote(const Char_t* s) const
+{
+    // Return the string 's' as quoted SQL string literal or NULL if 's' is 0.
+    // Backslashes are escape characters in MySQL string literals.
+
+    if (!s) return TString("NULL");
+
+    TString q(s);
+    q.ReplaceAll("\\", "\\\\");
+    q.ReplaceAll("'", "''");
+
+    return TString::Format("'%s'", q.Data());
+}
+
+//______________________________________________________________________________
+TCDBBackendSQLite::TCDBBackendSQLite(const Char_t* filename)
+    : TCDBBackend(TString::Format("sqlite://%s", filename).Data(), "", "")
+{
+    // Constructor of the backend for the SQLite database file 'filename'.
+
+}
+
+//______________________________________________________________________________
+TSQLServer* TCDBBackendSQLite::Connect() const
+{
+    // Open and return a new connection to the database file. Connections
+    // wait for locks held by other connections to the same file.
+    // Return 0 if an error occurred.
+    // NOTE: the connection must be destroyed by the caller.
+
+    TSQLServer* db = TCDBBackend::Connect();
+    if (db) db->Exec("PRAGMA busy_timeout = 60000");
+
+    return db;
+}
+
+//______________________________________________________________________________
+TSQLResult* TCDBBackendSQLite::Query(TSQLServer* db, const Char_t* query) const
+{
+    // Execute the query 'query' on the database connection 'db' and return
+    // the buffered result. Unlike the results of the ROOT SQLite driver, the
+    // query is executed immediately and the number of rows is known.
+    // Return 0 if an error occurred.
+    // NOTE: the result must be destroyed by the caller.
+
+    // prepare the query
+    TSQLStatement* stmt = db->Statement(query);
+    if (!stmt) return 0;
+
+    // execute the query
+    if (!stmt->Process())
+    {
+        delete stmt;
+        return 0;
+    }
+
+    // check if rows are returned
+    TString q(query);
+    q = q.Strip(TString::kLeading);
+    Bool_t select = q.BeginsWith("SELECT", TString::kIgnoreCase) ||
+                    q.BeginsWith("PRAGMA", TString::kIgnoreCase);
+
+    // buffer the rows
+    TCDBResult* res = 0;
+    if (select && stmt->StoreResult())
+    {
+        Int_t nField = stmt->GetNumFields();
+        res = new TCDBResult(nField);
+        for (Int_t i = 0; i < nField; i++) res->SetFieldName(i, stmt->GetFieldName(i));
+        while (stmt->NextResultRow())
+        {
+            TCDBRow* row = new TCDBRow(nField);
+            for (Int_t i = 0; i < nField; i++)
+                if (!stmt->IsNull(i)) row->SetField(i, stmt->GetString(i));
+            res->AddRow(row);
+        }
+    }
+    else res = new TCDBResult(0);
+
+    // clean-up
+    delete stmt;
+
+    return res;
+}
+
+//______________________________________________________________________________
+TString TCDBBackendSQLite::GetTableFormat(const Char_t* format) const
+{
+    // Return the table format 'format' written in the MySQL dialect converted
+    // to SQLite. The automatic update of timestamp columns is provided by
+    // the trigger of the table (see GetTableTrigger()).
+
+    TString f(format);
+    f.ReplaceAll("ON UPDATE CURRENT_TIMESTAMP", "");
+
+    return f;
+}
+
+//______________________________________________________________________________
+TString TCDBBackendSQLite::GetTableTrigger(const Char_t* table) const
+{
+    // Return the query creating the trigger of the table 'table' updating
+    // its 'changed' column when a row is modified.
+
+    return TString::Format("CREATE TRIGGER IF NOT EXISTS %s_changed AFTER UPDATE ON %s "
+                           "FOR EACH ROW WHEN NEW.changed = OLD.changed "
+                           "BEGIN UPDATE %s SET changed = CURRENT_TIMESTAMP WHERE rowid = NEW.rowid; END",
+                           table, table, table);
+}
+
+//______________________________________________________________________________
+TString TCDBBackendSQLite::GetColumnsQuery(const Char_t* table) const
+{
+    // Return the query listing the columns of the table 'table'.
+
+    return TString::Format("PRAGMA table_info(%s)", table);
+}
+
+//______________________________________________________________________________
+TString TCDBBackendSQLite::GetTableQuery(const Char_t* table) const
+{
+    // Return the query returning one row if the table 'table' exists.
+
+    return TString::Format("SELECT name FROM sqlite_master WHERE type = 'table' AND name = '%s'", table);
+}
+
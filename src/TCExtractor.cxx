@@ -0,0 +1,531 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCExtractor                                                          //
+//                                                                      //
+// Extract the CaLib histograms of input files into slim files.         //
+//                                                                      //
+// Only the histograms named in the CaLib configuration are copied.     //
+// The 1D and 2D histograms of an element histogram family (e.g.        //
+// CaLib_CB_Walk_E_T_%03d) are packed into one 2D or 3D histogram,      //
+// where only the present elements are stored, one per bin of the last  //
+// axis. Every packed family is described by a TNamed                   //
+// 'Family_<packed name>' containing the name pattern, the projection,  //
+// the element axis and the map of the packed element indices (see     //
+// GetPackedBin()) needed to unpack the elements. The packed histograms //
+// of files having a different element map are not summed up (see       //
+// TCFileManager::CheckFamily()).                                       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TCExtractor.h"
+
+ClassImp(TCExtractor)
+
+
+// argument of the extraction worker threads
+struct TCExtractorTask
+{
+    TCExtractor* fExtractor;                // extractor
+    const Int_t* fRun;                      // runs
+    Int_t fFirst;                           // index of first run
+    Int_t fLast;                            // index of last run (exclusive)
+    Int_t fNDone;                           // number of extracted runs
+};
+
+
+//______________________________________________________________________________
+TCExtractor::TCExtractor(const Char_t* inputPatt, const Char_t* outputPatt)
+{
+    // Constructor using the input file pattern 'inputPatt' and the output
+    // file pattern 'outputPatt'. The patterns of the configuration are used
+    // if they are 0. The histograms named in the configuration are
+    // registered for extraction.
+
+    // init members
+    fInputFilePatt = "";
+    fOutputFilePatt = "";
+    fNThreads = 1;
+    fNames = new TObjArray();
+    fNames->SetOwner(kTRUE);
+    fFamilies = new TObjArray();
+    fFamilies->SetOwner(kTRUE);
+
+    // read input file pattern
+    if (inputPatt) fInputFilePatt = inputPatt;
+    else if (TString* f = TCReadConfig::GetReader()->GetConfig("File.Input.Rootfiles"))
+        fInputFilePatt = *f;
+
+    // read output file pattern
+    if (outputPatt) fOutputFilePatt = outputPatt;
+    else if (TString* f = TCReadConfig::GetReader()->GetConfig("File.Input.Slim"))
+        fOutputFilePatt = *f;
+
+    // check file patterns
+    if (!fInputFilePatt.Contains("RUN") || !fOutputFilePatt.Contains("RUN"))
+        Error("TCExtractor", "Error in file pattern configuration!");
+
+    // read number of extraction threads
+    if (TCReadConfig::GetReader()->GetConfig("File.Input.Threads"))
+        SetNThreads(TCReadConfig::GetReader()->GetConfigInt("File.Input.Threads"));
+
+    // register the configured histograms
+    AddConfigHistograms();
+}
+
+//______________________________________________________________________________
+TCExtractor::~TCExtractor()
+{
+    // Destructor.
+
+    if (fNames) delete fNames;
+    if (fFamilies) delete fFamilies;
+}
+
+//______________________________________________________________________________
+void TCExtractor::AddHistogram(const Char_t* name)
+{
+    // Register the histogram 'name' and the element histogram family
+    // 'name'_%03d for extraction.
+
+    if (fNames->FindObject(name)) return;
+    fNames->Add(new TObjString(name));
+    AddFamily(TString::Format("%s_%%03d", name).Data());
+}
+
+//______________________________________________________________________________
+void TCExtractor::AddFamily(const Char_t* pattern)
+{
+    // Register the element histogram family with the name pattern 'pattern'
+    // for extraction, e.g. pattern = "ADC%d".
+
+    if (fFamilies->FindObject(pattern)) return;
+    fFamilies->Add(new TObjString(pattern));
+}
+
+//______________________________________________________________________________
+void TCExtractor::AddConfigHistograms()
+{
+    // Register all histograms named in the configuration (keys of the form
+    // *.Histo.*.Name) and the element histogram families configured in
+    // File.Extract.Families for extraction.
+
+    // loop over configuration elements
+    TIter next(TCReadConfig::GetReader()->GetConfigTable());
+    TCConfigElement* elem;
+    while ((elem = (TCConfigElement*) next()))
+    {
+        if (elem->GetKey()->Contains(".Histo.") && elem->GetKey()->EndsWith(".Name"))
+            AddHistogram(elem->GetValue()->Data());
+    }
+
+    // add the configured families
+    if (TString* fam = TCReadConfig::GetReader()->GetConfig("File.Extract.Families"))
+    {
+        TObjArray* tok = fam->Tokenize(" ");
+        for (Int_t i = 0; i < tok->GetEntriesFast(); i++)
+            AddFamily(((TObjString*) tok->At(i))->GetString().Data());
+        delete tok;
+    }
+}
+
+//______________________________________________________________________________
+TString TCExtractor::GetPackedName(const Char_t* pattern)
+{
+    // Return the name of the packed histogram of the element histogram
+    // family with the name pattern 'pattern', i.e. the pattern with the
+    // integer conversion replaced by 'Packed'.
+
+    TString name(pattern);
+    Ssiz_t p = name.First('%');
+    Ssiz_t d = name.Index("d", p);
+    if (p != kNPOS && d != kNPOS) name.Replace(p, d-p+1, "Packed");
+
+    return name;
+}
+
+//______________________________________________________________________________
+Int_t TCExtractor::GetPackedBin(const Char_t* map, Int_t index)
+{
+    // Return the bin of the element with index 'index' on the element axis
+    // of a packed histogram having the element map 'map' or 0 if the 
+    // element is not packed. The map is a comma-separated list of the 
+    // packed element indices and index ranges 'first-last' in the order of
+    // their bins, e.g. '0-719,800'. Element i is in bin i+1 if the map is
+    // empty (slim files without element map).
+
+    // no element map
+    if (!map || !map[0]) return index >= 0 ? index+1 : 0;
+
+    // loop over the ranges
+    Int_t bin = 1;
+    const Char_t* p = map;
+    while (*p)
+    {
+        // read the range
+        Char_t* end;
+        Int_t first = strtol(p, &end, 10);
+        Int_t last = first;
+        if (*end == '-') last = strtol(end+1, &end, 10);
+
+        // check the index
+        if (index >= first && index <= last) return bin + index - first;
+        bin += last - first + 1;
+
+        // go to the next range
+        if (*end != ',') break;
+        p = end + 1;
+    }
+
+    return 0;
+}
+
+//______________________________________________________________________________
+Bool_t TCExtractor::MatchPattern(const Char_t* pattern, const Char_t* name, Int_t* outIndex)
+{
+    // Check if the histogram name 'name' belongs to the element histogram
+    // family with the name pattern 'pattern' and save the element index to
+    // 'outIndex'.
+
+    // get the integer conversion
+    const Char_t* pc = strchr(pattern, '%');
+    if (!pc) return kFALSE;
+    const Char_t* pd = strchr(pc, 'd');
+    if (!pd) return kFALSE;
+
+    // check prefix and suffix
+    Int_t lPre = pc - pattern;
+    Int_t lSuf = strlen(pd+1);
+    Int_t lName = strlen(name);
+    if (lName <= lPre + lSuf) return kFALSE;
+    if (strncmp(name, pattern, lPre) || strcmp(name + lName - lSuf, pd+1)) return kFALSE;
+
+    // check the index
+    for (Int_t i = lPre; i < lName - lSuf; i++) if (!isdigit(name[i])) return kFALSE;
+    Int_t index = atoi(name + lPre);
+    if (TString::Format(pattern, index) != name) return kFALSE;
+
+    *outIndex = index;
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+TH1* TCExtractor::Pack(TObjArray* elem, const Char_t* pattern, TString* outMap)
+{
+    // Pack the 1D or 2D element histograms 'elem' (element i at index i) of
+    // the family with the name pattern 'pattern' into one 2D or 3D histogram.
+    // Only the present elements are packed, in the order of their index. The
+    // map of the packed element indices is saved to 'outMap' (see 
+    // GetPackedBin()).
+    // Return 0 if the histograms cannot be packed because of their dimension
+    // or different binnings.
+    // NOTE: the histogram has to be destroyed by the caller.
+
+    // collect the present elements and build the element map
+    Int_t nIndex = elem->GetLast() + 1;
+    Int_t* index = new Int_t[nIndex > 0 ? nIndex : 1];
+    Int_t nElem = 0;
+    *outMap = "";
+    for (Int_t i = 0; i < nIndex; i++)
+    {
+        if (!elem->At(i)) continue;
+        index[nElem++] = i;
+
+        // start a new range or extend the last one
+        if (nElem == 1 || index[nElem-2] != i-1)
+        {
+            if (nElem > 1) outMap->Append(',');
+            *outMap += i;
+        }
+        else if (i+1 >= nIndex || !elem->At(i+1)) outMap->Append(TString::Format("-%d", i));
+    }
+    if (!nElem)
+    {
+        delete [] index;
+        return 0;
+    }
+
+    // get the first element
+    TH1* h0 = (TH1*) elem->At(index[0]);
+    Int_t dim = h0->GetDimension();
+    if (dim > 2)
+    {
+        delete [] index;
+        return 0;
+    }
+
+    // check binning
+    Bool_t sumw2 = kFALSE;
+    for (Int_t i = 0; i < nElem; i++)
+    {
+        TH1* h = (TH1*) elem->At(index[i]);
+        if (h->GetDimension() != dim ||
+            h->GetNbinsX() != h0->GetNbinsX() || h->GetNbinsY() != h0->GetNbinsY() ||
+            h->GetXaxis()->GetXmin() != h0->GetXaxis()->GetXmin() ||
+            h->GetXaxis()->GetXmax() != h0->GetXaxis()->GetXmax() ||
+            h->GetYaxis()->GetXmin() != h0->GetYaxis()->GetXmin() ||
+            h->GetYaxis()->GetXmax() != h0->GetYaxis()->GetXmax())
+        {
+            delete [] index;
+            return 0;
+        }
+        if (h->GetSumw2N()) sumw2 = kTRUE;
+    }
+
+    // get the bin edges
+    Int_t nx = h0->GetNbinsX();
+    Int_t ny = h0->GetNbinsY();
+    Double_t* xEdge = new Double_t[nx+1];
+    Double_t* yEdge = new Double_t[ny+1];
+    Double_t* eEdge = new Double_t[nElem+1];
+    for (Int_t i = 0; i <= nx; i++) xEdge[i] = h0->GetXaxis()->GetBinLowEdge(i+1);
+    for (Int_t i = 0; i <= ny; i++) yEdge[i] = h0->GetYaxis()->GetBinLowEdge(i+1);
+    for (Int_t i = 0; i <= nElem; i++) eEdge[i] = i;
+
+    // create the packed histogram
+    TString name = GetPackedName(pattern);
+    Bool_t dbl = dynamic_cast<TArrayD*>(h0) ? kTRUE : kFALSE;
+    TH1* hOut;
+    if (dim == 1)
+    {
+        if (dbl) hOut = new TH2D(name.Data(), h0->GetTitle(), nx, xEdge, nElem, eEdge);
+        else hOut = new TH2F(name.Data(), h0->GetTitle(), nx, xEdge, nElem, eEdge);
+        hOut->GetYaxis()->SetTitle("Element");
+    }
+    else
+    {
+        if (dbl) hOut = new TH3D(name.Data(), h0->GetTitle(), nx, xEdge, ny, yEdge, nElem, eEdge);
+        else hOut = new TH3F(name.Data(), h0->GetTitle(), nx, xEdge, ny, yEdge, nElem, eEdge);
+        hOut->GetYaxis()->SetTitle(h0->GetYaxis()->GetTitle());
+        hOut->GetZaxis()->SetTitle("Element");
+    }
+    hOut->GetXaxis()->SetTitle(h0->GetXaxis()->GetTitle());
+    if (sumw2) hOut->Sumw2();
+    Double_t* w2 = sumw2 ? hOut->GetSumw2()->GetArray() : 0;
+
+    // copy the elements
+    Double_t entries = 0;
+    for (Int_t i = 0; i < nElem; i++)
+    {
+        TH1* h = (TH1*) elem->At(index[i]);
+
+        // loop over bins including under- and overflow
+        for (Int_t by = 0; by < (dim == 2 ? ny+2 : 1); by++)
+        {
+            for (Int_t bx = 0; bx < nx+2; bx++)
+            {
+                Int_t bin = h->GetBin(bx, by);
+                Int_t binOut = dim == 1 ? hOut->GetBin(bx, i+1) : hOut->GetBin(bx, by, i+1);
+                Double_t c = h->GetBinContent(bin);
+                hOut->SetBinContent(binOut, c);
+                if (w2) w2[binOut] = h->GetSumw2N() ? h->GetSumw2()->At(bin) : TMath::Abs(c);
+            }
+        }
+        entries += h->GetEntries();
+    }
+    hOut->SetEntries(entries);
+
+    // clean-up
+    delete [] index;
+    delete [] xEdge;
+    delete [] yEdge;
+    delete [] eEdge;
+
+    return hOut;
+}
+
+//______________________________________________________________________________
+Bool_t TCExtractor::ExtractRun(Int_t run)
+{
+    // Extract the histograms of the run 'run'.
+    // Return kTRUE on success.
+
+    // construct file names
+    TString inName(fInputFilePatt);
+    inName.ReplaceAll("RUN", TString::Format("%d", run));
+    TString outName(fOutputFilePatt);
+    outName.ReplaceAll("RUN", TString::Format("%d", run));
+
+    // open the input file
+    TFile* fin = TFile::Open(inName.Data());
+    if (!fin)
+    {
+        Warning("Extract", "Could not open file '%s'", inName.Data());
+        return kFALSE;
+    }
+    if (fin->IsZombie())
+    {
+        Warning("Extract", "Could not open file '%s'", inName.Data());
+        delete fin;
+        return kFALSE;
+    }
+
+    // histograms to write
+    Int_t nFam = fFamilies->GetEntriesFast();
+    TObjArray direct;
+    direct.SetOwner(kTRUE);
+    TObjArray* elem = new TObjArray[nFam];
+    for (Int_t i = 0; i < nFam; i++) elem[i].SetOwner(kTRUE);
+
+    // loop over the keys
+    TIter next(fin->GetListOfKeys());
+    TKey* key;
+    while ((key = (TKey*) next()))
+    {
+        const Char_t* name = key->GetName();
+
+        // skip old cycles and non-histograms
+        if (fin->GetKey(name) != key) continue;
+        TClass* cl = TClass::GetClass(key->GetClassName());
+        if (!cl || !cl->InheritsFrom("TH1")) continue;
+
+        // check if the histogram is needed
+        Bool_t isDirect = fNames->FindObject(name) ? kTRUE : kFALSE;
+        Int_t fam = -1;
+        Int_t index = 0;
+        for (Int_t i = 0; i < nFam && !isDirect && fam == -1; i++)
+            if (MatchPattern(((TObjString*) fFamilies->At(i))->GetString().Data(), name, &index)) fam = i;
+        if (!isDirect && fam == -1) continue;
+
+        // read the histogram
+        TH1* h = (TH1*) key->ReadObj();
+        if (!h) continue;
+        h->ResetBit(kMustCleanup);
+        if (isDirect) direct.Add(h);
+        else elem[fam].AddAtAndExpand(h, index);
+    }
+
+    // close the input file
+    delete fin;
+
+    // create the output file
+    TFile* fout = new TFile(outName.Data(), "RECREATE");
+    if (fout->IsZombie())
+    {
+        Error("Extract", "Could not create file '%s'", outName.Data());
+        delete fout;
+        delete [] elem;
+        return kFALSE;
+    }
+
+    // write the single histograms
+    for (Int_t i = 0; i < direct.GetEntriesFast(); i++)
+        fout->WriteTObject(direct.At(i), direct.At(i)->GetName());
+
+    // write the families
+    for (Int_t i = 0; i < nFam; i++)
+    {
+        if (elem[i].GetLast() < 0) continue;
+        const Char_t* pattern = ((TObjString*) fFamilies->At(i))->GetString().Data();
+
+        // pack the family
+        TString map;
+        TH1* packed = Pack(&elem[i], pattern, &map);
+        if (packed)
+        {
+            // write packed histogram and family description
+            TNamed info(TString::Format("Family_%s", packed->GetName()).Data(),
+                        TString::Format("%s %s %c %s", pattern,
+                                        packed->GetDimension() == 2 ? "x" : "yx",
+                                        packed->GetDimension() == 2 ? 'y' : 'z', map.Data()).Data());
+            fout->WriteTObject(packed, packed->GetName());
+            fout->WriteTObject(&info, info.GetName());
+            delete packed;
+        }
+        else
+        {
+            // write the single element histograms
+            for (Int_t j = 0; j <= elem[i].GetLast(); j++)
+                if (elem[i].At(j)) fout->WriteTObject(elem[i].At(j), elem[i].At(j)->GetName());
+        }
+    }
+
+    // clean-up
+    delete fout;
+    delete [] elem;
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+void* TCExtractor::ExtractWorker(void* arg)
+{
+    // Extraction thread: extract the runs of the subset defined by the
+    // task 'arg'.
+
+    TCExtractorTask* task = (TCExtractorTask*) arg;
+    for (Int_t i = task->fFirst; i < task->fLast; i++)
+    {
+        if (task->fExtractor->ExtractRun(task->fRun[i]))
+        {
+            task->fNDone++;
+            Info("Extract", "Extracted run %d", task->fRun[i]);
+        }
+    }
+
+    return 0;
+}
+
+//______________________________________________________________________________
+Int_t TCExtractor::Extract(Int_t nRun, const Int_t* runs)
+{
+    // Extract the histograms of the 'nRun' runs 'runs' using fNThreads
+    // threads. Return the number of extracted runs.
+
+    // check runs
+    if (nRun <= 0) return 0;
+
+    // do not keep histograms in memory
+    TH1::AddDirectory(kFALSE);
+
+    // number of threads
+    Int_t nThreads = TMath::Min(fNThreads, nRun);
+
+    // enable ROOT thread safety
+    if (nThreads > 1) TThread::Initialize();
+
+    // create extraction tasks of the run subsets
+    TCExtractorTask* task = new TCExtractorTask[nThreads];
+    TThread** thread = new TThread*[nThreads];
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        task[i].fExtractor = this;
+        task[i].fRun = runs;
+        task[i].fFirst = i * nRun / nThreads;
+        task[i].fLast = (i+1) * nRun / nThreads;
+        task[i].fNDone = 0;
+        if (nThreads > 1)
+        {
+            thread[i] = new TThread(TString::Format("TCExtractor_%d", i).Data(),
+                                    ExtractWorker, (void*) &task[i]);
+            thread[i]->Run();
+        }
+        else ExtractWorker((void*) &task[i]);
+    }
+
+    // wait for the extraction threads
+    Int_t nDone = 0;
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        if (nThreads > 1)
+        {
+            thread[i]->Join();
+            delete thread[i];
+        }
+        nDone += task[i].fNDone;
+    }
+
+    // clean-up
+    delete [] task;
+    delete [] thread;
+
+    // user information
+    Info("Extract", "Extracted %d of %d runs", nDone, nRun);
+
+    return nDone;
+}
+
@@ -11,11 +11,178 @@
 //////////////////////////////////////////////////////////////////////////
 
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
 #include "TCFileManager.h"
 
 ClassImp(TCFileManager)
 
 
+// argument of the summation and reduction worker threads
+struct TCFileManagerTask
+{
+    TCFileManager* fManager;                // file manager
+    Int_t fNName;                           // number of histograms
+    const Char_t* const* fName;             // names of the histograms
+    Int_t fFirst;                           // index of first file
+    Int_t fLast;                            // index of last file (exclusive)
+    TH1** fSum;                             // (partial) sums
+    TH1** fAdd;                             // histograms to add in reduction
+};
+
+
+// argument of the file checking threads
+struct TCFileManagerCheck
+{
+    const TString* fName;                   // file names
+    Int_t fFirst;                           // index of first file
+    Int_t fLast;                            // index of last file (exclusive)
+    Int_t fKeepOpen;                        // files below this index are kept open
+    Int_t* fStatus;                         // check status of the files
+    TString* fStat;                         // size and modification time of the files
+    TFile** fFile;                          // handles of the files kept open
+};
+
+
+// check status of an input file
+enum EFileStatus
+{
+    kFileGood,
+    kFileMissing,
+    kFileCorrupt
+};
+
+
+// session cache of the file check results (file name -> "size:mtime:status")
+static THashList* gFileCheckCache = 0;
+static TMutex* gFileCheckMutex = 0;
+
+
+// on-disk location of an input file
+struct TCFileManagerLocation
+{
+    Long_t fDev;                            // device
+    Long_t fIno;                            // inode
+    Int_t fIndex;                           // index in the file list
+
+    bool operator<(const TCFileManagerLocation& l) const
+    {
+        if (fDev != l.fDev) return fDev < l.fDev;
+        if (fIno != l.fIno) return fIno < l.fIno;
+        return fIndex < l.fIndex;
+    }
+};
+
+
+//______________________________________________________________________________
+static void AddArray(Double_t* a, const Double_t* b, Int_t n)
+{
+    // Add the array 'b' to the array 'a' of length 'n'.
+
+    Int_t i = 0;
+#ifdef __SSE2__
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128d a0 = _mm_loadu_pd(a + i);
+        __m128d a1 = _mm_loadu_pd(a + i + 2);
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(b + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(b + i + 2));
+        _mm_storeu_pd(a + i, a0);
+        _mm_storeu_pd(a + i + 2, a1);
+    }
+#endif
+    for (; i < n; i++) a[i] += b[i];
+}
+
+//______________________________________________________________________________
+static void AddArray(Float_t* a, const Float_t* b, Int_t n)
+{
+    // Add the array 'b' to the array 'a' of length 'n'.
+
+    Int_t i = 0;
+#ifdef __SSE2__
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128 a0 = _mm_loadu_ps(a + i);
+        __m128 a1 = _mm_loadu_ps(a + i + 4);
+        a0 = _mm_add_ps(a0, _mm_loadu_ps(b + i));
+        a1 = _mm_add_ps(a1, _mm_loadu_ps(b + i + 4));
+        _mm_storeu_ps(a + i, a0);
+        _mm_storeu_ps(a + i + 4, a1);
+    }
+#endif
+    for (; i < n; i++) a[i] += b[i];
+}
+
+//______________________________________________________________________________
+static Int_t CheckFile(const Char_t* filename, TString& outStat, TFile** outFile)
+{
+    // Check the file 'filename' and return its status. Save its size and
+    // modification time to 'outStat'. If 'outFile' is non-zero the good 
+    // file is kept open and its handle is stored there.
+    // Results of opened files are kept in the session cache and reused as 
+    // long as the file size and modification time do not change.
+
+    // init output
+    if (outFile) *outFile = 0;
+
+    // get size and modification time
+    FileStat_t fileinfo;
+    if (gSystem->GetPathInfo(filename, fileinfo))
+    {
+        outStat = "-";
+        return kFileMissing;
+    }
+    outStat = TString::Format("%lld:%ld", fileinfo.fSize, fileinfo.fMtime);
+
+    // look up the session cache
+    Int_t status = -1;
+    gFileCheckMutex->Lock();
+    TNamed* entry = (TNamed*) gFileCheckCache->FindObject(filename);
+    if (entry)
+    {
+        TString res(entry->GetTitle());
+        Ssiz_t pos = res.Last(':');
+        if (pos != kNPOS && res(0, pos) == outStat) status = TString(res(pos+1, res.Length())).Atoi();
+    }
+    gFileCheckMutex->UnLock();
+
+    // use the cached result if the file does not have to be opened
+    if (status == kFileCorrupt) return kFileCorrupt;
+    if (status == kFileGood && !outFile) return kFileGood;
+
+    // open the file
+    TFile* f = TFile::Open(filename);
+    if (!f) status = kFileCorrupt;
+    else if (f->IsZombie())
+    {
+        status = kFileCorrupt;
+        delete f;
+    }
+    else
+    {
+        status = kFileGood;
+        if (outFile) *outFile = f;
+        else delete f;
+    }
+
+    // update the session cache
+    TString res = TString::Format("%s:%d", outStat.Data(), status);
+    gFileCheckMutex->Lock();
+    entry = (TNamed*) gFileCheckCache->FindObject(filename);
+    if (entry) entry->SetTitle(res.Data());
+    else gFileCheckCache->Add(new TNamed(filename, res.Data()));
+    gFileCheckMutex->UnLock();
+
+    return status;
+}
+
 //______________________________________________________________________________
 TCFileManager::TCFileManager(const Char_t* data, const Char_t* calibration, 
                              Int_t nSet, Int_t* set, const Char_t* filePat)
@@ -31,14 +198,48 @@ TCFileManager::TCFileManager(const Char_t* data, const Char_t* calibration,
     fNset = nSet;
     fSet = new Int_t[fNset];
     for (Int_t i = 0; i < fNset; i++) fSet[i] = set[i];
-    fFiles = new TList();
+    fNRun = 0;
+    fRun = 0;
+    fIndex = 0;
+    fFamilies = new TObjArray();
+    fFamilies->SetOwner(kTRUE);
+    fFiles = new TObjArray();
     fFiles->SetOwner(kTRUE);
+    fNThreads = 1;
+    fCacheDir = "";
+    fFingerprint = "";
+    fNElem = 0;
+    fElemName = 0;
+    fElemHisto = 0;
+    fElemProj = "";
+    fElemAxis = 0;
+    fElemUser = kTRUE;
+    fElemMin = 0;
+    fElemMax = 0;
+    fBlockSize = 32;
+    fFileHandle = 0;
+    fFileLastUse = 0;
+    fFileUsers = 0;
+    fNOpen = 0;
+    fMaxOpen = 100;
+    fUseCounter = 0;
+    fPoolMutex = new TMutex();
+    fFileOrder = 0;
+    fReadAhead = 4;
+    fIOWait = 0;
+    fSliceProj = "";
+    fSliceAxis = 0;
+    fSliceUser = kTRUE;
+    fSliceMin = 0;
+    fSliceMax = 0;
 
-    // read input file pattern
+    // read input file pattern (prefer slim files)
     if (filePat) fInputFilePatt = filePat;
     else
     {
-        if (TString* f = TCReadConfig::GetReader()->GetConfig("File.Input.Rootfiles"))
+        TString* f = TCReadConfig::GetReader()->GetConfig("File.Input.Slim");
+        if (!f) f = TCReadConfig::GetReader()->GetConfig("File.Input.Rootfiles");
+        if (f)
         {
             fInputFilePatt = *f;
             
@@ -56,6 +257,50 @@ TCFileManager::TCFileManager(const Char_t* data, const Char_t* calibration,
         }
     }
 
+    // read number of summation threads
+    if (TCReadConfig::GetReader()->GetConfig("File.Input.Threads"))
+        SetNThreads(TCReadConfig::GetReader()->GetConfigInt("File.Input.Threads"));
+
+    // read histogram cache directory
+    if (TString* d = TCReadConfig::GetReader()->GetConfig("File.Cache.Dir"))
+    {
+        TString dir(*d);
+        gSystem->ExpandPathName(dir);
+        SetCacheDir(dir.Data());
+    }
+
+    // read the read-ahead depth
+    if (TCReadConfig::GetReader()->GetConfig("File.Input.ReadAhead"))
+        SetReadAhead(TCReadConfig::GetReader()->GetConfigInt("File.Input.ReadAhead"));
+
+    // read maximum number of open files
+    if (TCReadConfig::GetReader()->GetConfig("File.Input.MaxOpen"))
+        SetMaxOpenFiles(TCReadConfig::GetReader()->GetConfigInt("File.Input.MaxOpen"));
+
+    // open the histogram index
+    if (TString* idx = TCReadConfig::GetReader()->GetConfig("File.Index"))
+    {
+        TString idxFile(*idx);
+        gSystem->ExpandPathName(idxFile);
+        fIndex = new TCHistoIndex(idxFile.Data());
+        if (!fIndex->IsValid())
+        {
+            delete fIndex;
+            fIndex = 0;
+        }
+        else if (fInputFilePatt != fIndex->GetPattern())
+        {
+            Warning("TCFileManager", "Histogram index '%s' was built for the input files '%s'",
+                    idxFile.Data(), fIndex->GetPattern());
+            delete fIndex;
+            fIndex = 0;
+        }
+    }
+
+    // read block size of per-element histogram fetching
+    if (TCReadConfig::GetReader()->GetConfig("File.Input.BlockSize"))
+        SetBlockSize(TCReadConfig::GetReader()->GetConfigInt("File.Input.BlockSize"));
+
     // build the list of files
     BuildFileList();
 }
@@ -65,15 +310,50 @@ TCFileManager::~TCFileManager()
 {
     // Destructor.
 
+    // close open files
+    if (fFileHandle)
+    {
+        for (Int_t i = 0; i < fFiles->GetEntriesFast(); i++)
+            if (fFileHandle[i]) delete fFileHandle[i];
+        delete [] fFileHandle;
+    }
+    if (fFileLastUse) delete [] fFileLastUse;
+    if (fFileUsers) delete [] fFileUsers;
+    if (fFileOrder) delete [] fFileOrder;
+    if (fPoolMutex) delete fPoolMutex;
+
     if (fFiles) delete fFiles;
     if (fSet) delete [] fSet;
+    if (fRun) delete [] fRun;
+    if (fIndex) delete fIndex;
+    if (fFamilies) delete fFamilies;
+    if (fElemName) delete [] fElemName;
+    if (fElemHisto)
+    {
+        for (Int_t i = 0; i < fNElem; i++) 
+            if (fElemHisto[i]) delete fElemHisto[i];
+        delete [] fElemHisto;
+    }
+    if (fElemMin) delete [] fElemMin;
+    if (fElemMax) delete [] fElemMax;
 }
 
 //______________________________________________________________________________
 void TCFileManager::BuildFileList()
 {
     // Build the list of files belonging to the runsets.
+    // The files are checked in parallel using fNThreads threads. Only the
+    // first fMaxOpen files are kept open. The others are opened on demand 
+    // by AcquireFile().
     
+    // init the session cache of the file check results
+    if (!gFileCheckCache)
+    {
+        gFileCheckCache = new THashList();
+        gFileCheckCache->SetOwner(kTRUE);
+        gFileCheckMutex = new TMutex();
+    }
+
     // loop over sets
     for (Int_t i = 0; i < fNset; i++)
     {
@@ -84,102 +364,1405 @@ void TCFileManager::BuildFileList()
         // user information
         Info("BuildFileList", "Trying to add %d runs of set %d", nRun, fSet[i]);
 
-        // loop over runs
-        for (Int_t j = 0; j < nRun; j++)
+        // save the runs
+        Int_t* allRuns = new Int_t[fNRun+nRun];
+        for (Int_t j = 0; j < fNRun; j++) allRuns[j] = fRun[j];
+        for (Int_t j = 0; j < nRun; j++) allRuns[fNRun+j] = runs[j];
+        if (fRun) delete [] fRun;
+        fRun = allRuns;
+        fNRun += nRun;
+
+        // clean-up
+        delete runs;
+    }
+
+    // construct the file names
+    TString* name = new TString[fNRun];
+    for (Int_t i = 0; i < fNRun; i++)
+    {
+        name[i] = fInputFilePatt;
+        name[i].ReplaceAll("RUN", TString::Format("%d", fRun[i]));
+    }
+
+    // check results
+    Int_t* status = new Int_t[fNRun];
+    TString* stat = new TString[fNRun];
+    TFile** file = new TFile*[fNRun];
+    for (Int_t i = 0; i < fNRun; i++) file[i] = 0;
+
+    // number of threads
+    Int_t nThreads = TMath::Max(1, TMath::Min(fNThreads, fNRun));
+
+    // enable ROOT thread safety
+    if (nThreads > 1) TThread::Initialize();
+
+    // create file checking tasks of the file subsets
+    TCFileManagerCheck* task = new TCFileManagerCheck[nThreads];
+    TThread** thread = new TThread*[nThreads];
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        task[i].fName = name;
+        task[i].fFirst = i * fNRun / nThreads;
+        task[i].fLast = (i+1) * fNRun / nThreads;
+        task[i].fKeepOpen = fMaxOpen;
+        task[i].fStatus = status;
+        task[i].fStat = stat;
+        task[i].fFile = file;
+        if (nThreads > 1)
         {
-            // construct file name
-            TString filename(fInputFilePatt);
-            filename.ReplaceAll("RUN", TString::Format("%d", runs[j]));
+            thread[i] = new TThread(TString::Format("TCFileManager_Check_%d", i).Data(),
+                                    CheckWorker, (void*) &task[i]);
+            thread[i]->Run();
+        }
+        else CheckWorker((void*) &task[i]);
+    }
 
-            // open the file
-            TFile* f = TFile::Open(filename.Data());
-            
-            // check nonexisting file
-            if (!f) 
-            {   
-                Warning("BuildFileList", "Could not open file '%s'", filename.Data());
-                continue;
-            }
+    // wait for the file checking threads
+    if (nThreads > 1)
+    {
+        for (Int_t i = 0; i < nThreads; i++)
+        {
+            thread[i]->Join();
+            delete thread[i];
+        }
+    }
+    delete [] task;
+    delete [] thread;
 
-            // check bad file
-            if (f->IsZombie())
-            {
-                Warning("BuildFileList", "Could not open file '%s'", filename.Data());
-                continue;
-            }
+    // start the fingerprint with the input file pattern
+    fFingerprint = fInputFilePatt;
+    fFingerprint.Append(";");
 
-            // add good file to list
-            fFiles->Add(f);
+    // add the good files in the order of the runs
+    TObjArray handles;
+    Int_t nMissing = 0;
+    Int_t nCorrupt = 0;
+    for (Int_t i = 0; i < fNRun; i++)
+    {
+        // add run, size and modification time to the fingerprint
+        fFingerprint.Append(TString::Format("%d:%s;", fRun[i], stat[i].Data()));
 
-            // user information
-            Info("BuildFileList", "%03d : added file '%s'", j, f->GetName());
+        // check status
+        if (status[i] == kFileMissing)
+        {
+            nMissing++;
+            continue;
+        }
+        else if (status[i] == kFileCorrupt)
+        {
+            Warning("BuildFileList", "Could not open file '%s'", name[i].Data());
+            nCorrupt++;
+            continue;
         }
 
-        // clean-up
-        delete runs;
+        // add good file to list
+        fFiles->Add(new TObjString(name[i].Data()));
+
+        // keep the file open
+        if (file[i]) handles.AddAtAndExpand(file[i], fFiles->GetEntriesFast()-1);
+    }
+
+    // user information
+    Info("BuildFileList", "Found %d of %d files (%d missing, %d corrupt)",
+         fFiles->GetEntriesFast(), fNRun, nMissing, nCorrupt);
+
+    // clean-up
+    delete [] name;
+    delete [] status;
+    delete [] stat;
+    delete [] file;
+
+    // init the pool of open files
+    Int_t nFiles = fFiles->GetEntriesFast();
+    fFileHandle = new TFile*[nFiles];
+    fFileLastUse = new Long64_t[nFiles];
+    fFileUsers = new Int_t[nFiles];
+    fNOpen = 0;
+    fUseCounter = 0;
+    for (Int_t i = 0; i < nFiles; i++)
+    {
+        fFileHandle[i] = i < handles.GetSize() ? (TFile*) handles.At(i) : 0;
+        fFileLastUse[i] = 0;
+        fFileUsers[i] = 0;
+        if (fFileHandle[i]) fNOpen++;
     }
+
+    // order the files by their location on disk
+    SortFiles();
+
+    // read the packed element histogram families
+    ReadFamilies();
+
+    // condense the fingerprint
+    TMD5 md5;
+    md5.Update((const UChar_t*) fFingerprint.Data(), fFingerprint.Length());
+    md5.Final();
+    fFingerprint = md5.AsString();
 }
 
 //______________________________________________________________________________
-TH1* TCFileManager::GetHistogram(const Char_t* name)
+void* TCFileManager::CheckWorker(void* arg)
 {
-    // Get the summed-up histogram with name 'name'.
-    // NOTE: the histogram has to be destroyed by the caller.
+    // File checking thread: check the files of the subset defined by the
+    // task 'arg'.
 
-    TH1* hOut = 0;
+    TCFileManagerCheck* task = (TCFileManagerCheck*) arg;
+    for (Int_t i = task->fFirst; i < task->fLast; i++)
+        task->fStatus[i] = CheckFile(task->fName[i].Data(), task->fStat[i],
+                                     i < task->fKeepOpen ? &task->fFile[i] : 0);
 
-    // check if there are some runs
-    if (!fFiles->GetSize())
+    return 0;
+}
+
+//______________________________________________________________________________
+void TCFileManager::SortFiles()
+{
+    // Set the processing order of the input files according to their 
+    // location on disk (device and inode) to reduce seeking. Files that 
+    // cannot be located keep their order in front of the others.
+
+    // get the file locations
+    Int_t nFiles = fFiles->GetEntriesFast();
+    TCFileManagerLocation* loc = new TCFileManagerLocation[nFiles];
+    for (Int_t i = 0; i < nFiles; i++)
     {
-        Error("GetHistogram", "ROOT file list is empty!");
+        FileStat_t fileinfo;
+        if (gSystem->GetPathInfo(((TObjString*) fFiles->At(i))->GetString().Data(), fileinfo))
+        {
+            loc[i].fDev = 0;
+            loc[i].fIno = 0;
+        }
+        else
+        {
+            loc[i].fDev = fileinfo.fDev;
+            loc[i].fIno = fileinfo.fIno;
+        }
+        loc[i].fIndex = i;
+    }
+
+    // sort the files
+    std::sort(loc, loc + nFiles);
+    if (fFileOrder) delete [] fFileOrder;
+    fFileOrder = new Int_t[nFiles];
+    for (Int_t i = 0; i < nFiles; i++) fFileOrder[i] = loc[i].fIndex;
+
+    // clean-up
+    delete [] loc;
+}
+
+//______________________________________________________________________________
+void TCFileManager::ReadAhead(Int_t i)
+{
+    // Advise the operating system to read the input file with index 'i'
+    // into the page cache in the background.
+    
+#ifdef POSIX_FADV_WILLNEED
+    Int_t fd = open(((TObjString*) fFiles->At(i))->GetString().Data(), O_RDONLY);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#endif
+}
+
+//______________________________________________________________________________
+void TCFileManager::ReadFamilies()
+{
+    // Read the descriptions of the packed element histogram families from
+    // the first input file (slim files created by TCExtractor). The element
+    // maps of the other files are checked when summing (see CheckFamily()).
+
+    // get the first file
+    if (!fFiles->GetEntriesFast()) return;
+    TFile* f = AcquireFile(0);
+    if (!f) return;
+
+    // loop over keys
+    TIter next(f->GetListOfKeys());
+    TKey* key;
+    while ((key = (TKey*) next()))
+    {
+        TString name = key->GetName();
+        if (!name.BeginsWith("Family_")) continue;
+        TNamed* fam = (TNamed*) f->Get(name.Data());
+        if (!fam) continue;
+        name.Remove(0, 7);
+        fFamilies->Add(new TNamed(name.Data(), fam->GetTitle()));
+        delete fam;
+    }
+
+    // release the file
+    ReleaseFile(0);
+
+    // user information
+    if (fFamilies->GetEntriesFast())
+        Info("BuildFileList", "Found %d packed element histogram families", 
+             fFamilies->GetEntriesFast());
+}
+
+//______________________________________________________________________________
+Int_t TCFileManager::FindFamily(const Char_t* name, Int_t* outBin, 
+                                TString* outProj, Char_t* outAxis)
+{
+    // Return the index of the packed element histogram family the histogram
+    // 'name' belongs to or -1 if it does not belong to any family. The 
+    // bin of the element on the element axis (0 if the element was not 
+    // packed) and the projection and axis needed to unpack the element are
+    // saved to 'outBin', 'outProj' and 'outAxis'.
+
+    for (Int_t i = 0; i < fFamilies->GetEntriesFast(); i++)
+    {
+        // read the family description
+        const Char_t* title = fFamilies->At(i)->GetTitle();
+        Char_t pattern[256];
+        Char_t proj[8];
+        Char_t axis;
+        Int_t length = 0;
+        if (sscanf(title, "%255s %7s %c%n", pattern, proj, &axis, &length) != 3)
+            continue;
+
+        // check the name
+        Int_t index;
+        if (TCExtractor::MatchPattern(pattern, name, &index))
+        {
+            TString map = TString(title + length).Strip(TString::kBoth);
+            *outBin = TCExtractor::GetPackedBin(map.Data(), index);
+            *outProj = proj;
+            *outAxis = axis;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+//______________________________________________________________________________
+Bool_t TCFileManager::CheckFamily(TFile* f, const Char_t* name)
+{
+    // Check if the histogram 'name' of the file 'f' can be summed with the
+    // ones of the first input file, i.e. if it is not a packed element 
+    // histogram or if its family has the same element map in both files.
+    // The elements present can differ between the runs and a different 
+    // map would add the bins of different elements.
+
+    // check if the histogram is a packed element histogram
+    if (!fFamilies) return kTRUE;
+    TObject* fam = fFamilies->FindObject(name);
+    if (!fam) return kTRUE;
+
+    // compare the family descriptions
+    TNamed* info = (TNamed*) f->Get(TString::Format("Family_%s", name).Data());
+    Bool_t same = info && !strcmp(info->GetTitle(), fam->GetTitle()) ? kTRUE : kFALSE;
+    if (info) delete info;
+
+    return same;
+}
+
+//______________________________________________________________________________
+TFile* TCFileManager::AcquireFile(Int_t i)
+{
+    // Return the open input file with index 'i'. The file is opened if 
+    // necessary. When the maximum number of open files is reached, the least
+    // recently used file that is currently not in use is closed.
+    // Return 0 if the file could not be opened.
+    // NOTE: every acquired file has to be released via ReleaseFile().
+
+    // check if the file is open
+    fPoolMutex->Lock();
+    if (fFileHandle[i])
+    {
+        fFileUsers[i]++;
+        fFileLastUse[i] = ++fUseCounter;
+        fPoolMutex->UnLock();
+        return fFileHandle[i];
+    }
+
+    // close the least recently used file if the pool is full
+    if (fNOpen >= fMaxOpen)
+    {
+        Int_t lru = -1;
+        for (Int_t j = 0; j < fFiles->GetEntriesFast(); j++)
+        {
+            if (!fFileHandle[j] || fFileUsers[j]) continue;
+            if (lru == -1 || fFileLastUse[j] < fFileLastUse[lru]) lru = j;
+        }
+        if (lru != -1)
+        {
+            delete fFileHandle[lru];
+            fFileHandle[lru] = 0;
+            fNOpen--;
+        }
+    }
+    fPoolMutex->UnLock();
+
+    // open the file
+    const Char_t* filename = ((TObjString*) fFiles->At(i))->GetString().Data();
+    TFile* f = TFile::Open(filename);
+    if (!f)
+    {
+        Error("AcquireFile", "Could not open file '%s'", filename);
+        return 0;
+    }
+    if (f->IsZombie())
+    {
+        Error("AcquireFile", "Could not open file '%s'", filename);
+        delete f;
         return 0;
     }
+
+    // add the file to the pool
+    fPoolMutex->Lock();
+    if (fFileHandle[i]) delete f;
+    else
+    {
+        fFileHandle[i] = f;
+        fNOpen++;
+    }
+    fFileUsers[i]++;
+    fFileLastUse[i] = ++fUseCounter;
+    f = fFileHandle[i];
+    fPoolMutex->UnLock();
+
+    return f;
+}
+
+//______________________________________________________________________________
+void TCFileManager::ReleaseFile(Int_t i)
+{
+    // Release the input file with index 'i' acquired via AcquireFile().
+    
+    fPoolMutex->Lock();
+    if (fFileUsers[i] > 0) fFileUsers[i]--;
+    fPoolMutex->UnLock();
+}
+
+//______________________________________________________________________________
+TString TCFileManager::GetCacheFileName()
+{
+    // Return the name of the histogram cache file of the calibration, the 
+    // calibration data and the sets of this file manager.
+
+    // build the identifier
+    TString id = TString::Format("%s_%s_Set", fCalibration.Data(), fCalibData.Data());
+    for (Int_t i = 0; i < fNset; i++) id.Append(TString::Format("_%d", fSet[i]));
+
+    // replace problematic characters
+    for (Int_t i = 0; i < id.Length(); i++)
+        if (!isalnum(id[i]) && id[i] != '.' && id[i] != '-') id[i] = '_';
+
+    return TString::Format("%s/%s.root", fCacheDir.Data(), id.Data());
+}
+
+//______________________________________________________________________________
+void TCFileManager::ReadCache(Int_t n, const Char_t* const* names, TH1** outHisto)
+{
+    // Read the summed-up histograms with the 'n' names 'names' from the 
+    // histogram cache and store them in 'outHisto'. Elements of 'outHisto'
+    // are left at 0 if the histogram was not cached or if the cached
+    // histogram is outdated, i.e. if the fingerprint of the input files changed.
+    // NOTE: the histograms have to be destroyed by the caller.
+
+    // check cache file
+    TString filename = GetCacheFileName();
+    if (gSystem->AccessPathName(filename.Data())) return;
+
+    // open cache file
+    TFile* f = TFile::Open(filename.Data());
+    if (!f) return;
+    if (f->IsZombie())
+    {
+        delete f;
+        return;
+    }
+
+    // loop over histograms
+    Int_t nRead = 0;
+    for (Int_t i = 0; i < n; i++)
+    {
+        // check the fingerprint
+        TNamed* fp = (TNamed*) f->Get(TString::Format("Fingerprint_%s", names[i]).Data());
+        if (fp && !strcmp(fp->GetTitle(), fFingerprint.Data()))
+        {
+            // load the histogram
+            outHisto[i] = (TH1*) f->Get(names[i]);
+            if (outHisto[i]) 
+            {
+                outHisto[i]->ResetBit(kMustCleanup);
+                nRead++;
+            }
+        }
+        
+        // clean-up
+        if (fp) delete fp;
+    }
     
-    // do not keep histograms in memory
-    TH1::AddDirectory(kFALSE);
+    // user information
+    if (nRead) Info("GetHistogram", "Loaded %d histogram(s) from cache '%s'", 
+                    nRead, filename.Data());
+
+    // clean-up
+    delete f;
+}
+
+//______________________________________________________________________________
+void TCFileManager::WriteCache(Int_t n, const Char_t* const* names, TH1** histo)
+{
+    // Write the 'n' summed-up histograms 'histo' with the names 'names' 
+    // together with the fingerprint of the input files to the histogram cache.
+    
+    // create cache directory
+    gSystem->mkdir(fCacheDir.Data(), kTRUE);
+
+    // open cache file
+    TString filename = GetCacheFileName();
+    TFile* f = TFile::Open(filename.Data(), "UPDATE");
+    if (!f) 
+    {
+        Warning("GetHistogram", "Could not open histogram cache '%s'", filename.Data());
+        return;
+    }
+    if (f->IsZombie())
+    {
+        Warning("GetHistogram", "Could not open histogram cache '%s'", filename.Data());
+        delete f;
+        return;
+    }
+
+    // write histograms and fingerprints
+    for (Int_t i = 0; i < n; i++)
+    {
+        if (!histo[i]) continue;
+        TNamed fp(TString::Format("Fingerprint_%s", names[i]).Data(), fFingerprint.Data());
+        f->WriteTObject(histo[i], names[i], "WriteDelete");
+        f->WriteTObject(&fp, fp.GetName(), "WriteDelete");
+    }
+
+    // clean-up
+    delete f;
+}
+
+//______________________________________________________________________________
+void TCFileManager::SumFiles(Int_t n, const Char_t* const* names, TH1** outHisto,
+                             Int_t first, Int_t last)
+{
+    // Sum the 'n' histograms with the names 'names' of the files at the 
+    // positions 'first' to 'last' (exclusive) of the processing order and
+    // store the sums in 'outHisto'.
+    // Every file is visited only once and its histograms are read in the
+    // order of their position in the file. The next fReadAhead files are
+    // read ahead in the background.
+    // Elements of 'outHisto' are 0 if the histogram was not found in any of
+    // these files.
+    // NOTE: the histograms have to be destroyed by the caller.
+
+    // init sums
+    for (Int_t i = 0; i < n; i++) outHisto[i] = 0;
+
+    // key positions
+    Long64_t* seek = new Long64_t[n];
+    Int_t* order = new Int_t[n];
+
+    // binning check results (-1: not checked yet)
+    Int_t* sameBinning = new Int_t[n];
+    for (Int_t i = 0; i < n; i++) sameBinning[i] = -1;
+
+    // I/O wait time
+    TStopwatch watch;
+    Double_t ioWait = 0;
 
     // loop over files
-    TIter next(fFiles);
-    TFile* f;
-    Bool_t first = kTRUE;
-    while ((f = (TFile*)next()))
+    Int_t ahead = first;
+    for (Int_t p = first; p < last; p++)
     {
-        // get histogram
-        TH1* h = (TH1*) f->Get(name);
+        Int_t i = fFileOrder[p];
+
+        // read ahead the next files
+        while (fReadAhead > 0 && ahead < last && ahead <= p + fReadAhead) 
+            ReadAhead(fFileOrder[ahead++]);
+
+        // get the file
+        watch.Start(kTRUE);
+        TFile* f = AcquireFile(i);
+        watch.Stop();
+        ioWait += watch.RealTime();
+        if (!f) continue;
 
-        // check if histogram is there
-        if (h)
+        // look up the keys and their position in the file
+        for (Int_t j = 0; j < n; j++)
         {
-            // correct destroying
-            h->ResetBit(kMustCleanup);  
+            TKey* key = f->GetKey(names[j]);
+            seek[j] = key ? key->GetSeekKey() : -1;
 
-            // check if object is really a histogram
-            if (h->InheritsFrom("TH1"))
+            // skip packed element histograms having a different element map
+            // (slices of the same histogram are checked only once)
+            if (seek[j] >= 0)
             {
-                // check if it is the first one
-                if (first) 
+                if (j && !strcmp(names[j], names[j-1])) 
                 {
-                    hOut = (TH1*) h->Clone();      
-                    first = kFALSE;
+                    if (seek[j-1] == -2) seek[j] = -2;
+                }
+                else if (!CheckFamily(f, names[j]))
+                {
+                    Error("GetHistogram", "Element map of the packed histogram '%s' in file '%s' differs "
+                                          "from the one of the first file - skipping file", names[j], f->GetName());
+                    seek[j] = -2;
                 }
-                else hOut->Add(h);
-            }
-            else
-            {
-                Error("GetHistogram", "Object '%s' found in file '%s' is not a histogram!",
-                                      name, f->GetName());
             }
-
-            // clean-up
-            delete h;
         }
-        else
+        TMath::Sort(n, seek, order, kFALSE);
+    
+        // loop over histograms
+        TObject* obj = 0;
+        for (Int_t k = 0; k < n; k++)
         {
-            Warning("GetHistogram", "Histogram '%s' was not found in file '%s'",
-                                    name, f->GetName());
-        }
-    } // loop over files
+            Int_t j = order[k];
 
-    return hOut;
+            // check if histogram is there
+            if (seek[j] == -2) continue;
+            if (seek[j] < 0)
+            {
+                Warning("GetHistogram", "Histogram '%s' was not found in file '%s'",
+                                        names[j], f->GetName());
+                continue;
+            }
+
+            // get histogram (slices of the same histogram are adjacent and
+            // are taken from the same object)
+            if (!obj || seek[j] != seek[order[k-1]])
+            {
+                if (obj) delete obj;
+                watch.Start(kTRUE);
+                obj = f->Get(names[j]);
+                watch.Stop();
+                ioWait += watch.RealTime();
+                if (!obj) continue;
+
+                // correct destroying
+                obj->ResetBit(kMustCleanup);  
+
+                // check if object is really a histogram
+                if (!obj->InheritsFrom("TH1"))
+                {
+                    Error("GetHistogram", "Object '%s' found in file '%s' is not a histogram!",
+                                          names[j], f->GetName());
+                    delete obj;
+                    obj = 0;
+                    continue;
+                }
+            }
+
+            // project the histogram or take it over
+            TH1* h;
+            if (fSliceProj != "") 
+            {
+                h = Slice((TH1*) obj, j);
+                if (!h) continue;
+            }
+            else
+            {
+                h = (TH1*) obj;
+                obj = 0;
+            }
+
+            // keep the first one as sum, add the others (check the binning
+            // only once per histogram)
+            if (!outHisto[j]) outHisto[j] = h;
+            else 
+            {
+                if (sameBinning[j] == -1) sameBinning[j] = IsSameBinning(outHisto[j], h);
+                if (!sameBinning[j] || !AddSameBinning(outHisto[j], h)) outHisto[j]->Add(h);
+                delete h;
+            }
+        }
+
+        // clean-up
+        if (obj) delete obj;
+
+        // release the file
+        ReleaseFile(i);
+
+    } // loop over files
+
+    // clean-up
+    delete [] seek;
+    delete [] order;
+    delete [] sameBinning;
+
+    // save I/O wait time
+    fPoolMutex->Lock();
+    fIOWait += ioWait;
+    fPoolMutex->UnLock();
+}
+
+//______________________________________________________________________________
+Bool_t TCFileManager::IsSameBinning(TH1* h1, TH1* h2)
+{
+    // Check if the histograms 'h1' and 'h2' are of the same type and have
+    // the same binning.
+
+    // check type
+    if (h1->IsA() != h2->IsA()) return kFALSE;
+
+    // check axes
+    TAxis* a1[3] = { h1->GetXaxis(), h1->GetYaxis(), h1->GetZaxis() };
+    TAxis* a2[3] = { h2->GetXaxis(), h2->GetYaxis(), h2->GetZaxis() };
+    for (Int_t i = 0; i < h1->GetDimension(); i++)
+    {
+        if (a1[i]->GetNbins() != a2[i]->GetNbins()) return kFALSE;
+        for (Int_t j = 1; j <= a1[i]->GetNbins() + 1; j++)
+            if (a1[i]->GetBinLowEdge(j) != a2[i]->GetBinLowEdge(j)) return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCFileManager::AddSameBinning(TH1* sum, TH1* h)
+{
+    // Add the histogram 'h' to the histogram 'sum' of the same type and 
+    // binning (see IsSameBinning()) by adding the raw bin content and
+    // Sumw2 arrays. Entries and statistics are merged directly.
+    // Return kFALSE if the fast summation is not possible (unsupported
+    // histogram type or different Sumw2 status). In this case 'sum' is
+    // not modified.
+
+    // profiles have additional bin arrays (entries, Sumw2 of the weights)
+    if (sum->InheritsFrom("TProfile") || sum->InheritsFrom("TProfile2D") || 
+        sum->InheritsFrom("TProfile3D")) return kFALSE;
+
+    // get the content arrays
+    TArrayD* sumD = dynamic_cast<TArrayD*>(sum);
+    TArrayD* hD = dynamic_cast<TArrayD*>(h);
+    TArrayF* sumF = dynamic_cast<TArrayF*>(sum);
+    TArrayF* hF = dynamic_cast<TArrayF*>(h);
+    if (!(sumD && hD) && !(sumF && hF)) return kFALSE;
+
+    // check array sizes
+    Int_t n = sumD ? sumD->GetSize() : sumF->GetSize();
+    if (n != (hD ? hD->GetSize() : hF->GetSize())) return kFALSE;
+    if (sum->GetSumw2N() != h->GetSumw2N()) return kFALSE;
+    if (sum->GetSumw2N() && sum->GetSumw2N() != n) return kFALSE;
+
+    // merge statistics
+    Double_t s1[TH1::kNstat];
+    Double_t s2[TH1::kNstat];
+    for (Int_t i = 0; i < TH1::kNstat; i++) s1[i] = s2[i] = 0;
+    sum->GetStats(s1);
+    h->GetStats(s2);
+    for (Int_t i = 0; i < TH1::kNstat; i++) s1[i] += s2[i];
+    Double_t entries = sum->GetEntries() + h->GetEntries();
+
+    // add contents and squared weights
+    if (sumD) AddArray(sumD->GetArray(), hD->GetArray(), n);
+    else AddArray(sumF->GetArray(), hF->GetArray(), n);
+    if (sum->GetSumw2N()) AddArray(sum->GetSumw2()->GetArray(), h->GetSumw2()->GetArray(), n);
+
+    // set statistics
+    sum->PutStats(s1);
+    sum->SetEntries(entries);
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+void* TCFileManager::SumWorker(void* arg)
+{
+    // Summation thread: sum the files of the subset defined by the
+    // task 'arg'.
+
+    TCFileManagerTask* task = (TCFileManagerTask*) arg;
+    task->fManager->SumFiles(task->fNName, task->fName, task->fSum,
+                             task->fFirst, task->fLast);
+
+    return 0;
+}
+
+//______________________________________________________________________________
+void* TCFileManager::ReduceWorker(void* arg)
+{
+    // Reduction thread: add the partial sums of the task 'arg' to its 
+    // main partial sums.
+    
+    TCFileManagerTask* task = (TCFileManagerTask*) arg;
+    for (Int_t i = 0; i < task->fNName; i++)
+    {
+        if (!task->fAdd[i]) continue;
+        if (task->fSum[i]) 
+        {
+            if (!IsSameBinning(task->fSum[i], task->fAdd[i]) ||
+                !AddSameBinning(task->fSum[i], task->fAdd[i])) task->fSum[i]->Add(task->fAdd[i]);
+            delete task->fAdd[i];
+        }
+        else task->fSum[i] = task->fAdd[i];
+        task->fAdd[i] = 0;
+    }
+
+    return 0;
+}
+
+//______________________________________________________________________________
+void TCFileManager::SumFilesParallel(Int_t n, const Char_t* const* names, TH1** outHisto)
+{
+    // Sum the 'n' histograms with the names 'names' of all files using 
+    // fNThreads threads and store the sums in 'outHisto'.
+    // Every thread sums a disjoint subset of the files and the partial sums 
+    // are reduced pairwise in a tree.
+    // NOTE: the histograms have to be destroyed by the caller.
+
+    // number of files and threads
+    Int_t nFiles = fFiles->GetEntriesFast();
+    Int_t nThreads = TMath::Min(fNThreads, nFiles);
+
+    // enable ROOT thread safety
+    TThread::Initialize();
+
+    // create summation tasks of the file subsets
+    TCFileManagerTask* task = new TCFileManagerTask[nThreads];
+    TThread** thread = new TThread*[nThreads];
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        task[i].fManager = this;
+        task[i].fNName = n;
+        task[i].fName = names;
+        task[i].fFirst = i * nFiles / nThreads;
+        task[i].fLast = (i+1) * nFiles / nThreads;
+        task[i].fSum = new TH1*[n];
+        task[i].fAdd = 0;
+        thread[i] = new TThread(TString::Format("TCFileManager_Sum_%d", i).Data(),
+                                SumWorker, (void*) &task[i]);
+        thread[i]->Run();
+    }
+    
+    // wait for the summation threads
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        thread[i]->Join();
+        delete thread[i];
+    }
+
+    // tree-reduce the partial sums
+    for (Int_t stride = 1; stride < nThreads; stride *= 2)
+    {
+        // start one reduction thread per pair of partial sums
+        Int_t nRed = 0;
+        for (Int_t i = 0; i + stride < nThreads; i += 2*stride)
+        {
+            task[i].fAdd = task[i+stride].fSum;
+            thread[nRed] = new TThread(TString::Format("TCFileManager_Reduce_%d", i).Data(),
+                                       ReduceWorker, (void*) &task[i]);
+            thread[nRed++]->Run();
+        }
+
+        // wait for the reduction threads
+        for (Int_t i = 0; i < nRed; i++)
+        {
+            thread[i]->Join();
+            delete thread[i];
+        }
+
+        // clean-up reduced partial sums
+        for (Int_t i = 0; i + stride < nThreads; i += 2*stride)
+        {
+            delete [] task[i+stride].fSum;
+            task[i+stride].fSum = 0;
+            task[i].fAdd = 0;
+        }
+    }
+
+    // copy final sums
+    for (Int_t i = 0; i < n; i++) outHisto[i] = task[0].fSum[i];
+    delete [] task[0].fSum;
+
+    // clean-up
+    delete [] task;
+    delete [] thread;
+}
+
+//______________________________________________________________________________
+void TCFileManager::FetchHistograms(Int_t n, const Char_t* const* names, 
+                                    const Char_t* const* keys, TH1** outHisto)
+{
+    // Get the 'n' summed-up histograms (or slices, if fSliceProj is set) 
+    // with the names 'names' and store them in 'outHisto'. The histograms
+    // are identified by 'keys' in the histogram cache. All histograms are 
+    // summed in a single pass over the input files. Elements of 'outHisto'
+    // are 0 for histograms that were not found.
+    // NOTE: the histograms have to be destroyed by the caller.
+
+    // init output
+    for (Int_t i = 0; i < n; i++) outHisto[i] = 0;
+
+    // check if there are some runs
+    if (!fFiles->GetEntriesFast())
+    {
+        Error("GetHistogram", "ROOT file list is empty!");
+        return;
+    }
+    
+    // do not keep histograms in memory
+    TH1::AddDirectory(kFALSE);
+
+    // try to load the histograms from the cache
+    if (fCacheDir != "") ReadCache(n, keys, outHisto);
+    Bool_t* cached = new Bool_t[n];
+    for (Int_t i = 0; i < n; i++) cached[i] = outHisto[i] ? kTRUE : kFALSE;
+
+    // try to sum the histograms using the histogram index
+    if (fIndex && fSliceProj == "")
+    {
+        Int_t nIndex = 0;
+        for (Int_t i = 0; i < n; i++)
+        {
+            if (outHisto[i]) continue;
+            outHisto[i] = fIndex->GetSum(names[i], fNRun, fRun);
+            if (outHisto[i]) nIndex++;
+        }
+        if (nIndex) Info("GetHistogram", "Summed %d histogram(s) using the histogram index", nIndex);
+    }
+
+    // collect the histograms that were not cached or indexed
+    Int_t nSum = 0;
+    const Char_t** sumNames = new const Char_t*[n];
+    const Char_t** sumKeys = new const Char_t*[n];
+    Int_t* sumIndex = new Int_t[n];
+    Double_t* sumMin = new Double_t[n];
+    Double_t* sumMax = new Double_t[n];
+    for (Int_t i = 0; i < n; i++)
+    {
+        if (outHisto[i]) continue;
+        sumNames[nSum] = names[i];
+        sumKeys[nSum] = keys[i];
+        if (fSliceProj != "")
+        {
+            sumMin[nSum] = fSliceMin[i];
+            sumMax[nSum] = fSliceMax[i];
+        }
+        sumIndex[nSum++] = i;
+    }
+
+    // sum up the files
+    if (nSum)
+    {
+        TStopwatch watch;
+        fIOWait = 0;
+        TH1** sum = new TH1*[nSum];
+
+        // the slice ranges have to follow the collected histograms
+        const Double_t* sliceMin = fSliceMin;
+        const Double_t* sliceMax = fSliceMax;
+        if (fSliceProj != "")
+        {
+            fSliceMin = sumMin;
+            fSliceMax = sumMax;
+        }
+
+        if (fNThreads > 1 && fFiles->GetEntriesFast() > 1) SumFilesParallel(nSum, sumNames, sum);
+        else SumFiles(nSum, sumNames, sum, 0, fFiles->GetEntriesFast());
+        for (Int_t i = 0; i < nSum; i++) outHisto[sumIndex[i]] = sum[i];
+        fSliceMin = sliceMin;
+        fSliceMax = sliceMax;
+        delete [] sum;
+        watch.Stop();
+
+        // user information
+        Info("GetHistogram", "Summed %d histogram(s) of %d files in %.2f s (I/O wait: %.2f s)",
+             nSum, fFiles->GetEntriesFast(), watch.RealTime(), fIOWait);
+    }
+
+    // save the new histograms in the cache
+    if (fCacheDir != "")
+    {
+        Int_t nNew = 0;
+        const Char_t** newKeys = new const Char_t*[n];
+        TH1** newHisto = new TH1*[n];
+        for (Int_t i = 0; i < n; i++)
+        {
+            if (cached[i] || !outHisto[i]) continue;
+            newKeys[nNew] = keys[i];
+            newHisto[nNew++] = outHisto[i];
+        }
+        if (nNew) WriteCache(nNew, newKeys, newHisto);
+        delete [] newKeys;
+        delete [] newHisto;
+    }
+
+    // clean-up
+    delete [] cached;
+    delete [] sumNames;
+    delete [] sumKeys;
+    delete [] sumIndex;
+    delete [] sumMin;
+    delete [] sumMax;
+}
+
+//______________________________________________________________________________
+void TCFileManager::GetHistograms(Int_t n, const Char_t* const* names, TH1** outHisto)
+{
+    // Get the 'n' summed-up histograms with the names 'names' and store them
+    // in 'outHisto'. All histograms are summed in a single pass over the 
+    // input files. Elements of 'outHisto' are 0 for histograms that were 
+    // not found.
+    // NOTE: the histograms have to be destroyed by the caller.
+
+    fSliceProj = "";
+
+    // check for packed element histograms
+    if (!fFamilies || !fFamilies->GetEntriesFast())
+    {
+        FetchHistograms(n, names, names, outHisto);
+        return;
+    }
+
+    // map the histograms to the packed families
+    Int_t* fam = new Int_t[n];
+    Int_t* bin = new Int_t[n];
+    TString* proj = new TString[n];
+    Char_t* axis = new Char_t[n];
+    for (Int_t i = 0; i < n; i++) fam[i] = FindFamily(names[i], &bin[i], &proj[i], &axis[i]);
+
+    // get the single histograms
+    Int_t nSingle = 0;
+    const Char_t** singleNames = new const Char_t*[n];
+    TH1** singleHisto = new TH1*[n];
+    Int_t* singleIndex = new Int_t[n];
+    for (Int_t i = 0; i < n; i++)
+    {
+        if (fam[i] != -1) continue;
+        singleNames[nSingle] = names[i];
+        singleIndex[nSingle++] = i;
+    }
+    if (nSingle)
+    {
+        FetchHistograms(nSingle, singleNames, singleNames, singleHisto);
+        for (Int_t i = 0; i < nSingle; i++) outHisto[singleIndex[i]] = singleHisto[i];
+    }
+
+    // unpack the element histograms family by family
+    const Char_t** elemNames = new const Char_t*[n];
+    Double_t* elemBin = new Double_t[n];
+    TH1** elemHisto = new TH1*[n];
+    Int_t* elemIndex = new Int_t[n];
+    for (Int_t f = 0; f < fFamilies->GetEntriesFast(); f++)
+    {
+        // collect the elements of this family
+        Int_t nElem = 0;
+        for (Int_t i = 0; i < n; i++)
+        {
+            if (fam[i] != f) continue;
+
+            // elements missing in the packed histogram
+            if (!bin[i])
+            {
+                Warning("GetHistogram", "Histogram '%s' was not found in the packed histogram '%s'",
+                        names[i], fFamilies->At(f)->GetName());
+                outHisto[i] = 0;
+                continue;
+            }
+
+            elemNames[nElem] = fFamilies->At(f)->GetName();
+            elemBin[nElem] = bin[i];
+            elemIndex[nElem++] = i;
+        }
+        if (!nElem) continue;
+
+        // get the slices of the packed histogram
+        Int_t first = elemIndex[0];
+        GetSlices(nElem, elemNames, elemHisto, proj[first].Data(), axis[first],
+                  elemBin, elemBin, kFALSE);
+        for (Int_t i = 0; i < nElem; i++)
+        {
+            if (elemHisto[i]) elemHisto[i]->SetName(names[elemIndex[i]]);
+            outHisto[elemIndex[i]] = elemHisto[i];
+        }
+    }
+
+    // clean-up
+    delete [] fam;
+    delete [] bin;
+    delete [] proj;
+    delete [] axis;
+    delete [] singleNames;
+    delete [] singleHisto;
+    delete [] singleIndex;
+    delete [] elemNames;
+    delete [] elemBin;
+    delete [] elemHisto;
+    delete [] elemIndex;
+}
+
+//______________________________________________________________________________
+void TCFileManager::GetSlices(Int_t n, const Char_t* const* names, TH1** outHisto,
+                              const Char_t* proj, Char_t axis, 
+                              const Double_t* min, const Double_t* max, Bool_t user)
+{
+    // Get the 'n' summed-up slices of the histograms with the names 'names'
+    // and store them in 'outHisto'. The slices are defined by the projection
+    // 'proj', the range axis 'axis' and the ranges 'min[i]' to 'max[i]' in 
+    // axis units ('user' = kTRUE) or bin numbers (see Slice()). 
+    // The histograms are projected in every input file before the summation
+    // so that the full histograms are never summed up in memory.
+    // Elements of 'outHisto' are 0 for histograms that were not found.
+    // NOTE: the histograms have to be destroyed by the caller.
+
+    // init output
+    for (Int_t i = 0; i < n; i++) outHisto[i] = 0;
+
+    // collect the histograms (projections of packed element histograms 
+    // are not supported)
+    Int_t nSlice = 0;
+    const Char_t** sliceNames = new const Char_t*[n];
+    Double_t* sliceMin = new Double_t[n];
+    Double_t* sliceMax = new Double_t[n];
+    Int_t* sliceIndex = new Int_t[n];
+    for (Int_t i = 0; i < n; i++)
+    {
+        if (fFamilies)
+        {
+            Int_t bin;
+            TString p;
+            Char_t a;
+            if (FindFamily(names[i], &bin, &p, &a) != -1)
+            {
+                Error("GetSlice", "Slices of packed element histogram '%s' are not supported!", names[i]);
+                continue;
+            }
+        }
+        sliceNames[nSlice] = names[i];
+        sliceMin[nSlice] = min[i];
+        sliceMax[nSlice] = max[i];
+        sliceIndex[nSlice++] = i;
+    }
+    if (!nSlice)
+    {
+        delete [] sliceNames;
+        delete [] sliceMin;
+        delete [] sliceMax;
+        delete [] sliceIndex;
+        return;
+    }
+
+    // set the slice definition
+    fSliceProj = proj;
+    fSliceAxis = axis;
+    fSliceUser = user;
+    fSliceMin = sliceMin;
+    fSliceMax = sliceMax;
+
+    // create the cache keys
+    TString* key = new TString[nSlice];
+    const Char_t** keys = new const Char_t*[nSlice];
+    for (Int_t i = 0; i < nSlice; i++)
+    {
+        key[i] = TString::Format("%s__%s_%c_%g_%g_%s", sliceNames[i], proj, axis ? axis : '0',
+                                 sliceMin[i], sliceMax[i], user ? "u" : "b");
+        keys[i] = key[i].Data();
+    }
+
+    // get the slices
+    TH1** slice = new TH1*[nSlice];
+    FetchHistograms(nSlice, sliceNames, keys, slice);
+    for (Int_t i = 0; i < nSlice; i++) outHisto[sliceIndex[i]] = slice[i];
+
+    // clean-up
+    delete [] sliceNames;
+    delete [] sliceMin;
+    delete [] sliceMax;
+    delete [] sliceIndex;
+    delete [] key;
+    delete [] keys;
+    delete [] slice;
+    fSliceProj = "";
+    fSliceMin = 0;
+    fSliceMax = 0;
+}
+
+//______________________________________________________________________________
+TH1* TCFileManager::GetSlice(const Char_t* name, const Char_t* proj, Char_t axis, 
+                             Double_t min, Double_t max, Bool_t user)
+{
+    // Get the summed-up slice of the histogram 'name' defined by the 
+    // projection 'proj', the range axis 'axis' and the range 'min' to 'max'
+    // (see Slice()), e.g. 
+    //   GetSlice("CaLib_CB_IM", "x", 'y', 5, 5, kFALSE)
+    // returns the 5th row of the 2D histogram "CaLib_CB_IM".
+    // NOTE: the histogram has to be destroyed by the caller.
+
+    TH1* hOut;
+    GetSlices(1, &name, &hOut, proj, axis, &min, &max, user);
+
+    return hOut;
+}
+
+//______________________________________________________________________________
+TH1* TCFileManager::Slice(TH1* h, Int_t i)
+{
+    // Return the slice of the histogram 'h' defined by fSliceProj, fSliceAxis
+    // and the range with index 'i'. 
+    // The projection lists the axes of the slice: "x" or "y" is a row or 
+    // column of a 2D histogram, "x", "yx", "zy", etc. are the 1D or 2D 
+    // projections of a 3D histogram (using the convention of 
+    // TH3::Project3D()) and "xyz" is a sub-volume of a 3D histogram.
+    // The range restricts the axis fSliceAxis (default: the first axis not
+    // contained in the projection), all other axes that are not contained in
+    // the projection are integrated over all bins including under- and 
+    // overflow. A range with min > max selects all bins.
+    // Return 0 if the slice is not valid for this histogram.
+    // NOTE: the histogram has to be destroyed by the caller.
+    
+    // histogram axes
+    Int_t dim = h->GetDimension();
+    TAxis* axis[3] = { h->GetXaxis(), h->GetYaxis(), h->GetZaxis() };
+    Int_t nTot[3] = { 1, 1, 1 };
+    for (Int_t k = 0; k < dim; k++) nTot[k] = axis[k]->GetNbins() + 2;
+    
+    // map the slice axes to the histogram axes
+    Int_t nProj = fSliceProj.Length();
+    Bool_t sub = nProj == dim;
+    Int_t out[3];
+    Bool_t valid = nProj >= 1 && nProj <= dim && dim > 1;
+    for (Int_t k = 0; valid && k < nProj; k++) 
+    {
+        out[k] = (nProj == 2 && !sub) ? fSliceProj[1-k] - 'x' : fSliceProj[k] - 'x';
+        if (out[k] < 0 || out[k] >= dim || (sub && out[k] != k)) valid = kFALSE;
+        for (Int_t l = 0; l < k; l++) if (out[l] == out[k]) valid = kFALSE;
+    }
+
+    // get the range axis
+    Int_t ra = fSliceAxis ? fSliceAxis - 'x' : -1;
+    if (valid && !fSliceAxis && !sub)
+    {
+        for (Int_t k = 0; k < dim && ra == -1; k++)
+        {
+            ra = k;
+            for (Int_t l = 0; l < nProj; l++) if (out[l] == k) ra = -1;
+        }
+    }
+    if (ra < -1 || ra >= dim) valid = kFALSE;
+
+    // check the slice
+    if (!valid)
+    {
+        Error("GetSlice", "Invalid slice '%s' of histogram '%s'!", fSliceProj.Data(), h->GetName());
+        return 0;
+    }
+
+    // get the range bins
+    Int_t rFirst = 0;
+    Int_t rLast = -1;
+    if (ra != -1)
+    {
+        rLast = nTot[ra] - 1;
+        if (fSliceMin[i] <= fSliceMax[i])
+        {
+            if (fSliceUser)
+            {
+                rFirst = axis[ra]->FindBin(fSliceMin[i]);
+                rLast = axis[ra]->FindBin(fSliceMax[i]);
+            }
+            else
+            {
+                rFirst = (Int_t) fSliceMin[i];
+                rLast = (Int_t) fSliceMax[i];
+            }
+        }
+        
+        // sub-volumes can only be cut to the normal bins
+        Int_t minBin = sub ? 1 : 0;
+        if (rFirst < minBin) rFirst = minBin;
+        if (rLast > nTot[ra] - 1 - minBin) rLast = nTot[ra] - 1 - minBin;
+    }
+
+    // get the bin edges of the slice
+    Int_t nBin[3];
+    Int_t offset[3];
+    Double_t* edge[3];
+    for (Int_t k = 0; k < nProj; k++)
+    {
+        Int_t a = out[k];
+        nBin[k] = (sub && a == ra) ? rLast - rFirst + 1 : axis[a]->GetNbins();
+        offset[k] = (sub && a == ra) ? rFirst - 1 : 0;
+        if (nBin[k] < 1) nBin[k] = 1;
+        edge[k] = new Double_t[nBin[k]+1];
+        for (Int_t b = 0; b <= nBin[k]; b++) edge[k][b] = axis[a]->GetBinLowEdge(offset[k] + b + 1);
+    }
+
+    // create the slice
+    TString name = TString::Format("%s_%s", h->GetName(), fSliceProj.Data());
+    TH1* hOut;
+    if (nProj == 1) hOut = new TH1D(name.Data(), h->GetTitle(), nBin[0], edge[0]);
+    else if (nProj == 2) hOut = new TH2D(name.Data(), h->GetTitle(), nBin[0], edge[0], nBin[1], edge[1]);
+    else hOut = new TH3D(name.Data(), h->GetTitle(), nBin[0], edge[0], nBin[1], edge[1], nBin[2], edge[2]);
+    hOut->Sumw2();
+    for (Int_t k = 0; k < nProj; k++) delete [] edge[k];
+
+    // set axis titles
+    TAxis* axisOut[3] = { hOut->GetXaxis(), hOut->GetYaxis(), hOut->GetZaxis() };
+    for (Int_t k = 0; k < nProj; k++) axisOut[k]->SetTitle(axis[out[k]]->GetTitle());
+
+    // fill the slice
+    Double_t* sumw2 = hOut->GetSumw2()->GetArray();
+    Double_t entries = 0;
+    Int_t b[3];
+    for (b[2] = 0; b[2] < nTot[2]; b[2]++)
+    {
+        for (b[1] = 0; b[1] < nTot[1]; b[1]++)
+        {
+            for (b[0] = 0; b[0] < nTot[0]; b[0]++)
+            {
+                // check range
+                if (ra != -1 && (b[ra] < rFirst || b[ra] > rLast)) continue;
+                
+                // get content
+                Int_t bin = h->GetBin(b[0], b[1], b[2]);
+                Double_t c = h->GetBinContent(bin);
+                Double_t e = h->GetBinError(bin);
+                if (c == 0 && e == 0) continue;
+
+                // add to the slice
+                Int_t t[3] = { 0, 0, 0 };
+                for (Int_t k = 0; k < nProj; k++) t[k] = b[out[k]] - offset[k];
+                Int_t binOut = hOut->GetBin(t[0], t[1], t[2]);
+                hOut->AddBinContent(binOut, c);
+                sumw2[binOut] += e*e;
+                entries += c;
+            }
+        }
+    }
+    hOut->SetEntries(entries);
+
+    return hOut;
+}
+
+//______________________________________________________________________________
+TH1* TCFileManager::GetHistogram(const Char_t* name)
+{
+    // Get the summed-up histogram with name 'name'.
+    // NOTE: the histogram has to be destroyed by the caller.
+
+    TH1* hOut;
+    GetHistograms(1, &name, &hOut);
+
+    return hOut;
+}
+
+//______________________________________________________________________________
+void TCFileManager::SetElementHistograms(Int_t n, const Char_t* pattern, const Int_t* index)
+{
+    // Register the histograms of 'n' detector elements for the fetching
+    // via GetElementHistogram(). The histogram name of element i is created
+    // using the format 'pattern' and i or, if 'index' is non-zero, index[i],
+    // e.g. pattern = "ADC%d".
+
+    // clean-up old histograms
+    if (fElemName) delete [] fElemName;
+    if (fElemHisto)
+    {
+        for (Int_t i = 0; i < fNElem; i++) 
+            if (fElemHisto[i]) delete fElemHisto[i];
+        delete [] fElemHisto;
+    }
+    if (fElemMin) delete [] fElemMin;
+    if (fElemMax) delete [] fElemMax;
+
+    // set names
+    fNElem = n;
+    fElemName = new TString[fNElem];
+    fElemHisto = new TH1*[fNElem];
+    fElemMin = new Double_t[fNElem];
+    fElemMax = new Double_t[fNElem];
+    for (Int_t i = 0; i < fNElem; i++)
+    {
+        fElemName[i] = TString::Format(pattern, index ? index[i] : i);
+        fElemHisto[i] = 0;
+        fElemMin[i] = 0;
+        fElemMax[i] = -1;
+    }
+
+    // no projection by default
+    fElemProj = "";
+    fElemAxis = 0;
+    fElemUser = kTRUE;
+}
+
+//______________________________________________________________________________
+void TCFileManager::SetElementProjection(const Char_t* proj, Char_t axis, 
+                                         Double_t min, Double_t max)
+{
+    // Fetch the slices defined by the projection 'proj', the axis 'axis' and
+    // the range 'min' to 'max' in axis units instead of the full element 
+    // histograms registered via SetElementHistograms(). 
+    // See Slice() for the definition of the slices.
+
+    fElemProj = proj ? proj : "";
+    fElemAxis = axis;
+    fElemUser = kTRUE;
+    for (Int_t i = 0; i < fNElem; i++)
+    {
+        fElemMin[i] = min;
+        fElemMax[i] = max;
+    }
+}
+
+//______________________________________________________________________________
+void TCFileManager::SetElementSlices(Int_t n, const Char_t* name, const Char_t* proj)
+{
+    // Register the rows (proj = "x") or columns (proj = "y") of the 2D 
+    // histogram 'name' as histograms of 'n' detector elements for the 
+    // fetching via GetElementHistogram(). The histogram of element i is the
+    // projection of the bin i+1 of the other axis.
+
+    // register the histograms
+    SetElementHistograms(n, name);
+    for (Int_t i = 0; i < fNElem; i++)
+    {
+        fElemName[i] = name;
+        fElemMin[i] = i+1;
+        fElemMax[i] = i+1;
+    }
+
+    // set projection
+    fElemProj = proj ? proj : "";
+    fElemAxis = 0;
+    fElemUser = kFALSE;
+}
+
+//______________________________________________________________________________
+TH1* TCFileManager::GetElementHistogram(Int_t elem)
+{
+    // Get the summed-up histogram of the element 'elem' registered via
+    // SetElementHistograms(). If the histogram was not fetched before, the
+    // histograms of the block of fBlockSize elements starting at 'elem' 
+    // are summed in a single pass over the input files (all remaining 
+    // elements if fBlockSize is 0).
+    // NOTE: the histogram has to be destroyed by the caller.
+
+    // check element
+    if (elem < 0 || elem >= fNElem)
+    {
+        Error("GetElementHistogram", "Element %d is out of range!", elem);
+        return 0;
+    }
+
+    // fetch the block ahead of the element
+    if (!fElemHisto[elem])
+    {
+        // get block range (stop at already fetched elements)
+        Int_t last = fBlockSize > 0 ? TMath::Min(elem + fBlockSize, fNElem) : fNElem;
+        Int_t n = 1;
+        while (elem + n < last && !fElemHisto[elem+n]) n++;
+
+        // get histograms or slices
+        const Char_t** names = new const Char_t*[n];
+        for (Int_t i = 0; i < n; i++) names[i] = fElemName[elem+i].Data();
+        if (fElemProj != "") GetSlices(n, names, fElemHisto + elem, fElemProj.Data(), fElemAxis,
+                                       fElemMin + elem, fElemMax + elem, fElemUser);
+        else GetHistograms(n, names, fElemHisto + elem);
+        delete [] names;
+    }
+
+    // hand over histogram to caller
+    TH1* h = fElemHisto[elem];
+    fElemHisto[elem] = 0;
+
+    return h;
 }
 
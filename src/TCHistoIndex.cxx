@@ -0,0 +1,470 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCHistoIndex                                                         //
+//                                                                      //
+// Cumulative histogram index over runs.                                //
+//                                                                      //
+// The index file contains the cumulative sums C(p) of the histograms   //
+// over the first p runs (in ascending run order) for every p that is a //
+// multiple of the checkpoint step k and for p = total number of runs.  //
+// The sum over the runs with the positions a to b is then              //
+// C(b+1) - C(a), where C(p) at a position between two checkpoints is   //
+// obtained from the nearest checkpoint and at most k/2 single runs.    //
+// The cumulants have the class of the indexed histograms and are       //
+// combined bin by bin (contents and Sumw2 if present).                 //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TCHistoIndex.h"
+
+ClassImp(TCHistoIndex)
+
+
+//______________________________________________________________________________
+TCHistoIndex::TCHistoIndex(const Char_t* filename)
+{
+    // Constructor using the index file 'filename'.
+
+    // init members
+    fFileName = filename;
+    fFile = 0;
+    fPattern = "";
+    fStep = 0;
+    fNRun = 0;
+    fRun = 0;
+    fStat = 0;
+
+    // open the index file
+    if (gSystem->AccessPathName(filename)) return;
+    fFile = TFile::Open(filename);
+    if (!fFile) return;
+    if (fFile->IsZombie())
+    {
+        Error("TCHistoIndex", "Could not open histogram index '%s'", filename);
+        delete fFile;
+        fFile = 0;
+        return;
+    }
+
+    // read the index information
+    TNamed* pattern = (TNamed*) fFile->Get("Pattern");
+    TNamed* step = (TNamed*) fFile->Get("Step");
+    TObjArray* runs = (TObjArray*) fFile->Get("Runs");
+    if (!pattern || !step || !runs)
+    {
+        Error("TCHistoIndex", "Histogram index '%s' is incomplete!", filename);
+        if (pattern) delete pattern;
+        if (step) delete step;
+        if (runs) delete runs;
+        delete fFile;
+        fFile = 0;
+        return;
+    }
+    fPattern = pattern->GetTitle();
+    fStep = atoi(step->GetTitle());
+    fNRun = runs->GetEntriesFast();
+    fRun = new Int_t[fNRun];
+    fStat = new TString[fNRun];
+    for (Int_t i = 0; i < fNRun; i++)
+    {
+        TNamed* r = (TNamed*) runs->At(i);
+        fRun[i] = atoi(r->GetName());
+        fStat[i] = r->GetTitle();
+    }
+
+    // clean-up
+    runs->SetOwner(kTRUE);
+    delete runs;
+    delete pattern;
+    delete step;
+
+    // user information
+    Info("TCHistoIndex", "Opened histogram index '%s' (%d runs, checkpoint step %d)",
+         filename, fNRun, fStep);
+}
+
+//______________________________________________________________________________
+TCHistoIndex::~TCHistoIndex()
+{
+    // Destructor.
+
+    if (fFile) delete fFile;
+    if (fRun) delete [] fRun;
+    if (fStat) delete [] fStat;
+}
+
+//______________________________________________________________________________
+TString TCHistoIndex::GetFileStat(const Char_t* filename)
+{
+    // Return the status of the file 'filename' (size and modification time)
+    // or "-" if the file does not exist.
+
+    FileStat_t fileinfo;
+    if (gSystem->GetPathInfo(filename, fileinfo)) return TString("-");
+    else return TString::Format("%lld:%ld", fileinfo.fSize, fileinfo.fMtime);
+}
+
+//______________________________________________________________________________
+Int_t TCHistoIndex::FindRun(Int_t run) const
+{
+    // Return the position of the run 'run' in the index or -1 if the run
+    // is not indexed.
+
+    Long64_t pos = TMath::BinarySearch((Long64_t)fNRun, fRun, run);
+    if (pos >= 0 && fRun[pos] == run) return (Int_t) pos;
+    else return -1;
+}
+
+//______________________________________________________________________________
+Bool_t TCHistoIndex::CheckRuns(Int_t first, Int_t last)
+{
+    // Check if the files of the runs with the positions 'first' to 'last'
+    // (exclusive) were not changed since the index was built.
+
+    for (Int_t i = first; i < last; i++)
+    {
+        TString filename(fPattern);
+        filename.ReplaceAll("RUN", TString::Format("%d", fRun[i]));
+        if (GetFileStat(filename.Data()) != fStat[i])
+        {
+            Warning("GetSum", "File of run %d changed since the histogram index was built",
+                    fRun[i]);
+            return kFALSE;
+        }
+    }
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+TH1* TCHistoIndex::CreateSum(TH1* h, const Char_t* name)
+{
+    // Return an empty histogram named 'name' of the same class and binning
+    // as 'h'. The squared errors are stored only if 'h' stores them.
+
+    // clone and reset the histogram
+    TH1* hOut = (TH1*) h->Clone(name);
+    hOut->SetDirectory(0);
+    hOut->Reset();
+
+    return hOut;
+}
+
+//______________________________________________________________________________
+Bool_t TCHistoIndex::AddRaw(TH1* sum, TH1* h, Double_t sign)
+{
+    // Add the histogram 'h' multiplied by 'sign' to the histogram 'sum' bin
+    // by bin. If 'sum' stores the squared errors they are added with the same
+    // sign so that subtracting a previously added histogram restores the
+    // original contents and errors (up to the precision of 'sum').
+    // Return kFALSE if the binning of the histograms differs.
+
+    // check binning
+    if (sum->GetDimension() != h->GetDimension() ||
+        sum->GetNbinsX() != h->GetNbinsX() ||
+        sum->GetNbinsY() != h->GetNbinsY() ||
+        sum->GetNbinsZ() != h->GetNbinsZ())
+    {
+        Error("AddRaw", "Histogram '%s' has a different binning!", h->GetName());
+        return kFALSE;
+    }
+
+    // get the arrays
+    TArray* sa = dynamic_cast<TArray*>(sum);
+    TArrayD* sd = dynamic_cast<TArrayD*>(sum);
+    Double_t* s = sd ? sd->GetArray() : 0;
+    Double_t* sw2 = sum->GetSumw2N() ? sum->GetSumw2()->GetArray() : 0;
+    Int_t n = sa->GetSize();
+    TArrayD* hd = dynamic_cast<TArrayD*>(h);
+    const Double_t* hc = hd ? hd->GetArray() : 0;
+    const Double_t* hw2 = h->GetSumw2N() ? h->GetSumw2()->GetArray() : 0;
+
+    // add the bins
+    for (Int_t i = 0; i < n; i++)
+    {
+        Double_t c = hc ? hc[i] : h->GetBinContent(i);
+        if (s) s[i] += sign * c;
+        else sa->SetAt(sa->GetAt(i) + sign * c, i);
+        if (sw2) sw2[i] += sign * (hw2 ? hw2[i] : TMath::Abs(c));
+    }
+    sum->SetEntries(sum->GetEntries() + sign * h->GetEntries());
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCHistoIndex::AddRun(TH1* sum, const Char_t* name, Int_t pos, Double_t sign)
+{
+    // Add the histogram 'name' of the run with the position 'pos' multiplied
+    // by 'sign' to the cumulant 'sum'.
+    // Return kFALSE if the histogram could not be added.
+
+    // skip missing files
+    if (fStat[pos] == "-") return kTRUE;
+
+    // open the file
+    TString filename(fPattern);
+    filename.ReplaceAll("RUN", TString::Format("%d", fRun[pos]));
+    TFile* f = TFile::Open(filename.Data());
+    if (!f) return kTRUE;
+    if (f->IsZombie())
+    {
+        delete f;
+        return kTRUE;
+    }
+
+    // add the histogram
+    Bool_t ret = kTRUE;
+    TObject* obj = f->Get(name);
+    if (obj)
+    {
+        obj->ResetBit(kMustCleanup);
+        if (obj->InheritsFrom("TH1")) ret = AddRaw(sum, (TH1*) obj, sign);
+        delete obj;
+    }
+
+    // clean-up
+    delete f;
+
+    return ret;
+}
+
+//______________________________________________________________________________
+TH1* TCHistoIndex::GetCumulant(const Char_t* name, Int_t pos)
+{
+    // Return the sum of the histograms 'name' of the runs with the positions
+    // 0 to 'pos' (exclusive) using the nearest checkpoint.
+    // Return 0 if the histogram is not indexed or if the files of the
+    // needed runs were changed.
+    // NOTE: the histogram has to be destroyed by the caller.
+
+    // get nearest checkpoint
+    Int_t lo = (pos / fStep) * fStep;
+    Int_t hi = TMath::Min(lo + fStep, fNRun);
+    Int_t cp = (pos - lo <= hi - pos) ? lo : hi;
+
+    // check the files of the single runs
+    if (!CheckRuns(TMath::Min(cp, pos), TMath::Max(cp, pos))) return 0;
+
+    // load the checkpoint (the first checkpoint is used as template for
+    // the empty checkpoint 0)
+    Int_t cpLoad = cp ? cp : TMath::Min(fStep, fNRun);
+    TH1* h = (TH1*) fFile->Get(TString::Format("%s_Cum_%d", name, cpLoad).Data());
+    if (!h) return 0;
+    h->ResetBit(kMustCleanup);
+    h->SetName(name);
+    if (!cp) h->Reset();
+
+    // add or subtract the single runs
+    Bool_t ret = kTRUE;
+    for (Int_t i = cp; i < pos && ret; i++) ret = AddRun(h, name, i, 1);
+    for (Int_t i = pos; i < cp && ret; i++) ret = AddRun(h, name, i, -1);
+    if (!ret)
+    {
+        delete h;
+        return 0;
+    }
+
+    return h;
+}
+
+//______________________________________________________________________________
+TH1* TCHistoIndex::GetSum(const Char_t* name, Int_t nRun, const Int_t* runs)
+{
+    // Return the sum of the histograms 'name' of the 'nRun' runs 'runs'.
+    // Every contiguous range of indexed runs is summed as the difference of
+    // two cumulants.
+    // Return 0 if the sum cannot be calculated using the index, i.e. if the
+    // histogram or one of the runs is not indexed or if the files of the
+    // runs changed.
+    // NOTE: the histogram has to be destroyed by the caller.
+
+    // check index
+    if (!IsValid() || nRun <= 0) return 0;
+
+    // get the sorted run positions
+    Int_t* pos = new Int_t[nRun];
+    Int_t* order = new Int_t[nRun];
+    Bool_t ok = kTRUE;
+    for (Int_t i = 0; i < nRun; i++)
+    {
+        pos[i] = FindRun(runs[i]);
+        if (pos[i] < 0) ok = kFALSE;
+    }
+    TMath::Sort(nRun, pos, order, kFALSE);
+
+    // loop over the contiguous ranges
+    TH1* sum = 0;
+    Int_t i = 0;
+    while (ok && i < nRun)
+    {
+        // get range
+        Int_t first = pos[order[i]];
+        Int_t last = first;
+        while (i+1 < nRun && pos[order[i+1]] == last+1)
+        {
+            last++;
+            i++;
+        }
+        i++;
+
+        // check for runs used twice and the files of the range
+        if ((i < nRun && pos[order[i]] == last) || !CheckRuns(first, last+1))
+        {
+            ok = kFALSE;
+            break;
+        }
+
+        // calculate the sum of the range
+        TH1* hHi = GetCumulant(name, last+1);
+        TH1* hLo = hHi ? GetCumulant(name, first) : 0;
+        Bool_t ret = hLo && AddRaw(hHi, hLo, -1);
+        if (ret)
+        {
+            if (!sum) sum = hHi;
+            else
+            {
+                ret = AddRaw(sum, hHi, 1);
+                delete hHi;
+            }
+        }
+        else if (hHi) delete hHi;
+        if (hLo) delete hLo;
+
+        // check result
+        if (!ret) ok = kFALSE;
+    }
+
+    // clean-up
+    delete [] pos;
+    delete [] order;
+    if (!ok && sum)
+    {
+        delete sum;
+        sum = 0;
+    }
+
+    return sum;
+}
+
+//______________________________________________________________________________
+Bool_t TCHistoIndex::Build(const Char_t* filename, const Char_t* pattern,
+                           Int_t nRun, const Int_t* runs,
+                           Int_t nName, const Char_t* const* names, Int_t step)
+{
+    // Build the histogram index 'filename' containing the cumulants of the
+    // 'nName' histograms 'names' over the 'nRun' runs 'runs' with a
+    // checkpoint every 'step' runs. The file names of the runs are created
+    // by replacing RUN in the input file pattern 'pattern'.
+    // Return kTRUE on success.
+
+    // check arguments
+    if (nRun <= 0 || step <= 0)
+    {
+        Error("Build", "Invalid number of runs (%d) or checkpoint step (%d)!", nRun, step);
+        return kFALSE;
+    }
+
+    // create the index file
+    TFile* fout = new TFile(filename, "RECREATE");
+    if (fout->IsZombie())
+    {
+        Error("Build", "Could not create histogram index '%s'", filename);
+        delete fout;
+        return kFALSE;
+    }
+
+    // sort the runs
+    Int_t* order = new Int_t[nRun];
+    TMath::Sort(nRun, runs, order, kFALSE);
+
+    // do not keep histograms in memory
+    TH1::AddDirectory(kFALSE);
+
+    // init cumulants
+    TH1** sum = new TH1*[nName > 0 ? nName : 1];
+    for (Int_t j = 0; j < nName; j++) sum[j] = 0;
+    TObjArray runList;
+    runList.SetOwner(kTRUE);
+
+    // loop over runs
+    Bool_t ret = kTRUE;
+    for (Int_t i = 0; i < nRun; i++)
+    {
+        Int_t run = runs[order[i]];
+
+        // check for runs used twice
+        if (i && runs[order[i-1]] == run)
+        {
+            Error("Build", "Run %d was given twice!", run);
+            ret = kFALSE;
+            break;
+        }
+
+        // construct file name and save file status
+        TString fname(pattern);
+        fname.ReplaceAll("RUN", TString::Format("%d", run));
+        TString stat = GetFileStat(fname.Data());
+        runList.Add(new TNamed(TString::Format("%d", run).Data(), stat.Data()));
+
+        // add the histograms of the file
+        if (stat != "-")
+        {
+            TFile* f = TFile::Open(fname.Data());
+            if (f && !f->IsZombie())
+            {
+                for (Int_t j = 0; j < nName; j++)
+                {
+                    TObject* obj = f->Get(names[j]);
+                    if (!obj) continue;
+                    obj->ResetBit(kMustCleanup);
+                    if (obj->InheritsFrom("TH1"))
+                    {
+                        if (!sum[j]) sum[j] = CreateSum((TH1*) obj, names[j]);
+                        if (!AddRaw(sum[j], (TH1*) obj, 1)) ret = kFALSE;
+                    }
+                    delete obj;
+                }
+            }
+            else Warning("Build", "Could not open file '%s'", fname.Data());
+            if (f) delete f;
+        }
+
+        // write the checkpoint
+        if ((i+1) % step == 0 || i+1 == nRun)
+        {
+            for (Int_t j = 0; j < nName; j++)
+            {
+                if (sum[j]) fout->WriteTObject(sum[j], TString::Format("%s_Cum_%d", names[j], i+1).Data());
+            }
+
+            // user information
+            Info("Build", "Wrote checkpoint after run %d (%d of %d)", run, i+1, nRun);
+        }
+    }
+
+    // write the index information
+    if (ret)
+    {
+        TNamed infoPattern("Pattern", pattern);
+        TNamed infoStep("Step", TString::Format("%d", step).Data());
+        fout->WriteTObject(&infoPattern);
+        fout->WriteTObject(&infoStep);
+        fout->WriteTObject(&runList, "Runs");
+    }
+    else Error("Build", "Histogram index '%s' is not valid!", filename);
+
+    // clean-up
+    for (Int_t j = 0; j < nName; j++) if (sum[j]) delete sum[j];
+    delete [] sum;
+    delete [] order;
+    delete fout;
+
+    return ret;
+}
+
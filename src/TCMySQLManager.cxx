@@ -11,6 +11,9 @@
 //////////////////////////////////////////////////////////////////////////
 
 
+#include <ctime>
+#include <cstdlib>
+
 #include "TCMySQLManager.h"
 
 ClassImp(TCMySQLManager)
@@ -20,17 +23,125 @@ ClassImp(TCMySQLManager)
 TCMySQLManager* TCMySQLManager::fgMySQLManager = 0;
 
 
+// types of the parallel database tasks
+enum EDBTask
+{
+    kTaskDump,
+    kTaskClone,
+    kTaskImport,
+    kTaskAdd
+};
+
+
+// argument of the parallel database tasks (one task per calibration data)
+struct TCMySQLManagerTask
+{
+    const Char_t* fCalibration;             // calibration identifier
+    const Char_t* fNewCalibration;          // new calibration identifier
+    const Char_t* fDesc;                    // set description
+    Int_t fFirstRun;                        // first run of the sets
+    Int_t fLastRun;                         // last run of the sets
+    const Char_t** fData;                   // calibration data of the tasks
+    TCContainer** fContainer;               // containers of the tasks
+    Double_t** fPar;                        // parameters of the tasks
+    Int_t* fLength;                         // number of parameters of the tasks
+    Int_t* fResult;                         // results of the tasks
+};
+
+
+// argument of the parallel database worker threads
+struct TCMySQLManagerWorker
+{
+    TCMySQLManager* fManager;               // database manager
+    Int_t fType;                            // task type
+    Int_t fNTask;                           // number of tasks
+    void* fArg;                             // task argument
+    Int_t fNext;                            // next task to run
+    Int_t fNOK;                             // number of successful tasks
+    TMutex* fMutex;                         // task counter mutex
+    Bool_t fTransaction;                    // run the tasks in transactions
+    Int_t fNThread;                         // number of worker threads
+    Int_t fNDone;                           // number of threads done with their tasks
+    Bool_t fFailed;                         // a transaction failed
+    Int_t fNCommit;                         // number of committed transactions
+    TCondition* fDone;                      // signal of threads done with their tasks
+};
+
+
+//______________________________________________________________________________
+static const Char_t* GetField(TSQLRow* row, Int_t i)
+{
+    // Return the field 'i' of the row 'row' or an empty string if the field
+    // is NULL.
+
+    const Char_t* f = row->GetField(i);
+    return f ? f : "";
+}
+
+//______________________________________________________________________________
+static TString GetModifiedTable(const Char_t* query)
+{
+    // Return the name of the table modified by the query 'query' or an empty
+    // string if the query is not an UPDATE, INSERT, REPLACE or DELETE query.
+
+    TString table;
+
+    // split the query
+    TObjArray* tok = TString(query).Tokenize(" \t\n(");
+    Int_t n = tok->GetEntriesFast();
+    TString first = n > 0 ? ((TObjString*) tok->At(0))->GetString() : "";
+    TString second = n > 1 ? ((TObjString*) tok->At(1))->GetString() : "";
+    
+    // find the table name
+    if (!first.CompareTo("UPDATE", TString::kIgnoreCase) && n > 1) 
+        table = second;
+    else if ((!first.CompareTo("INSERT", TString::kIgnoreCase) ||
+              !first.CompareTo("REPLACE", TString::kIgnoreCase)) && n > 2 &&
+              !second.CompareTo("INTO", TString::kIgnoreCase))
+        table = ((TObjString*) tok->At(2))->GetString();
+    else if (!first.CompareTo("DELETE", TString::kIgnoreCase) && n > 2 &&
+             !second.CompareTo("FROM", TString::kIgnoreCase))
+        table = ((TObjString*) tok->At(2))->GetString();
+
+    // clean-up
+    delete tok;
+
+    return table;
+}
+
 //______________________________________________________________________________
 TCMySQLManager::TCMySQLManager()
 {
     // Constructor.
 
     fDB = 0;
+    fBackend = 0;
     fSilence = kFALSE;
     fData = new THashList();
     fData->SetOwner(kTRUE);
     fTypes = new THashList();
     fTypes->SetOwner(kTRUE);
+    fSetTables = new THashList();
+    fSetTables->SetOwner(kTRUE);
+    fStatements = new THashList();
+    fStatements->SetOwner(kTRUE);
+    fTableLayouts = new THashList();
+    fTableLayouts->SetOwner(kTRUE);
+    fParCache = new TCParameterCache();
+    fParents = 0;
+    fParentsTime = 0;
+    fParCacheFile = "";
+    fRevalidate = 60;
+    fCacheTrust = 0;
+    fInsertChunk = 500;
+    fQueryStats = new TCQueryStats();
+    fSlowQuery = 0;
+    fNConn = 4;
+    fConn = 0;
+    fConnOwner = 0;
+    fMutex = new TMutex(kTRUE);
+    fPoolMutex = new TMutex();
+    fConnFree = new TCondition(fPoolMutex);
 
     // read CaLib data
     if (!ReadCaLibData())
@@ -47,13 +158,19 @@ TCMySQLManager::TCMySQLManager()
     }
 
     // get database configuration
-    TString* strDBHost;
+    TString strDBBackend("mysql");
+    TString* strDBHost = 0;
     TString* strDBName;
-    TString* strDBUser;
-    TString* strDBPass;
+    TString* strDBUser = 0;
+    TString* strDBPass = 0;
+
+    // get database backend
+    if (TString* b = TCReadConfig::GetReader()->GetConfig("DB.Backend")) strDBBackend = *b;
+    strDBBackend.ToLower();
+    Bool_t server = strDBBackend == "mysql";
 
     // get database hostname
-    if (!(strDBHost = TCReadConfig::GetReader()->GetConfig("DB.Host")))
+    if (server && !(strDBHost = TCReadConfig::GetReader()->GetConfig("DB.Host")))
     {
         if (!fSilence) Error("TCMySQLManager", "Database host not included in configuration file!");
         return;
@@ -67,39 +184,84 @@ TCMySQLManager::TCMySQLManager()
     }
 
     // get database user
-    if (!(strDBUser = TCReadConfig::GetReader()->GetConfig("DB.User")))
+    if (server && !(strDBUser = TCReadConfig::GetReader()->GetConfig("DB.User")))
     {
         if (!fSilence) Error("TCMySQLManager", "Database user not included in configuration file!");
         return;
     }
     
     // get database password
-    if (!(strDBPass = TCReadConfig::GetReader()->GetConfig("DB.Pass")))
+    if (server && !(strDBPass = TCReadConfig::GetReader()->GetConfig("DB.Pass")))
     {
         if (!fSilence) Error("TCMySQLManager", "Database password not included in configuration file!");
         return;
     }
 
-    // open connection to MySQL server on localhost
-    Char_t szMySQL[200];
-    sprintf(szMySQL, "mysql://%s/%s", strDBHost->Data(), strDBName->Data());
-    fDB = TSQLServer::Connect(szMySQL, strDBUser->Data(), strDBPass->Data());
-    if (!fDB)
+    // read number of pooled connections
+    if (TCReadConfig::GetReader()->GetConfig("DB.Connections"))
+        SetNConnections(TCReadConfig::GetReader()->GetConfigInt("DB.Connections"));
+
+    // read revalidation interval of the cached set tables
+    if (TCReadConfig::GetReader()->GetConfig("DB.Cache.Revalidate"))
+        fRevalidate = TCReadConfig::GetReader()->GetConfigInt("DB.Cache.Revalidate");
+
+    // read trust time of the cached set tables
+    if (TCReadConfig::GetReader()->GetConfig("DB.Cache.Trust"))
+        fCacheTrust = TCReadConfig::GetReader()->GetConfigInt("DB.Cache.Trust");
+
+    // read number of rows per multi-row insert
+    if (TCReadConfig::GetReader()->GetConfig("DB.InsertChunk"))
+        SetInsertChunk(TCReadConfig::GetReader()->GetConfigInt("DB.InsertChunk"));
+
+    // read execution time of slow queries
+    if (TCReadConfig::GetReader()->GetConfig("DB.SlowQuery"))
+        fSlowQuery = TCReadConfig::GetReader()->GetConfigDouble("DB.SlowQuery");
+
+    // read file of the parameter cache
+    if (TString* f = TCReadConfig::GetReader()->GetConfig("DB.Cache.File")) fParCacheFile = *f;
+
+    // create the database backend
+    fBackend = TCDBBackend::Create(strDBBackend.Data(), 
+                                   strDBHost ? strDBHost->Data() : 0, strDBName->Data(),
+                                   strDBUser ? strDBUser->Data() : 0, strDBPass ? strDBPass->Data() : 0);
+    if (!fBackend)
     {
-        if (!fSilence) Error("TCMySQLManager", "Cannot connect to the database '%s' on '%s@%s'!",
-               strDBName->Data(), strDBUser->Data(), strDBHost->Data());
+        if (!fSilence) Error("TCMySQLManager", "Unknown database backend '%s'!", strDBBackend.Data());
         return;
     }
-    else if (fDB->IsZombie())
+
+    // open connection to the database
+    fDB = fBackend->Connect();
+    if (!fDB)
     {
-        if (!fSilence) Error("TCMySQLManager", "Cannot connect to the database '%s' on '%s@%s'!",
-               strDBName->Data(), strDBUser->Data(), strDBHost->Data());
+        if (!fSilence) Error("TCMySQLManager", "Cannot connect to the database '%s'!", fBackend->GetURL());
         return;
     }
     else
     {
-        if (!fSilence) Info("TCMySQLManager", "Connected to the database '%s' on '%s@%s' using CaLib %s",
-                            strDBName->Data(), strDBUser->Data(), strDBHost->Data(), TCConfig::kCaLibVersion);
+        if (!fSilence) Info("TCMySQLManager", "Connected to the database '%s' using CaLib %s",
+                            fBackend->GetURL(), TCConfig::kCaLibVersion);
+    }
+
+    // load the parameter cache
+    if (fParCacheFile.Length() && !gSystem->AccessPathName(fParCacheFile.Data()))
+    {
+        Int_t n = fParCache->Load(fParCacheFile.Data(), fBackend->GetURL());
+        if (!fSilence) 
+        {
+            if (n < 0) Warning("TCMySQLManager", "Ignoring the parameter cache '%s' of another database",
+                               fParCacheFile.Data());
+            else Info("TCMySQLManager", "Loaded %d cached parameter sets from '%s'",
+                      n, fParCacheFile.Data());
+        }
+    }
+
+    // save the parameter cache at exit (the static instance is never destroyed)
+    static Bool_t registered = kFALSE;
+    if (fParCacheFile.Length() && !registered)
+    {
+        atexit(SaveParameterCacheAtExit);
+        registered = kTRUE;
     }
 }
 
@@ -108,10 +270,25 @@ TCMySQLManager::~TCMySQLManager()
 {
     // Destructor.
 
+    // save the parameter cache
+    if (fParCacheFile.Length() && IsConnected()) SaveParameterCache();
+    if (fgMySQLManager == this) fgMySQLManager = 0;
+
     // close DB
+    CloseConnections();
     if (fDB) delete fDB;
+    if (fBackend) delete fBackend;
     if (fData) delete fData;
     if (fTypes) delete fTypes;
+    if (fSetTables) delete fSetTables;
+    if (fStatements) delete fStatements;
+    if (fTableLayouts) delete fTableLayouts;
+    if (fParCache) delete fParCache;
+    if (fQueryStats) delete fQueryStats;
+    if (fParents) delete fParents;
+    if (fConnFree) delete fConnFree;
+    if (fPoolMutex) delete fPoolMutex;
+    if (fMutex) delete fMutex;
 }
 
 //______________________________________________________________________________
@@ -329,220 +506,1482 @@ Bool_t TCMySQLManager::ReadCaLibTypes()
 }
 
 //______________________________________________________________________________
-TSQLResult* TCMySQLManager::SendQuery(const Char_t* query)
+void TCMySQLManager::SetNConnections(Int_t n)
 {
-    // Send a query to the database and return the result.
+    // Set the number of pooled database connections used by the parallel
+    // operations to 'n' (0: parallel operations disabled). The pooled
+    // connections are opened on first use.
+    // NOTE: none of the pooled connections may be checked out.
 
-    // check server connection
-    if (!IsConnected())
+    CloseConnections();
+    fNConn = n > 0 ? n : 0;
+}
+
+//______________________________________________________________________________
+Int_t TCMySQLManager::OpenConnections()
+{
+    // Open the pooled database connections if this was not done yet.
+    // Return the number of open pooled connections.
+    // NOTE: this must be called from the main thread.
+
+    // open the connections
+    if (!fConn && fNConn && fBackend)
     {
-        if (!fSilence) Error("SendQuery", "No connection to the database!");
-        return 0;
+        fConn = new TSQLServer*[fNConn];
+        fConnOwner = new Long_t[fNConn];
+        for (Int_t i = 0; i < fNConn; i++)
+        {
+            fConn[i] = fBackend->Connect();
+            fConnOwner[i] = 0;
+        }
     }
 
-    // execute query
-    return fDB->Query(query);
+    // count the open connections
+    Int_t nOpen = 0;
+    if (fConn)
+    {
+        for (Int_t i = 0; i < fNConn; i++)
+            if (fConn[i]) nOpen++;
+    }
+    
+    // user information
+    if (fConn && nOpen < fNConn && !fSilence) 
+        Warning("OpenConnections", "Opened only %d of %d pooled connections", nOpen, fNConn);
+
+    return nOpen;
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::IsConnected()
+void TCMySQLManager::CloseConnections()
 {
-    // Check if the connection to the database is open.
+    // Close the pooled database connections.
+
+    if (!fConn) return;
+    for (Int_t i = 0; i < fNConn; i++)
+        if (fConn[i]) delete fConn[i];
+    delete [] fConn;
+    delete [] fConnOwner;
+    fConn = 0;
+    fConnOwner = 0;
+}
 
-    if (!fDB)
+//______________________________________________________________________________
+TSQLServer* TCMySQLManager::AcquireConnection()
+{
+    // Check out a pooled database connection for the calling thread. Wait
+    // until a connection is released if all are checked out. All queries
+    // of the calling thread use this connection until it is released using
+    // ReleaseConnection().
+    // Return 0 if no pooled connections are available.
+    // NOTE: the pool has to be opened in the main thread first (see 
+    //       OpenConnections()).
+
+    if (!fConn) return 0;
+
+    TSQLServer* db = 0;
+    Bool_t any = kFALSE;
+    Long_t self = TThread::SelfId();
+    
+    fPoolMutex->Lock();
+    while (!db)
     {
-        if (!fSilence) Error("IsConnected", "Cannot access database!");
-        return kFALSE;
+        // look for a free connection
+        for (Int_t i = 0; i < fNConn; i++)
+        {
+            if (!fConn[i]) continue;
+            any = kTRUE;
+            if (!fConnOwner[i] || fConnOwner[i] == self)
+            {
+                fConnOwner[i] = self;
+                db = fConn[i];
+                break;
+            }
+        }
+
+        // wait for a released connection
+        if (!any) break;
+        if (!db) fConnFree->Wait();
     }
-    else
-        return kTRUE;
+    fPoolMutex->UnLock();
+
+    return db;
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::SearchTable(const Char_t* data, Char_t* outTableName)
+void TCMySQLManager::ReleaseConnection(TSQLServer* db)
 {
-    // Search the table name of the calibration quantity 'data' and write it
-    // to 'outTableName'.
-    // Return kTRUE when a true table was found, otherwise kFALSE.
-    
-    // get CaLib data
-    TCCalibData* d = (TCCalibData*) fData->FindObject(data);
+    // Return the pooled database connection 'db' checked out using 
+    // AcquireConnection() to the pool.
 
-    // check data
-    if (d)
+    if (!fConn || !db) return;
+
+    fPoolMutex->Lock();
+    for (Int_t i = 0; i < fNConn; i++)
     {
-        // copy table name
-        strcpy(outTableName, d->GetTableName());
-        return kTRUE;
+        if (fConn[i] == db)
+        {
+            fConnOwner[i] = 0;
+            break;
+        }
     }
-    else return kFALSE;
+    fConnFree->Broadcast();
+    fPoolMutex->UnLock();
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::SearchRunEntry(Int_t run, const Char_t* name, Char_t* outInfo)
+TSQLServer* TCMySQLManager::GetConnection()
 {
-    // Search the information 'name' for the run 'run' and write it to 'outInfo'.
-    // Return kTRUE when the information was found, otherwise kFALSE.
-    
-    Char_t query[256];
+    // Return the pooled database connection checked out by the calling 
+    // thread or the main connection.
 
-    // create the query
-    sprintf(query,
-            "SELECT %s FROM %s "
-            "WHERE run = %d",
-            name, TCConfig::kCalibMainTableName, run);
+    TSQLServer* db = 0;
+    if (fConn)
+    {
+        Long_t self = TThread::SelfId();
+        fPoolMutex->Lock();
+        for (Int_t i = 0; i < fNConn; i++)
+        {
+            if (fConn[i] && fConnOwner[i] == self)
+            {
+                db = fConn[i];
+                break;
+            }
+        }
+        fPoolMutex->UnLock();
+    }
 
-    // read from database
-    TSQLResult* res = SendQuery(query);
-    
-    // check result
-    if (!res)
+    return db ? db : fDB;
+}
+
+//______________________________________________________________________________
+void TCMySQLManager::ClearSetTables(const Char_t* table)
+{
+    // Clear the cached set tables of the data table 'table' or all cached 
+    // set tables if 'table' is 0. The cached parent calibrations are cleared
+    // if 'table' is 0 or the parent table.
+
+    fMutex->Lock();
+    if ((!table || !strcmp(table, TCConfig::kCalibParentTableName)) && fParents)
     {
-        if (!fSilence) Error("SearchRunEntry", "Could not find the information '%s' for run %d!",
-                                               name, run);
-        return kFALSE;
+        delete fParents;
+        fParents = 0;
     }
-    if (!res->GetRowCount())
+    if (!table) fSetTables->Delete();
+    else
     {
-        if (!fSilence) Error("SearchRunEntry", "Could not find the information '%s' for run %d!",
-                                               name, run);
-        delete res;
-        return kFALSE;
+        // collect the set tables of the data table
+        TString prefix = TString::Format("%s/", table);
+        TList remove;
+        TIter next(fSetTables);
+        TObject* o;
+        while ((o = next()))
+            if (TString(o->GetName()).BeginsWith(prefix)) remove.Add(o);
+
+        // remove them
+        TIter nextRemove(&remove);
+        while ((o = nextRemove()))
+        {
+            fSetTables->Remove(o);
+            delete o;
+        }
     }
-
-    // get row
-    TSQLRow* row = res->Next();
-  
-    // write the information
-    const Char_t* field = row->GetField(0);
-    if (!field) strcpy(outInfo, "");
-    else strcpy(outInfo, field);
-
-    // clean-up
-    delete row;
-    delete res;
-    
-    return kTRUE;
+    fMutex->UnLock();
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::SearchSetEntry(const Char_t* data, const Char_t* calibration, Int_t set,
-                                      const Char_t* name, Char_t* outInfo)
+Bool_t TCMySQLManager::SaveParameterCache()
 {
-    // Search the information 'name' for the calibration identifier 'calibration' and 
-    // the calibration data 'data' for the set number 'set' and write it to 'outInfo'.
-    // Return kTRUE when the information was found, otherwise kFALSE.
-  
-    Char_t query[256];
-    Char_t table[256];
+    // Save the parameter cache to the file configured by 'DB.Cache.File'.
+    // Return kFALSE if an error occurred, otherwise kTRUE.
 
-    // get the data table
-    if (!SearchTable(data, table))
+    // check the file
+    if (!fParCacheFile.Length())
     {
-        if (!fSilence) Error("SearchSetEntry", "No data table found!");
+        if (!fSilence) Error("SaveParameterCache", "No parameter cache file configured!");
         return kFALSE;
     }
 
-    // create the query
-    sprintf(query,
-            "SELECT %s FROM %s WHERE "
-            "calibration = '%s' "
-            "ORDER BY first_run ASC LIMIT 1 OFFSET %d",
-            name, table, calibration, set);
-
-    // read from database
-    TSQLResult* res = SendQuery(query);
-
-    // check result
-    if (!res)
+    // save the cache
+    if (!fBackend || !fParCache->Save(fParCacheFile.Data(), fBackend->GetURL()))
     {
-        if (!fSilence) Error("SearchSetEntry", "No runset %d found in table '%s'!", set, table);
+        if (!fSilence) Error("SaveParameterCache", "Could not save the parameter cache to '%s'!",
+                             fParCacheFile.Data());
         return kFALSE;
     }
-    if (!res->GetRowCount())
+    else
     {
-        if (!fSilence) Error("SearchSetEntry", "No runset %d found in table '%s'!", set, table);
-        return kFALSE;
+        if (!fSilence) Info("SaveParameterCache", "Saved %d cached parameter sets to '%s'",
+                            fParCache->GetNEntries(), fParCacheFile.Data());
+        return kTRUE;
     }
+}
 
-    // get data
-    TSQLRow* row = res->Next();
-    const Char_t* d = row->GetField(0);
-    if (!d) strcpy(outInfo, "");
-    else strcpy(outInfo, d);
+//______________________________________________________________________________
+void TCMySQLManager::SaveParameterCacheAtExit()
+{
+    // Save the parameter cache of the static instance of this class if a 
+    // cache file was configured. Registered via atexit() when the cache 
+    // file is configured.
 
-    // clean-up
-    delete row;
-    delete res;
-    
-    return kTRUE;
+    if (fgMySQLManager && fgMySQLManager->fParCacheFile.Length() && fgMySQLManager->IsConnected())
+        fgMySQLManager->SaveParameterCache();
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::ChangeRunEntries(Int_t first_run, Int_t last_run, 
-                                        const Char_t* name, const Char_t* value)
+void* TCMySQLManager::ParallelWorker(void* arg)
 {
-    // Change the run entry 'name' for the runs 'first_run' to 'last_run' to 'value'.
-    
-    Char_t query[256];
-    
-    // check if first run is smaller than last run
-    if (first_run > last_run)
+    // Database worker thread: check out a pooled connection and run the
+    // tasks of the worker 'arg' until all tasks are taken. In the transaction
+    // mode the tasks of the thread are run in one transaction that is 
+    // committed when all threads succeeded with all their tasks and rolled 
+    // back otherwise. A thread that cannot check out a connection takes no
+    // tasks and fails the transactions. The committed transactions are 
+    // counted to detect partially committed changes.
+
+    TCMySQLManagerWorker* w = (TCMySQLManagerWorker*) arg;
+    TSQLServer* db = w->fManager->AcquireConnection();
+
+    // check the connection and start the transaction
+    if (!db || (w->fTransaction && !db->StartTransaction()))
     {
-        if (!fSilence) Error("ChangeRunEntries", "First run of has to be smaller than last run!");
-        return kFALSE;
+        if (!db && !w->fManager->fSilence) 
+            Error("RunParallel", "Could not check out a pooled connection!");
+        w->fMutex->Lock();
+        w->fFailed = kTRUE;
+        w->fMutex->UnLock();
     }
 
-    // create the query
-    sprintf(query,
-            "UPDATE %s SET %s = '%s' "
-            "WHERE run >= %d AND"
-            "      run <= %d",
-            TCConfig::kCalibMainTableName, name, value, first_run, last_run);
+    // run tasks
+    while (db)
+    {
 
-    // read from database
-    TSQLResult* res = SendQuery(query);
-    
-    // check result
-    if (!res)
+        // take the next task
+        w->fMutex->Lock();
+        Int_t i = w->fNext++;
+        w->fMutex->UnLock();
+        if (i >= w->fNTask) break;
+
+        // run the task
+        Bool_t ok = w->fManager->RunTask(w->fType, i, w->fArg);
+        
+        // count successful tasks
+        if (ok)
+        {
+            w->fMutex->Lock();
+            w->fNOK++;
+            w->fMutex->UnLock();
+        }
+    }
+
+    // finish the transaction when all threads are done with their tasks
+    if (w->fTransaction)
     {
-        if (!fSilence) Error("ChangeRunEntries", "Could not set the information '%s' for runs %d to %d to '%s'!",
-                                                 name, first_run, last_run, value);
-        return kFALSE;
+        w->fMutex->Lock();
+        w->fNDone++;
+        if (w->fNDone == w->fNThread) w->fDone->Broadcast();
+        while (w->fNDone < w->fNThread) w->fDone->Wait();
+        Bool_t commit = !w->fFailed && w->fNOK == w->fNTask;
+        w->fMutex->UnLock();
+        
+        // commit or roll back
+        if (db && !commit) db->Rollback();
+        else if (db)
+        {
+            Bool_t committed = db->Commit();
+            w->fMutex->Lock();
+            if (committed) w->fNCommit++;
+            else w->fFailed = kTRUE;
+            w->fMutex->UnLock();
+        }
     }
 
-    // clean-up
-    delete res;
-    
-    return kTRUE;
+    // release the connection
+    if (db) w->fManager->ReleaseConnection(db);
+
+    return 0;
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::ChangeSetEntry(const Char_t* data, const Char_t* calibration, Int_t set,
-                                      const Char_t* name, const Char_t* value)
+Int_t TCMySQLManager::RunParallel(Int_t type, Int_t nTask, void* arg, Bool_t transaction)
 {
-    // Change the information 'name' of the 'set'-th set of the calibration 'calibration'
-    // for the calibration data 'data' to 'value'.
+    // Run the 'nTask' database tasks of the type 'type' using the argument 
+    // 'arg' (see RunTask()). The tasks are run in parallel by one thread per
+    // pooled connection. Every thread checks out its own connection. The 
+    // tasks are run serially using the main connection if no pooled 
+    // connections are available.
+    // If 'transaction' is kTRUE, the changes of the tasks are committed only 
+    // if all tasks succeeded and rolled back otherwise. The parallel threads
+    // run their tasks in one transaction per connection that are committed 
+    // after all threads finished their tasks.
+    // NOTE: The parallel transactions are not atomic as a whole. If the commit
+    //       fails on one connection after other connections were committed,
+    //       the changes are only partially written and have to be cleaned up
+    //       by the caller.
+    // Return the number of successful tasks, 0 if the transactions were 
+    // rolled back and -1 if they were only partially committed.
     
-    Char_t query[256];
-    Char_t table[256];
+    // number of threads (transactions are run serially if the backend does
+    // not support parallel transactions)
+    Int_t nThreads = 0;
+    if (nTask > 1 && (!transaction || fBackend->HasParallelTransactions()))
+        nThreads = TMath::Min(OpenConnections(), nTask);
+    
+    // run serially
+    if (nThreads < 2)
+    {
+        if (transaction && !StartTransaction()) return 0;
+        Int_t nOK = 0;
+        for (Int_t i = 0; i < nTask; i++)
+            if (RunTask(type, i, arg)) nOK++;
+        if (transaction)
+        {
+            if (nOK != nTask || !CommitTransaction())
+            {
+                if (nOK != nTask) RollbackTransaction();
+                if (!fSilence) Error("RunParallel", "The changes of the tasks were rolled back!");
+                return 0;
+            }
+        }
+        return nOK;
+    }
 
-    // get the data table
-    if (!SearchTable(data, table))
-    {
-        if (!fSilence) Error("ChangeSetEntry", "No data table found!");
+    // enable ROOT thread safety
+    TThread::Initialize();
+    
+    // create the worker threads
+    TMutex mutex;
+    TCMySQLManagerWorker w;
+    w.fManager = this;
+    w.fType = type;
+    w.fNTask = nTask;
+    w.fArg = arg;
+    w.fNext = 0;
+    w.fNOK = 0;
+    w.fMutex = &mutex;
+    w.fTransaction = transaction;
+    w.fNThread = nThreads;
+    w.fNDone = 0;
+    w.fFailed = kFALSE;
+    w.fNCommit = 0;
+    TCondition done(&mutex);
+    w.fDone = &done;
+    TThread** thread = new TThread*[nThreads];
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        thread[i] = new TThread(TString::Format("TCMySQLManager_Worker_%d", i).Data(),
+                                ParallelWorker, (void*) &w);
+        thread[i]->Run();
+    }
+
+    // wait for the worker threads
+    for (Int_t i = 0; i < nThreads; i++)
+    {
+        thread[i]->Join();
+        delete thread[i];
+    }
+    delete [] thread;
+
+    // check the transactions
+    if (transaction && (w.fFailed || w.fNOK != nTask))
+    {
+        if (w.fNCommit)
+        {
+            if (!fSilence) Error("RunParallel", "The changes of the tasks were only partially committed "
+                                 "(%d of %d transactions)!", w.fNCommit, nThreads);
+            return -1;
+        }
+        if (!fSilence) Error("RunParallel", "The changes of the tasks were rolled back!");
         return 0;
     }
-    
-    // get the first run of the set
-    Int_t first_run = GetFirstRunOfSet(data, calibration, set);
 
-    // create the query
-    sprintf(query,
+    return w.fNOK;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::RunTask(Int_t type, Int_t i, void* arg)
+{
+    // Run the task 'i' of the type 'type' using the argument 'arg' (see 
+    // RunParallel()). The tasks of the different types are
+    //   kTaskDump   : dump the calibrations of one data to its container
+    //   kTaskClone  : clone the last set of one data
+    //   kTaskImport : import the calibrations of one data from the container
+    //   kTaskAdd    : add one set of one data
+    // The task result is stored in the result array of the argument.
+    // Return kTRUE on success, otherwise kFALSE.
+
+    TCMySQLManagerTask* t = (TCMySQLManagerTask*) arg;
+    const Char_t* data = t->fData[i];
+    t->fResult[i] = 0;
+
+    switch (type)
+    {
+        // dump calibrations
+        case kTaskDump:
+        {
+            t->fResult[i] = DumpCalibrations(t->fContainer[i], t->fCalibration, data);
+            break;
+        }
+        // clone calibration
+        case kTaskClone:
+        {
+            if (CloneDataSet(data, t->fCalibration, t->fNewCalibration, t->fDesc, 
+                             t->fFirstRun, t->fLastRun)) t->fResult[i] = 1;
+            break;
+        }
+        // import calibrations
+        case kTaskImport:
+        {
+            // loop over calibrations
+            TIter next(t->fContainer[0]->GetCalibrations());
+            TCCalibration* c;
+            while ((c = (TCCalibration*)next()))
+            {
+                // skip other calibration data
+                if (strcmp(c->GetCalibData(), data)) continue;
+
+                // add the set with new calibration identifer or the same
+                const Char_t* calibration;
+                if (t->fNewCalibration) calibration = t->fNewCalibration;
+                else calibration = c->GetCalibration();
+
+                // add the set
+                if (AddDataSet(c->GetCalibData(), calibration, c->GetDescription(), 
+                               c->GetFirstRun(), c->GetLastRun(), c->GetParameters(), c->GetNParameters(), kTRUE))
+                {
+                    if (!fSilence) Info("ImportCalibrations", "Added calibration '%s' of '%s' to the database",
+                                        calibration, ((TCCalibData*) fData->FindObject(data))->GetTitle());
+                    t->fResult[i]++;
+                }
+                else
+                {
+                    if (!fSilence) Error("ImportCalibrations", "Calibration '%s' of '%s' could not be added to the database!",
+                                         calibration, ((TCCalibData*) fData->FindObject(data))->GetTitle());
+                }
+            }
+            break;
+        }
+        // add set
+        case kTaskAdd:
+        {
+            if (AddDataSet(data, t->fCalibration, t->fDesc, t->fFirstRun, t->fLastRun, 
+                           t->fPar[i], t->fLength[i])) t->fResult[i] = 1;
+            break;
+        }
+    }
+
+    return t->fResult[i] > 0 ? kTRUE : kFALSE;
+}
+
+//______________________________________________________________________________
+TSQLResult* TCMySQLManager::SendQuery(const Char_t* query)
+{
+    // Send a query to the database and return the result.
+    // The cached set tables and parameters of the modified table are cleared
+    // for all queries that might modify the database (of all tables if the 
+    // table cannot be determined), the cached table layouts for all queries 
+    // that might modify the table definitions.
+    // The execution time of the query is recorded (see RecordQuery()).
+
+    // check server connection
+    if (!IsConnected())
+    {
+        if (!fSilence) Error("SendQuery", "No connection to the database!");
+        return 0;
+    }
+
+    // clear cached set tables and parameters if the query is not read-only
+    TString q(query);
+    q = q.Strip(TString::kLeading);
+    if (!q.BeginsWith("SELECT", TString::kIgnoreCase) &&
+        !q.BeginsWith("SHOW", TString::kIgnoreCase) &&
+        !q.BeginsWith("DESCRIBE", TString::kIgnoreCase) &&
+        !q.BeginsWith("PRAGMA", TString::kIgnoreCase))
+    {
+        TString table = GetModifiedTable(q.Data());
+        ClearSetTables(table.Length() ? table.Data() : 0);
+        fParCache->Clear(table.Length() ? table.Data() : 0);
+    }
+    if (q.BeginsWith("ALTER", TString::kIgnoreCase) ||
+        q.BeginsWith("CREATE", TString::kIgnoreCase) ||
+        q.BeginsWith("DROP", TString::kIgnoreCase))
+    {
+        fMutex->Lock();
+        fTableLayouts->Delete();
+        fMutex->UnLock();
+    }
+
+    // execute query
+    TStopwatch watch;
+    TSQLResult* res = fBackend->Query(GetConnection(), query);
+    watch.Stop();
+
+    // record the query
+    RecordQuery(query, watch.RealTime(), res ? res->GetRowCount() : 0);
+
+    return res;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::ProcessStatement(TSQLStatement* stmt, const Char_t* sql, Bool_t store)
+{
+    // Process the prepared statement 'stmt' having the SQL 'sql' and store
+    // its result if 'store' is kTRUE. The execution time of the statement is
+    // recorded like the one of the queries (see RecordQuery()).
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    // execute the statement
+    TStopwatch watch;
+    Bool_t ok = stmt->Process();
+    if (ok && store) ok = stmt->StoreResult();
+    watch.Stop();
+
+    // record the statement
+    RecordQuery(sql, watch.RealTime(), ok ? stmt->GetNumAffectedRows() : 0);
+
+    return ok;
+}
+
+//______________________________________________________________________________
+void TCMySQLManager::RecordQuery(const Char_t* query, Double_t time, Long64_t rows)
+{
+    // Add the execution time 'time' [s] and the number of returned or affected 
+    // rows 'rows' of the query 'query' to the query statistics. Queries taking 
+    // longer than the slow query time 'fSlowQuery' [ms] are logged.
+    
+    // check for slow queries
+    Bool_t slow = fSlowQuery > 0 && 1000*time > fSlowQuery;
+    if (slow && !fSilence) 
+    {
+        TString q(query);
+        if (q.Length() > 256) 
+        {
+            q.Resize(256);
+            q.Append("...");
+        }
+        Warning("RecordQuery", "Slow query (%.1f ms): %s", 1000*time, q.Data());
+    }
+
+    // add to the statistics
+    fQueryStats->Add(query, time, rows, slow);
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::StartTransaction()
+{
+    // Start a transaction on the database connection of the calling thread.
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    // check server connection
+    if (!IsConnected())
+    {
+        if (!fSilence) Error("StartTransaction", "No connection to the database!");
+        return kFALSE;
+    }
+
+    // start the transaction
+    if (!GetConnection()->StartTransaction())
+    {
+        if (!fSilence) Error("StartTransaction", "Could not start a transaction!");
+        return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::CommitTransaction()
+{
+    // Commit the transaction on the database connection of the calling thread.
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    if (!GetConnection()->Commit())
+    {
+        if (!fSilence) Error("CommitTransaction", "Could not commit the transaction!");
+        return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+void TCMySQLManager::RollbackTransaction()
+{
+    // Roll back the transaction on the database connection of the calling thread.
+    // The cached set tables are cleared because they might contain changes
+    // of the transaction.
+
+    if (!GetConnection()->Rollback())
+    {
+        if (!fSilence) Error("RollbackTransaction", "Could not roll back the transaction!");
+    }
+    ClearSetTables();
+}
+
+//______________________________________________________________________________
+Int_t TCMySQLManager::InsertRows(const Char_t* table, const Char_t* columns, 
+                                 Int_t nRow, const TString* values, Bool_t* outOK)
+{
+    // Insert the 'nRow' rows having the values 'values' of the columns 
+    // 'columns' into the table 'table'. The values of a row are comma-separated
+    // SQL literals, strings quoted by TCDBBackend::Quote(). The rows are 
+    // written using multi-row inserts of up to fInsertChunk rows, each 
+    // committed in one transaction.
+    // If a chunk cannot be inserted, its rows are inserted one by one to find
+    // the failing rows. The success of every row is stored in 'outOK'.
+    // Return the number of inserted rows.
+
+    Int_t nInserted = 0;
+
+    // loop over chunks
+    Int_t first = 0;
+    while (first < nRow)
+    {
+        // create the multi-row insert query of the chunk
+        TString query = TString::Format("INSERT INTO %s (%s) VALUES ", table, columns);
+        Int_t last = first;
+        while (last < nRow && last - first < fInsertChunk)
+        {
+            if (last > first && query.Length() + values[last].Length() + 3 > TCConfig::kMaxInsertLength) break;
+            if (last > first) query += ",";
+            query += "(";
+            query += values[last];
+            query += ")";
+            last++;
+        }
+
+        // write the chunk in one transaction
+        Bool_t ok = StartTransaction();
+        if (ok)
+        {
+            TSQLResult* res = SendQuery(query.Data());
+            if (res)
+            {
+                delete res;
+                ok = CommitTransaction();
+            }
+            else
+            {
+                RollbackTransaction();
+                ok = kFALSE;
+            }
+        }
+
+        // check the chunk
+        if (ok)
+        {
+            for (Int_t i = first; i < last; i++) outOK[i] = kTRUE;
+            nInserted += last - first;
+        }
+        else
+        {
+            // insert the rows of the chunk one by one
+            Bool_t trans = StartTransaction();
+            Int_t nRowOK = 0;
+            for (Int_t i = first; i < last; i++)
+            {
+                TSQLResult* res = SendQuery(TString::Format("INSERT INTO %s (%s) VALUES (%s)", 
+                                                            table, columns, values[i].Data()).Data());
+                outOK[i] = res ? kTRUE : kFALSE;
+                if (res)
+                {
+                    delete res;
+                    nRowOK++;
+                }
+            }
+            
+            // commit the rows
+            if (trans && !CommitTransaction())
+            {
+                for (Int_t i = first; i < last; i++) outOK[i] = kFALSE;
+                nRowOK = 0;
+            }
+            nInserted += nRowOK;
+        }
+
+        first = last;
+    }
+
+    return nInserted;
+}
+
+//______________________________________________________________________________
+TCSetTable* TCMySQLManager::GetSetTable(const Char_t* data, const Char_t* calibration, Bool_t resolve)
+{
+    // Return the table of the sets of the calibration data 'data' for the
+    // calibration identifier 'calibration'. If 'resolve' is kTRUE (default)
+    // and 'calibration' is an overlay calibration without own sets of 'data',
+    // the sets of the nearest parent calibration having sets are returned
+    // (see TCSetTable::GetCalibration()).
+    // Return 0 if an error occurred.
+    // NOTE: the returned table must be destroyed by the caller.
+
+    Char_t table[256];
+
+    // get the data table
+    if (!SearchTable(data, table))
+    {
+        if (!fSilence) Error("GetSetTable", "No data table found!");
+        return 0;
+    }
+
+    // follow the parent calibrations
+    TString calib(calibration);
+    for (Int_t i = 0; ; i++)
+    {
+        // get the sets of the calibration
+        TCSetTable* sets = ReadSetTable(table, calib.Data());
+        if (!resolve || !sets || sets->GetNSet()) return sets;
+
+        // get the parent calibration
+        TString parent = GetParentCalibration(calib.Data());
+        if (!parent.Length()) return sets;
+        if (i == TCConfig::kMaxOverlayDepth)
+        {
+            if (!fSilence) Error("GetSetTable", "Too many parent calibrations of '%s'!", calibration);
+            return sets;
+        }
+        delete sets;
+        calib = parent;
+    }
+}
+
+//______________________________________________________________________________
+TCSetTable* TCMySQLManager::ReadSetTable(const Char_t* table, const Char_t* calibration)
+{
+    // Return the table of the sets of the data table 'table' for the 
+    // calibration identifier 'calibration'. All sets are read from the 
+    // database with a single query and cached until the next query that 
+    // might modify the database. Cached tables older than the revalidation
+    // interval are read again to detect changes made by other clients.
+    // A copy of the cached table is returned because the cache can be 
+    // cleared by other threads at any time.
+    // Return 0 if an error occurred.
+    // NOTE: the returned table must be destroyed by the caller.
+
+    Char_t query[256];
+
+    // look for a cached table
+    TString name = TString::Format("%s/%s", table, calibration);
+    fMutex->Lock();
+    TCSetTable* sets = (TCSetTable*) fSetTables->FindObject(name.Data());
+    if (sets && fRevalidate >= 0 && (Long_t) time(0) - sets->GetLoadTime() > fRevalidate)
+    {
+        fSetTables->Remove(sets);
+        delete sets;
+        sets = 0;
+    }
+    if (sets) sets = new TCSetTable(*sets);
+    fMutex->UnLock();
+    if (sets) return sets;
+
+    // create the query
+    sprintf(query,
+            "SELECT first_run, last_run, description, changed FROM %s WHERE "
+            "calibration = '%s' "
+            "ORDER BY first_run ASC",
+            table, calibration);
+
+    // read from database
+    TSQLResult* res = SendQuery(query);
+
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("ReadSetTable", "No runsets found in table '%s'!", table);
+        return 0;
+    }
+
+    // read all sets
+    Int_t nSet = res->GetRowCount();
+    sets = new TCSetTable(name.Data(), calibration, nSet);
+    for (Int_t i = 0; i < nSet; i++)
+    {
+        TSQLRow* row = res->Next();
+        sets->SetSet(i, row->GetField(0) ? atoi(row->GetField(0)) : 0,
+                        row->GetField(1) ? atoi(row->GetField(1)) : 0,
+                        row->GetField(2), row->GetField(3));
+        delete row;
+    }
+
+    // clean-up
+    delete res;
+
+    // cache a copy of the table unless another thread was faster
+    fMutex->Lock();
+    if (!fSetTables->FindObject(name.Data())) fSetTables->Add(new TCSetTable(*sets));
+    fMutex->UnLock();
+
+    return sets;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::ReadChangeTimes(const Char_t* table, const Char_t* calibration, 
+                                       Int_t n, const Int_t* first_run, TString* outChanged)
+{
+    // Read the current change times of the 'n' sets with the first runs
+    // 'first_run' of the data table 'table' for the calibration identifier
+    // 'calibration' from the database using a single query and save them to
+    // 'outChanged'. The change times of sets that do not exist anymore are
+    // empty.
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    // create the query
+    TString query = TString::Format("SELECT first_run, changed FROM %s WHERE "
+                                    "calibration = '%s' AND first_run IN (",
+                                    table, calibration);
+    for (Int_t i = 0; i < n; i++)
+    {
+        if (i) query.Append(",");
+        query.Append(TString::Format("%d", first_run[i]));
+        outChanged[i] = "";
+    }
+    query.Append(")");
+
+    // read from database
+    TSQLResult* res = SendQuery(query.Data());
+    if (!res) return kFALSE;
+
+    // read the change times
+    TSQLRow* row;
+    while ((row = res->Next()))
+    {
+        Int_t run = row->GetField(0) ? atoi(row->GetField(0)) : 0;
+        for (Int_t i = 0; i < n; i++)
+            if (first_run[i] == run) outChanged[i] = row->GetField(1) ? row->GetField(1) : "";
+        delete row;
+    }
+
+    // clean-up
+    delete res;
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+THashList* TCMySQLManager::ReadParentCalibrations()
+{
+    // Read the parent calibrations of all overlay calibrations from the
+    // database and return them as a list of calibration identifiers (name)
+    // and parent calibrations (title). An empty list is returned if the 
+    // parent table does not exist (database version < 6).
+    // NOTE: the list must be destroyed by the caller.
+
+    Char_t query[256];
+
+    // create the list
+    THashList* list = new THashList();
+    list->SetOwner(kTRUE);
+
+    // check the parent table
+    if (!ContainsTable(TCConfig::kCalibParentTableName)) return list;
+
+    // read from database
+    sprintf(query, "SELECT calibration, parent FROM %s", TCConfig::kCalibParentTableName);
+    TSQLResult* res = SendQuery(query);
+    if (!res) return list;
+
+    // read all parents
+    TSQLRow* row;
+    while ((row = res->Next()))
+    {
+        list->Add(new TNamed(GetField(row, 0), GetField(row, 1)));
+        delete row;
+    }
+
+    // clean-up
+    delete res;
+
+    return list;
+}
+
+//______________________________________________________________________________
+TString TCMySQLManager::GetParentCalibration(const Char_t* calibration)
+{
+    // Return the parent calibration of the overlay calibration 'calibration'
+    // or an empty string if 'calibration' is not an overlay calibration.
+    // The parents of all overlay calibrations are read with a single query
+    // and cached like the set tables (see ReadSetTable()).
+
+    // check the cached parents
+    fMutex->Lock();
+    if (fParents && fRevalidate >= 0 && (Long_t) time(0) - fParentsTime > fRevalidate)
+    {
+        delete fParents;
+        fParents = 0;
+    }
+    Bool_t read = fParents ? kFALSE : kTRUE;
+    fMutex->UnLock();
+
+    // read the parents
+    if (read)
+    {
+        THashList* parents = ReadParentCalibrations();
+        fMutex->Lock();
+        if (fParents) delete parents;
+        else 
+        {
+            fParents = parents;
+            fParentsTime = (Long_t) time(0);
+        }
+        fMutex->UnLock();
+    }
+
+    // look for the calibration
+    fMutex->Lock();
+    TNamed* p = fParents ? (TNamed*) fParents->FindObject(calibration) : 0;
+    TString parent = p ? p->GetTitle() : "";
+    fMutex->UnLock();
+
+    return parent;
+}
+
+//______________________________________________________________________________
+TSQLStatement* TCMySQLManager::PrepareStatement(const Char_t* type, const Char_t* table, Int_t length,
+                                                Int_t nSet, TString* outSQL)
+{
+    // Prepare a statement of the type 'type' for 'length' parameters of the 
+    // data table 'table'. The supported types and their bound parameters are
+    //   "read"   : calibration, first_run (result: the parameters)
+    //   "write"  : parameters, calibration, 'nSet' first_run values
+    //   "insert" : calibration, description, first_run, last_run, parameters
+    // The parameters are one packed BLOB for tables using the packed layout
+    // (see IsPackedTable()) and 'length' columns otherwise (see SetParameters()
+    // and GetParameters()).
+    // The SQL of the statements is built once per table and cached. It is 
+    // saved to 'outSQL' if non-zero.
+    // Return 0 if an error occurred.
+    // NOTE: the statement must be destroyed by the caller.
+
+    // check server connection
+    if (!IsConnected())
+    {
+        if (!fSilence) Error("PrepareStatement", "No connection to the database!");
+        return 0;
+    }
+
+    // get the parameter layout
+    Bool_t packed = IsPackedTable(table);
+    Int_t nCol = packed ? 1 : length;
+
+    // look for the cached SQL
+    TString key = TString::Format("%s:%s:%d:%d", type, table, packed ? -1 : length, nSet);
+    fMutex->Lock();
+    TNamed* sql = (TNamed*) fStatements->FindObject(key.Data());
+    
+    // build the SQL
+    if (!sql)
+    {
+        TString q;
+        Char_t tmp[32];
+        if (!strcmp(type, "read"))
+        {
+            q = "SELECT ";
+            if (packed) q.Append("par");
+            else
+            {
+                for (Int_t i = 0; i < length; i++)
+                {
+                    sprintf(tmp, i ? ",par_%03d" : "par_%03d", i);
+                    q.Append(tmp);
+                }
+            }
+            q.Append(TString::Format(" FROM %s WHERE calibration = ? AND first_run = ?", table));
+        }
+        else if (!strcmp(type, "write"))
+        {
+            q = TString::Format("UPDATE %s SET ", table);
+            if (packed) q.Append("par = ?");
+            else
+            {
+                for (Int_t i = 0; i < length; i++)
+                {
+                    sprintf(tmp, i ? ",par_%03d = ?" : "par_%03d = ?", i);
+                    q.Append(tmp);
+                }
+            }
+            if (nSet == 1) q.Append(" WHERE calibration = ? AND first_run = ?");
+            else
+            {
+                q.Append(" WHERE calibration = ? AND first_run IN (");
+                for (Int_t i = 0; i < nSet; i++) q.Append(i ? ",?" : "?");
+                q.Append(")");
+            }
+        }
+        else if (!strcmp(type, "insert"))
+        {
+            q = TString::Format("INSERT INTO %s (calibration,description,first_run,last_run", table);
+            if (packed) q.Append(",par");
+            else
+            {
+                for (Int_t i = 0; i < length; i++)
+                {
+                    sprintf(tmp, ",par_%03d", i);
+                    q.Append(tmp);
+                }
+            }
+            q.Append(") VALUES (?,?,?,?");
+            for (Int_t i = 0; i < nCol; i++) q.Append(",?");
+            q.Append(")");
+        }
+        else
+        {
+            fMutex->UnLock();
+            if (!fSilence) Error("PrepareStatement", "Unknown statement type '%s'!", type);
+            return 0;
+        }
+
+        // cache the SQL
+        sql = new TNamed(key.Data(), q.Data());
+        fStatements->Add(sql);
+    }
+    TString sqlText = sql->GetTitle();
+    fMutex->UnLock();
+    if (outSQL) *outSQL = sqlText;
+
+    // prepare the statement
+    TSQLStatement* stmt = GetConnection()->Statement(sqlText.Data(), 1024);
+    if (!stmt && !fSilence) Error("PrepareStatement", "Could not prepare the statement '%s'!", key.Data());
+
+    return stmt;
+}
+
+//______________________________________________________________________________
+TString TCMySQLManager::GetParameterColumns(const Char_t* table, Int_t length)
+{
+    // Return the comma-separated list of the parameter columns of the data
+    // table 'table' for 'length' parameters (see IsPackedTable()).
+
+    // packed layout
+    if (IsPackedTable(table)) return "par";
+
+    // one column per parameter
+    TString cols;
+    Char_t tmp[32];
+    for (Int_t i = 0; i < length; i++)
+    {
+        sprintf(tmp, i ? ",par_%03d" : "par_%03d", i);
+        cols.Append(tmp);
+    }
+
+    return cols;
+}
+
+//______________________________________________________________________________
+TList* TCMySQLManager::GetColumns(const Char_t* table)
+{
+    // Return the list of the column names of the table 'table'.
+    // Return 0 if an error occurred.
+    // NOTE: the returned list must be destroyed by the caller.
+
+    // read the columns
+    TSQLResult* res = SendQuery(fBackend->GetColumnsQuery(table).Data());
+    if (!res) return 0;
+
+    // collect the column names
+    TList* list = new TList();
+    list->SetOwner(kTRUE);
+    Int_t field = fBackend->GetColumnNameField();
+    TSQLRow* row;
+    while ((row = res->Next()))
+    {
+        list->Add(new TObjString(GetField(row, field)));
+        delete row;
+    }
+
+    // clean-up
+    delete res;
+
+    return list;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::ContainsTable(const Char_t* table)
+{
+    // Check if the table 'table' exists in the database, e.g. the table of
+    // the parent calibrations that is missing in databases of version < 6.
+    // The result is cached with the table layouts until the table 
+    // definitions change.
+
+    // look for the cached result
+    TString key = TString::Format("exists/%s", table);
+    fMutex->Lock();
+    TNamed* layout = (TNamed*) fTableLayouts->FindObject(key.Data());
+    Bool_t cached = layout ? kTRUE : kFALSE;
+    Bool_t exists = layout && !strcmp(layout->GetTitle(), "yes") ? kTRUE : kFALSE;
+    fMutex->UnLock();
+    if (cached) return exists;
+
+    // look for the table
+    TSQLResult* res = SendQuery(fBackend->GetTableQuery(table).Data());
+    if (!res) return kFALSE;
+    TSQLRow* row = res->Next();
+    exists = row ? kTRUE : kFALSE;
+    if (row) delete row;
+    delete res;
+
+    // cache the result
+    fMutex->Lock();
+    if (!fTableLayouts->FindObject(key.Data())) 
+        fTableLayouts->Add(new TNamed(key.Data(), exists ? "yes" : "no"));
+    fMutex->UnLock();
+
+    return exists;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::IsPackedTable(const Char_t* table)
+{
+    // Check if the data table 'table' stores the parameters packed in the 
+    // BLOB column 'par' (database version 5) instead of one column per 
+    // parameter. The result is cached until the table definitions change.
+
+    // look for the cached layout
+    fMutex->Lock();
+    TNamed* layout = (TNamed*) fTableLayouts->FindObject(table);
+    Bool_t cached = layout ? kTRUE : kFALSE;
+    Bool_t packed = layout && !strcmp(layout->GetTitle(), "packed") ? kTRUE : kFALSE;
+    fMutex->UnLock();
+    if (cached) return packed;
+
+    // look for the packed parameter column
+    if (TList* columns = GetColumns(table))
+    {
+        packed = columns->FindObject("par") ? kTRUE : kFALSE;
+        delete columns;
+    }
+
+    // cache the layout
+    fMutex->Lock();
+    if (!fTableLayouts->FindObject(table)) 
+        fTableLayouts->Add(new TNamed(table, packed ? "packed" : "columns"));
+    fMutex->UnLock();
+
+    return packed;
+}
+
+//______________________________________________________________________________
+void TCMySQLManager::SetParameters(TSQLStatement* stmt, Int_t first, Bool_t packed,
+                                   const Double_t* par, Int_t length)
+{
+    // Bind the 'length' parameters 'par' to the statement 'stmt' starting at
+    // the statement parameter 'first', either as one packed little-endian
+    // double BLOB if 'packed' is kTRUE or as 'length' doubles otherwise.
+
+    if (packed)
+    {
+        UChar_t* buf = new UChar_t[8*length];
+        TCUtils::PackDoubles(par, length, buf);
+        stmt->SetBinary(first, buf, 8*length, 8*length);
+        delete [] buf;
+    }
+    else
+    {
+        for (Int_t i = 0; i < length; i++) stmt->SetDouble(first+i, par[i]);
+    }
+}
+
+//______________________________________________________________________________
+void TCMySQLManager::GetParameters(TSQLStatement* stmt, Int_t first, Bool_t packed,
+                                   Double_t* par, Int_t length)
+{
+    // Read 'length' parameters from the current result row of the statement 
+    // 'stmt' starting at the field 'first' to 'par', either from one packed 
+    // little-endian double BLOB if 'packed' is kTRUE or from 'length' double
+    // fields otherwise. Missing packed parameters are set to 0.
+
+    if (packed)
+    {
+        void* mem = 0;
+        Long_t size = 0;
+        Int_t n = 0;
+        if (stmt->GetBinary(first, mem, size) && mem) 
+        {
+            n = TMath::Min(length, (Int_t) (size / 8));
+            TCUtils::UnpackDoubles((const UChar_t*) mem, n, par);
+        }
+        for (Int_t i = n; i < length; i++) par[i] = 0;
+    }
+    else
+    {
+        for (Int_t i = 0; i < length; i++) par[i] = stmt->GetDouble(first+i);
+    }
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::PackDataTable(const Char_t* table)
+{
+    // Convert the data table 'table' from one column per parameter to the 
+    // packed BLOB column 'par' (database version 5). The parameters of all
+    // sets are packed in one transaction keeping their change times.
+    // Return kTRUE on success, otherwise kFALSE.
+
+    // count the parameter columns
+    TList* columns = GetColumns(table);
+    if (!columns)
+    {
+        Error("PackDataTable", "Could not read the columns of the table '%s'!", table);
+        return kFALSE;
+    }
+    Int_t nPar = 0;
+    TIter nextCol(columns);
+    TObject* col;
+    while ((col = nextCol()))
+        if (TString(col->GetName()).BeginsWith("par_")) nPar++;
+    delete columns;
+
+    // add the packed parameter column
+    TSQLResult* res = SendQuery(TString::Format("ALTER TABLE %s ADD par BLOB AFTER changed", table).Data());
+    if (!res)
+    {
+        Error("PackDataTable", "Could not add the packed parameter column to the table '%s'!", table);
+        return kFALSE;
+    }
+    delete res;
+
+    // read all sets
+    TString sel("SELECT calibration, first_run");
+    Char_t tmp[32];
+    for (Int_t i = 0; i < nPar; i++)
+    {
+        sprintf(tmp, ",par_%03d", i);
+        sel.Append(tmp);
+    }
+    sel.Append(TString::Format(" FROM %s", table));
+    Bool_t trans = StartTransaction();
+    TSQLStatement* in = trans ? GetConnection()->Statement(sel.Data()) : 0;
+    TSQLStatement* out = trans ? GetConnection()->Statement(TString::Format("UPDATE %s SET par = ?, changed = changed "
+                                                                            "WHERE calibration = ? AND first_run = ?",
+                                                                            table).Data(), 1024) : 0;
+
+    // pack the parameters of all sets
+    Bool_t ok = kFALSE;
+    Int_t nSet = 0;
+    if (in && out && in->Process() && in->StoreResult())
+    {
+        Double_t* par = new Double_t[nPar];
+        ok = kTRUE;
+        while (in->NextResultRow())
+        {
+            GetParameters(in, 2, kFALSE, par, nPar);
+            if (!out->NextIteration())
+            {
+                ok = kFALSE;
+                break;
+            }
+            SetParameters(out, 0, kTRUE, par, nPar);
+            out->SetString(1, in->GetString(0));
+            out->SetInt(2, in->GetInt(1));
+            nSet++;
+        }
+        if (ok) ok = out->Process();
+        delete [] par;
+    }
+
+    // clean-up
+    if (in) delete in;
+    if (out) delete out;
+
+    // finish the transaction
+    if (trans)
+    {
+        if (ok) ok = CommitTransaction();
+        else RollbackTransaction();
+    }
+
+    // remove the packed parameter column again if an error occurred
+    if (!ok)
+    {
+        Error("PackDataTable", "Could not pack the parameters of the table '%s'!", table);
+        res = SendQuery(TString::Format("ALTER TABLE %s DROP par", table).Data());
+        if (res) delete res;
+        return kFALSE;
+    }
+
+    // remove the old parameter columns
+    TString drop = TString::Format("ALTER TABLE %s ", table);
+    for (Int_t i = 0; i < nPar; i++)
+    {
+        sprintf(tmp, i ? ",DROP par_%03d" : "DROP par_%03d", i);
+        drop.Append(tmp);
+    }
+    if (nPar)
+    {
+        res = SendQuery(drop.Data());
+        if (!res)
+        {
+            Error("PackDataTable", "Could not remove the old parameter columns of the table '%s'!", table);
+            return kFALSE;
+        }
+        delete res;
+    }
+
+    // user information
+    Info("PackDataTable", "Packed %d parameters of %d sets in the table '%s'", nPar, nSet, table);
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::IsConnected()
+{
+    // Check if the connection to the database is open.
+
+    if (!fDB)
+    {
+        if (!fSilence) Error("IsConnected", "Cannot access database!");
+        return kFALSE;
+    }
+    else
+        return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::SearchTable(const Char_t* data, Char_t* outTableName)
+{
+    // Search the table name of the calibration quantity 'data' and write it
+    // to 'outTableName'.
+    // Return kTRUE when a true table was found, otherwise kFALSE.
+    
+    // get CaLib data
+    TCCalibData* d = (TCCalibData*) fData->FindObject(data);
+
+    // check data
+    if (d)
+    {
+        // copy table name
+        strcpy(outTableName, d->GetTableName());
+        return kTRUE;
+    }
+    else return kFALSE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::SearchRunEntry(Int_t run, const Char_t* name, Char_t* outInfo)
+{
+    // Search the information 'name' for the run 'run' and write it to 'outInfo'.
+    // Return kTRUE when the information was found, otherwise kFALSE.
+    
+    Char_t query[256];
+
+    // create the query
+    sprintf(query,
+            "SELECT %s FROM %s "
+            "WHERE run = %d",
+            name, TCConfig::kCalibMainTableName, run);
+
+    // read from database
+    TSQLResult* res = SendQuery(query);
+    
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("SearchRunEntry", "Could not find the information '%s' for run %d!",
+                                               name, run);
+        return kFALSE;
+    }
+    if (!res->GetRowCount())
+    {
+        if (!fSilence) Error("SearchRunEntry", "Could not find the information '%s' for run %d!",
+                                               name, run);
+        delete res;
+        return kFALSE;
+    }
+
+    // get row
+    TSQLRow* row = res->Next();
+  
+    // write the information
+    const Char_t* field = row->GetField(0);
+    if (!field) strcpy(outInfo, "");
+    else strcpy(outInfo, field);
+
+    // clean-up
+    delete row;
+    delete res;
+    
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::SearchSetEntry(const Char_t* data, const Char_t* calibration, Int_t set,
+                                      const Char_t* name, Char_t* outInfo)
+{
+    // Search the information 'name' for the calibration identifier 'calibration' and 
+    // the calibration data 'data' for the set number 'set' and write it to 'outInfo'.
+    // The sets of overlay calibrations are resolved using their parent calibrations.
+    // Return kTRUE when the information was found, otherwise kFALSE.
+  
+    Char_t query[256];
+    Char_t table[256];
+
+    // get the data table
+    if (!SearchTable(data, table))
+    {
+        if (!fSilence) Error("SearchSetEntry", "No data table found!");
+        return kFALSE;
+    }
+
+    // get the calibration of the sets
+    TCSetTable* sets = GetSetTable(data, calibration);
+    TString owner = sets ? sets->GetCalibration() : calibration;
+    if (sets) delete sets;
+
+    // create the query
+    sprintf(query,
+            "SELECT %s FROM %s WHERE "
+            "calibration = '%s' "
+            "ORDER BY first_run ASC LIMIT 1 OFFSET %d",
+            name, table, owner.Data(), set);
+
+    // read from database
+    TSQLResult* res = SendQuery(query);
+
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("SearchSetEntry", "No runset %d found in table '%s'!", set, table);
+        return kFALSE;
+    }
+    if (!res->GetRowCount())
+    {
+        if (!fSilence) Error("SearchSetEntry", "No runset %d found in table '%s'!", set, table);
+        return kFALSE;
+    }
+
+    // get data
+    TSQLRow* row = res->Next();
+    const Char_t* d = row->GetField(0);
+    if (!d) strcpy(outInfo, "");
+    else strcpy(outInfo, d);
+
+    // clean-up
+    delete row;
+    delete res;
+    
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::ChangeRunEntries(Int_t first_run, Int_t last_run, 
+                                        const Char_t* name, const Char_t* value)
+{
+    // Change the run entry 'name' for the runs 'first_run' to 'last_run' to 'value'.
+    
+    Char_t query[256];
+    
+    // check if first run is smaller than last run
+    if (first_run > last_run)
+    {
+        if (!fSilence) Error("ChangeRunEntries", "First run of has to be smaller than last run!");
+        return kFALSE;
+    }
+
+    // create the query
+    sprintf(query,
             "UPDATE %s SET %s = '%s' "
-            "WHERE calibration = '%s' AND "
-            "first_run = %d",
-            table, name, value, calibration, first_run);
+            "WHERE run >= %d AND"
+            "      run <= %d",
+            TCConfig::kCalibMainTableName, name, value, first_run, last_run);
 
     // read from database
     TSQLResult* res = SendQuery(query);
@@ -550,55 +1989,83 @@ Bool_t TCMySQLManager::ChangeSetEntry(const Char_t* data, const Char_t* calibrat
     // check result
     if (!res)
     {
-        if (!fSilence) Error("ChangeSetEntry", "Could not set the information '%s' for set %d of '%s' to '%s'!",
-                                               name, set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), value);
+        if (!fSilence) Error("ChangeRunEntries", "Could not set the information '%s' for runs %d to %d to '%s'!",
+                                                 name, first_run, last_run, value);
         return kFALSE;
     }
 
     // clean-up
     delete res;
- 
+    
     return kTRUE;
 }
 
 //______________________________________________________________________________
-Int_t TCMySQLManager::GetNsets(const Char_t* data, const Char_t* calibration)
+Bool_t TCMySQLManager::ChangeSetEntry(const Char_t* data, const Char_t* calibration, Int_t set,
+                                      const Char_t* name, const Char_t* value)
 {
-    // Get the number of runsets for the calibration identifier 'calibration'
-    // and the calibration data 'data'.
-
+    // Change the information 'name' of the 'set'-th set of the calibration 'calibration'
+    // for the calibration data 'data' to 'value'.
+    
     Char_t query[256];
     Char_t table[256];
 
     // get the data table
     if (!SearchTable(data, table))
     {
-        if (!fSilence) Error("GetNsets", "No data table found!");
+        if (!fSilence) Error("ChangeSetEntry", "No data table found!");
         return 0;
     }
 
+    // copy inherited sets of overlay calibrations
+    if (!MaterializeDataSets(data, calibration)) return kFALSE;
+    
+    // get the first run of the set
+    Int_t first_run = GetFirstRunOfSet(data, calibration, set);
+
     // create the query
     sprintf(query,
-            "SELECT first_run FROM %s WHERE "
-            "calibration = '%s' "
-            "ORDER BY first_run ASC",
-            table, calibration);
+            "UPDATE %s SET %s = '%s' "
+            "WHERE calibration = '%s' AND "
+            "first_run = %d",
+            table, name, value, calibration, first_run);
 
     // read from database
     TSQLResult* res = SendQuery(query);
-
+    
     // check result
     if (!res)
     {
-        if (!fSilence) Error("GetNsets", "No runsets found in table '%s'!", table);
-        return 0;
+        if (!fSilence) Error("ChangeSetEntry", "Could not set the information '%s' for set %d of '%s' to '%s'!",
+                                               name, set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), value);
+        return kFALSE;
     }
 
-    // count rows
-    Int_t rows = res->GetRowCount();
+    // clean-up
     delete res;
+ 
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Int_t TCMySQLManager::GetNsets(const Char_t* data, const Char_t* calibration)
+{
+    // Get the number of runsets for the calibration identifier 'calibration'
+    // and the calibration data 'data'.
+
+    // get the sets
+    TCSetTable* sets = GetSetTable(data, calibration);
+    if (!sets)
+    {
+        if (!fSilence) Error("GetNsets", "Could not read the runsets!");
+        return 0;
+    }
+    Int_t nSet = sets->GetNSet();
+
+    // clean-up
+    delete sets;
 
-    return rows;
+    return nSet;
 }
 
 //______________________________________________________________________________
@@ -607,15 +2074,19 @@ Int_t TCMySQLManager::GetFirstRunOfSet(const Char_t* data, const Char_t* calibra
     // Get the first run of the runsets 'set' for the calibration identifier
     // 'calibration' and the calibration data 'data'.
 
-    Char_t tmp[256];
-
     // get the data
-    if (SearchSetEntry(data, calibration, set, "first_run", tmp)) return atoi(tmp);
+    TCSetTable* sets = GetSetTable(data, calibration);
+    Int_t run = 0;
+    if (sets && set >= 0 && set < sets->GetNSet()) run = sets->GetFirstRun(set);
     else 
     {
         if (!fSilence) Error("GetFirstRunOfSet", "Could not find first run of set!");
-        return 0;
     }
+
+    // clean-up
+    if (sets) delete sets;
+
+    return run;
 }
 
 //______________________________________________________________________________
@@ -624,15 +2095,19 @@ Int_t TCMySQLManager::GetLastRunOfSet(const Char_t* data, const Char_t* calibrat
     // Get the last run of the runsets 'set' for the calibration identifier
     // 'calibration' and the calibration data 'data'.
 
-    Char_t tmp[256];
-
     // get the data
-    if (SearchSetEntry(data, calibration, set, "last_run", tmp)) return atoi(tmp);
+    TCSetTable* sets = GetSetTable(data, calibration);
+    Int_t run = 0;
+    if (sets && set >= 0 && set < sets->GetNSet()) run = sets->GetLastRun(set);
     else 
     {
         if (!fSilence) Error("GetLastRunOfSet", "Could not find last run of set!");
-        return 0;
     }
+
+    // clean-up
+    if (sets) delete sets;
+
+    return run;
 }
 
 //______________________________________________________________________________
@@ -642,14 +2117,16 @@ void TCMySQLManager::GetDescriptionOfSet(const Char_t* data, const Char_t* calib
     // Get the description of the runsets 'set' for the calibration identifier
     // 'calibration' and the calibration data 'data'.
 
-    Char_t tmp[256];
-
     // get the data
-    if (SearchSetEntry(data, calibration, set, "description", tmp)) strcpy(outDesc, tmp);
+    TCSetTable* sets = GetSetTable(data, calibration);
+    if (sets && set >= 0 && set < sets->GetNSet()) strcpy(outDesc, sets->GetDescription(set));
     else 
     {
         if (!fSilence) Error("GetDescriptionOfSet", "Could not find description of set!");
     }
+
+    // clean-up
+    if (sets) delete sets;
 }
 
 //______________________________________________________________________________
@@ -659,14 +2136,16 @@ void TCMySQLManager::GetChangeTimeOfSet(const Char_t* data, const Char_t* calibr
     // Get the change time of the runsets 'set' for the calibration identifier
     // 'calibration' and the calibration data 'data'.
 
-    Char_t tmp[256];
-
     // get the data
-    if (SearchSetEntry(data, calibration, set, "changed", tmp)) strcpy(outTime, tmp);
+    TCSetTable* sets = GetSetTable(data, calibration);
+    if (sets && set >= 0 && set < sets->GetNSet()) strcpy(outTime, sets->GetChangeTime(set));
     else 
     {
         if (!fSilence) Error("GetChangeTimeOfSet", "Could not find change time of set!");
     }
+
+    // clean-up
+    if (sets) delete sets;
 }
 
 //______________________________________________________________________________
@@ -742,31 +2221,31 @@ Int_t TCMySQLManager::GetSetForRun(const Char_t* data, const Char_t* calibration
     // identifier 'calibration' the run 'run' belongs to.
     // Return -1 if there is no such set.
 
-    // get number of sets
-    Int_t nSet = GetNsets(data, calibration);
-    if (!nSet) return -1;
+    // get the sets
+    TCSetTable* sets = GetSetTable(data, calibration);
+    if (!sets) return -1;
+    if (!sets->GetNSet())
+    {
+        delete sets;
+        return -1;
+    }
     
     // check if run exists
     Char_t tmp[256];
     if (!SearchRunEntry(run, "run", tmp))
     {
         if (!fSilence) Error("GetSetForRun", "Run has no valid run number!");
+        delete sets;
         return -1;
     }
  
-    // loop over sets
-    for (Int_t i = 0; i < nSet; i++)
-    {
-        // get first and last run
-        Int_t first_run = GetFirstRunOfSet(data, calibration, i);
-        Int_t last_run = GetLastRunOfSet(data, calibration, i);
+    // search the set
+    Int_t set = sets->FindSet(run);
 
-        // check if run is in this set
-        if (run >= first_run && run <= last_run) return i;
-    }
+    // clean-up
+    delete sets;
 
-    // no set found here
-    return -1;
+    return set;
 }
 
 //______________________________________________________________________________
@@ -798,9 +2277,11 @@ Bool_t TCMySQLManager::ReadParameters(const Char_t* data, const Char_t* calibrat
 {
     // Read 'length' parameters of the 'set'-th set of the calibration data 'data'
     // for the calibration identifier 'calibration' from the database to the value array 'par'.
+    // The sets of overlay calibrations are resolved using their parent calibrations.
+    // Cached parameters are used if the change time of the set did not change
+    // (see ReadParametersRuns()).
     // Return kFALSE if an error occurred, otherwise kTRUE.
 
-    Char_t query[256];
     Char_t table[256];
 
     // get the data table
@@ -810,50 +2291,78 @@ Bool_t TCMySQLManager::ReadParameters(const Char_t* data, const Char_t* calibrat
         return kFALSE;
     }
 
-    // get the first run of the set
-    Int_t first_run = GetFirstRunOfSet(data, calibration, set);
+    // get the sets
+    TCSetTable* sets = GetSetTable(data, calibration);
 
-    // check first run
-    if (!first_run)
+    // check the set
+    if (!sets || set < 0 || set >= sets->GetNSet())
     {
         if (!fSilence) Error("ReadParameters", "No calibration found for set %d of '%s'!", 
                              set, ((TCCalibData*) fData->FindObject(data))->GetTitle());
+        if (sets) delete sets;
         return kFALSE;
     }
+    Int_t first_run = sets->GetFirstRun(set);
+    TString changed = sets->GetChangeTime(set);
+    TString owner = sets->GetCalibration();
+    Bool_t trusted = (Long_t) time(0) - sets->GetLoadTime() < fCacheTrust;
+    delete sets;
 
-    // create the query
-    sprintf(query,
-            "SELECT * FROM %s WHERE "
-            "calibration = '%s' AND "
-            "first_run = %d",
-            table, calibration, first_run);
+    // look for cached parameters that are still valid (the change time of
+    // the set is read again unless the set table is trusted)
+    if (fParCache->Get(table, owner.Data(), first_run, changed.Data(), par, length))
+    {
+        TString current = changed;
+        if (trusted || (ReadChangeTimes(table, owner.Data(), 1, &first_run, &current) && 
+                        current == changed))
+        {
+            if (!fSilence) Info("ReadParameters", "Read %d parameters of '%s' from the cache", 
+                                length, ((TCCalibData*) fData->FindObject(data))->GetTitle());
+            return kTRUE;
+        }
 
-    // read from database
-    TSQLResult* res = SendQuery(query);
+        // the set was changed by another client
+        changed = current;
+        ClearSetTables(table);
+    }
 
-    // check result
-    if (!res)
+    // prepare the statement
+    TString sql;
+    TSQLStatement* stmt = PrepareStatement("read", table, length, 1, &sql);
+    if (!stmt)
     {
-        if (!fSilence) Error("ReadParameters", "No calibration found for set %d of '%s'!", 
-                             set, ((TCCalibData*) fData->FindObject(data))->GetTitle());
+        if (!fSilence) Error("ReadParameters", "Could not read parameters of '%s'!",
+                             ((TCCalibData*) fData->FindObject(data))->GetTitle());
         return kFALSE;
     }
-    else if (!res->GetRowCount())
+
+    // read from database
+    Bool_t found = kFALSE;
+    if (stmt->NextIteration())
+    {
+        stmt->SetString(0, owner.Data());
+        stmt->SetInt(1, first_run);
+        if (ProcessStatement(stmt, sql.Data(), kTRUE) && stmt->NextResultRow())
+        {
+            GetParameters(stmt, 0, IsPackedTable(table), par, length);
+            found = kTRUE;
+        }
+    }
+
+    // clean-up
+    delete stmt;
+
+    // check result
+    if (!found)
     {
         if (!fSilence) Error("ReadParameters", "No calibration found for set %d of '%s'!", 
                              set, ((TCCalibData*) fData->FindObject(data))->GetTitle());
-        delete res;
         return kFALSE;
     }
 
-    // get data (parameters start at field 5)
-    TSQLRow* row = res->Next();
-    for (Int_t i = 0; i < length; i++) par[i] = atof(row->GetField(i+5));
+    // cache the parameters
+    fParCache->Set(table, owner.Data(), first_run, changed.Data(), par, length);
 
-    // clean-up
-    delete row;
-    delete res;
-    
     // user information
     if (!fSilence) Info("ReadParameters", "Read %d parameters of '%s' from the database", 
                         length, ((TCCalibData*) fData->FindObject(data))->GetTitle());
@@ -861,6 +2370,246 @@ Bool_t TCMySQLManager::ReadParameters(const Char_t* data, const Char_t* calibrat
     return kTRUE;
 }
 
+//______________________________________________________________________________
+TCRunParameters* TCMySQLManager::ReadParametersRuns(const Char_t* calibration, 
+                                                    Int_t nData, const Char_t* const* data,
+                                                    Int_t nRun, const Int_t* runs)
+{
+    // Read the parameters of the 'nData' calibration data 'data' for the 
+    // calibration identifier 'calibration' valid for the 'nRun' runs 'runs'.
+    // The sets of the runs are resolved using the cached set tables and 
+    // every needed set that is not in the parameter cache is read only once
+    // using a single query per data. The change times of the cached sets 
+    // are checked using a single query per data before they are used unless
+    // the set table was read less than fCacheTrust seconds ago.
+    // Runs without set have the set -1 and no parameters.
+    // NOTE: the returned object must be destroyed by the caller.
+
+    Char_t table[256];
+
+    // create the parameter table
+    TCRunParameters* params = new TCRunParameters(nData, data, nRun, runs);
+
+    // loop over calibration data
+    for (Int_t i = 0; i < nData; i++)
+    {
+        // get the calibration data and its table
+        TCCalibData* d = (TCCalibData*) fData->FindObject(data[i]);
+        if (!d || !SearchTable(data[i], table))
+        {
+            if (!fSilence) Error("ReadParametersRuns", "No data table found for '%s'!", data[i]);
+            continue;
+        }
+
+        // get the sets
+        TCSetTable* sets = GetSetTable(data[i], calibration);
+        if (!sets) continue;
+        TString owner = sets->GetCalibration();
+        params->SetData(i, d->GetSize(), sets->GetNSet());
+
+        // resolve the sets of the runs
+        Bool_t* needed = new Bool_t[sets->GetNSet()];
+        for (Int_t j = 0; j < sets->GetNSet(); j++) needed[j] = kFALSE;
+        Int_t nNeeded = 0;
+        for (Int_t j = 0; j < nRun; j++)
+        {
+            Int_t set = sets->FindSet(runs[j]);
+            params->SetSetOfRun(i, j, set);
+            if (set == -1)
+            {
+                if (!fSilence) Error("ReadParametersRuns", "No set of '%s' found for run %d",
+                                     d->GetTitle(), runs[j]);
+            }
+            else if (!needed[set])
+            {
+                needed[set] = kTRUE;
+                nNeeded++;
+            }
+        }
+
+        // take the sets found in the parameter cache
+        Int_t nPar = d->GetSize();
+        Double_t* par = new Double_t[nPar];
+        TString* changed = new TString[sets->GetNSet()];
+        Int_t* hitRun = new Int_t[sets->GetNSet()];
+        Int_t* hitSet = new Int_t[sets->GetNSet()];
+        Int_t nCached = 0;
+        for (Int_t j = 0; j < sets->GetNSet(); j++)
+        {
+            changed[j] = sets->GetChangeTime(j);
+            if (!needed[j]) continue;
+            if (fParCache->Get(table, owner.Data(), sets->GetFirstRun(j), changed[j].Data(), par, nPar))
+            {
+                params->SetParameters(i, j, par);
+                needed[j] = kFALSE;
+                nNeeded--;
+                hitRun[nCached] = sets->GetFirstRun(j);
+                hitSet[nCached++] = j;
+            }
+        }
+
+        // check the current change times of the cached sets using a single
+        // query unless the set table is trusted
+        if (nCached && (Long_t) time(0) - sets->GetLoadTime() >= fCacheTrust)
+        {
+            TString* current = new TString[nCached];
+            Bool_t valid = ReadChangeTimes(table, owner.Data(), nCached, hitRun, current);
+            Int_t nValid = 0;
+            for (Int_t j = 0; j < nCached; j++)
+            {
+                // read sets changed by other clients again
+                Int_t set = hitSet[j];
+                if (!valid || current[j] != changed[set])
+                {
+                    if (valid) changed[set] = current[j];
+                    params->ClearParameters(i, set);
+                    needed[set] = kTRUE;
+                    nNeeded++;
+                }
+                else nValid++;
+            }
+            if (nValid < nCached) ClearSetTables(table);
+            nCached = nValid;
+            delete [] current;
+        }
+        delete [] hitRun;
+        delete [] hitSet;
+
+        // check if some sets are needed
+        if (!nNeeded)
+        {
+            if (!fSilence && nCached) Info("ReadParametersRuns", "Read %d sets of '%s' for %d runs from the cache", 
+                                           nCached, d->GetTitle(), nRun);
+            delete [] par;
+            delete [] needed;
+            delete [] changed;
+            delete sets;
+            continue;
+        }
+
+        // create the query
+        Bool_t packed = IsPackedTable(table);
+        TString query("SELECT first_run");
+        Char_t tmp[32];
+        if (packed) query.Append(",par");
+        else
+        {
+            for (Int_t j = 0; j < nPar; j++)
+            {
+                sprintf(tmp, ",par_%03d", j);
+                query.Append(tmp);
+            }
+        }
+        query.Append(TString::Format(" FROM %s WHERE calibration = '%s' AND first_run IN (",
+                                     table, owner.Data()));
+        Bool_t first = kTRUE;
+        for (Int_t j = 0; j < sets->GetNSet(); j++)
+        {
+            if (!needed[j]) continue;
+            if (!first) query.Append(",");
+            query.Append(TString::Format("%d", sets->GetFirstRun(j)));
+            first = kFALSE;
+        }
+        query.Append(")");
+
+        // clean-up
+        delete [] needed;
+
+        // read from database
+        TSQLStatement* stmt = IsConnected() ? GetConnection()->Statement(query.Data()) : 0;
+
+        // check result
+        if (!stmt || !ProcessStatement(stmt, query.Data(), kTRUE))
+        {
+            if (!fSilence) Error("ReadParametersRuns", "No calibration found for '%s'!", d->GetTitle());
+            if (stmt) delete stmt;
+            delete [] par;
+            delete [] changed;
+            delete sets;
+            continue;
+        }
+
+        // read the parameters of the sets
+        Int_t nRead = 0;
+        while (stmt->NextResultRow())
+        {
+            // get the set
+            Int_t set = sets->FindSet(stmt->GetInt(0));
+            if (set != -1)
+            {
+                GetParameters(stmt, 1, packed, par, nPar);
+                params->SetParameters(i, set, par);
+                fParCache->Set(table, owner.Data(), sets->GetFirstRun(set), changed[set].Data(), par, nPar);
+                nRead++;
+            }
+        }
+
+        // clean-up
+        delete [] par;
+        delete [] changed;
+        delete stmt;
+        delete sets;
+    
+        // user information
+        if (!fSilence) Info("ReadParametersRuns", "Read %d sets of '%s' for %d runs from the database "
+                            "and %d from the cache", nRead, d->GetTitle(), nRun, nCached);
+    }
+
+    return params;
+}
+
+//______________________________________________________________________________
+TCRunParameters* TCMySQLManager::ReadParametersRunRange(const Char_t* calibration,
+                                                        Int_t nData, const Char_t* const* data,
+                                                        Int_t first_run, Int_t last_run)
+{
+    // Read the parameters of the 'nData' calibration data 'data' for the 
+    // calibration identifier 'calibration' valid for all runs from 'first_run'
+    // to 'last_run' (see ReadParametersRuns()).
+    // NOTE: the returned object must be destroyed by the caller.
+
+    Char_t query[256];
+
+    // create the query
+    sprintf(query,
+            "SELECT run FROM %s "
+            "WHERE run >= %d AND run <= %d "
+            "ORDER BY run",
+            TCConfig::kCalibMainTableName, first_run, last_run);
+
+    // read from database
+    TSQLResult* res = SendQuery(query);
+
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("ReadParametersRunRange", "Could not read the runs %d to %d!",
+                             first_run, last_run);
+        return 0;
+    }
+
+    // read all runs
+    Int_t nRun = res->GetRowCount();
+    Int_t* runs = new Int_t[nRun];
+    for (Int_t i = 0; i < nRun; i++)
+    {
+        TSQLRow* row = res->Next();
+        runs[i] = atoi(row->GetField(0));
+        delete row;
+    }
+
+    // clean-up
+    delete res;
+
+    // read the parameters
+    TCRunParameters* params = ReadParametersRuns(calibration, nData, data, nRun, runs);
+
+    // clean-up
+    delete [] runs;
+
+    return params;
+}
+
 //______________________________________________________________________________
 Bool_t TCMySQLManager::WriteParameters(const Char_t* data, const Char_t* calibration, Int_t set, 
                                        Double_t* par, Int_t length)
@@ -878,6 +2627,9 @@ Bool_t TCMySQLManager::WriteParameters(const Char_t* data, const Char_t* calibra
         return kFALSE;
     }
 
+    // copy inherited sets of overlay calibrations
+    if (!MaterializeDataSets(data, calibration)) return kFALSE;
+
     // get the first run of the set
     Int_t first_run = GetFirstRunOfSet(data, calibration, set);
 
@@ -889,26 +2641,32 @@ Bool_t TCMySQLManager::WriteParameters(const Char_t* data, const Char_t* calibra
         return kFALSE;
     }
 
-    // prepare the insert query
-    TString query = TString::Format("UPDATE %s SET ", table);
+    // prepare the statement
+    TString sql;
+    TSQLStatement* stmt = PrepareStatement("write", table, length, 1, &sql);
     
-    // read all parameters and write them to new query
-    for (Int_t j = 0; j < length; j++)
+    // write data to database
+    Bool_t ok = kFALSE;
+    if (stmt && stmt->NextIteration())
     {
-        // append parameter to query
-        query.Append(TString::Format("par_%03d = %.17g", j, par[j]));
-        if (j != length - 1) query.Append(",");
+        Bool_t packed = IsPackedTable(table);
+        Int_t nCol = packed ? 1 : length;
+        SetParameters(stmt, 0, packed, par, length);
+        stmt->SetString(nCol, calibration);
+        stmt->SetInt(nCol+1, first_run);
+        ok = ProcessStatement(stmt, sql.Data());
     }
-    
-    // finish query
-    query.Append(TString::Format(" WHERE calibration = '%s' AND first_run = %d",
-                                 calibration, first_run));
- 
-    // write data to database
-    TSQLResult* res = SendQuery(query.Data());
-    
+
+    // clean-up
+    if (stmt) delete stmt;
+
+    // the change time of the set was modified (a change within the same
+    // second would not be detected by the revalidation of the cached parameters)
+    ClearSetTables(table);
+    fParCache->Remove(table, calibration, first_run);
+
     // check result
-    if (!res)
+    if (!ok)
     {
         if (!fSilence) Error("WriteParameters", "Could not write parameters of '%s'!", 
                              ((TCCalibData*) fData->FindObject(data))->GetTitle());
@@ -916,17 +2674,132 @@ Bool_t TCMySQLManager::WriteParameters(const Char_t* data, const Char_t* calibra
     }
     else
     {
-        delete res;
         if (!fSilence) Info("WriteParameters", "Wrote %d parameters of '%s' to the database", 
                                                length, ((TCCalibData*) fData->FindObject(data))->GetTitle());
         return kTRUE;
     }
 }
 
+//______________________________________________________________________________
+Bool_t TCMySQLManager::WriteParametersSets(const Char_t* calibration, 
+                                           Int_t nData, const Char_t* const* data,
+                                           Int_t nSet, const Int_t* sets,
+                                           Double_t* const* par, Int_t length)
+{
+    // Write 'length' parameters of the 'nSet' sets 'sets' of the 'nData'
+    // calibration data 'data' for the calibration identifier 'calibration'.
+    // The values of the i-th calibration data are taken from the array 'par[i]'
+    // and written to all sets using a single statement per data table.
+    // All data are written in one transaction, i.e. either all or no sets
+    // are modified. Inherited sets of overlay calibrations are copied in the
+    // same transaction.
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    // check the sets
+    if (nData < 1 || nSet < 1)
+    {
+        if (!fSilence) Error("WriteParametersSets", "No calibration data or sets to write!");
+        return kFALSE;
+    }
+
+    // start the transaction
+    if (!StartTransaction()) return kFALSE;
+
+    // resolve the data tables and the first runs of the sets
+    Char_t* tables = new Char_t[nData*256];
+    Int_t* first_run = new Int_t[nData*nSet];
+    Bool_t ok = kTRUE;
+    for (Int_t i = 0; i < nData && ok; i++)
+    {
+        // get the data table
+        if (!SearchTable(data[i], tables + i*256))
+        {
+            if (!fSilence) Error("WriteParametersSets", "No data table found for '%s'!", data[i]);
+            ok = kFALSE;
+            break;
+        }
+
+        // copy inherited sets of overlay calibrations
+        if (!MaterializeDataSets(data[i], calibration))
+        {
+            ok = kFALSE;
+            break;
+        }
+
+        // get the first runs of the sets
+        TCSetTable* setTable = GetSetTable(data[i], calibration);
+        for (Int_t j = 0; j < nSet; j++)
+        {
+            if (!setTable || sets[j] < 0 || sets[j] >= setTable->GetNSet())
+            {
+                if (!fSilence) Error("WriteParametersSets", "Set %d of '%s' does not exist!", 
+                                     sets[j], ((TCCalibData*) fData->FindObject(data[i]))->GetTitle());
+                ok = kFALSE;
+                break;
+            }
+            first_run[i*nSet+j] = setTable->GetFirstRun(sets[j]);
+        }
+        if (setTable) delete setTable;
+    }
+
+    // write all data tables
+    for (Int_t i = 0; i < nData && ok; i++)
+    {
+        // prepare the statement
+        const Char_t* table = tables + i*256;
+        TString sql;
+        TSQLStatement* stmt = PrepareStatement("write", table, length, nSet, &sql);
+        
+        // write the sets
+        ok = kFALSE;
+        if (stmt && stmt->NextIteration())
+        {
+            Bool_t packed = IsPackedTable(table);
+            Int_t nCol = packed ? 1 : length;
+            SetParameters(stmt, 0, packed, par[i], length);
+            stmt->SetString(nCol, calibration);
+            for (Int_t j = 0; j < nSet; j++) stmt->SetInt(nCol+1+j, first_run[i*nSet+j]);
+            ok = ProcessStatement(stmt, sql.Data());
+        }
+
+        // clean-up
+        if (stmt) delete stmt;
+
+        if (!ok && !fSilence) Error("WriteParametersSets", "Could not write parameters of '%s'!", 
+                                    ((TCCalibData*) fData->FindObject(data[i]))->GetTitle());
+    }
+
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // the change times of the sets were modified
+    for (Int_t i = 0; ok && i < nData; i++)
+    {
+        ClearSetTables(tables + i*256);
+        for (Int_t j = 0; j < nSet; j++) 
+            fParCache->Remove(tables + i*256, calibration, first_run[i*nSet+j]);
+    }
+
+    // clean-up
+    delete [] tables;
+    delete [] first_run;
+
+    // user information
+    if (ok && !fSilence) 
+    {
+        for (Int_t i = 0; i < nData; i++)
+            Info("WriteParametersSets", "Wrote %d parameters of '%s' for %d sets to the database", 
+                 length, ((TCCalibData*) fData->FindObject(data[i]))->GetTitle(), nSet);
+    }
+
+    return ok;
+}
+
 //______________________________________________________________________________
 Bool_t TCMySQLManager::InitDatabase()
 {
-    // Init a new CaLib database on a MySQL server.
+    // Init a new CaLib database on the database server or in the database file.
     // Return kTRUE on success, otherwise kFALSE.
     
     // check server connection
@@ -952,6 +2825,9 @@ Bool_t TCMySQLManager::InitDatabase()
     // create the main table
     CreateMainTable();
 
+    // create the table of the parent calibrations
+    CreateParentTable();
+
     // create the data tables
     TIter next(fData);
     TCCalibData* d;
@@ -972,7 +2848,8 @@ Bool_t TCMySQLManager::UpgradeDatabase(Int_t version)
     
     // create queries (update only this part in the future)
     Int_t nQuery = 0;
-    Char_t query[3][256];
+    Char_t query[3][512];
+    Bool_t pack = kFALSE;
     switch (version)
     {
         // version 3: 
@@ -994,6 +2871,22 @@ Bool_t TCMySQLManager::UpgradeDatabase(Int_t version)
             strcpy(query[0], "ALTER TABLE run_main MODIFY scr_bad TEXT");
             break;
         }
+        // version 5:
+        // - store the parameters of the data tables packed in one BLOB
+        case 5:
+        {
+            pack = kTRUE;
+            break;
+        }
+        // version 6:
+        // - add the table of the parent calibrations of overlay calibrations
+        case 6:
+        {
+            nQuery = 1;
+            sprintf(query[0], "CREATE TABLE IF NOT EXISTS %s ( %s )", 
+                    TCConfig::kCalibParentTableName, TCConfig::kCalibParentTableFormat);
+            break;
+        }
         default:
         {
             Error("UpgradeDatabase", "Database upgrade to version %d not implemented!", version);
@@ -1008,6 +2901,13 @@ Bool_t TCMySQLManager::UpgradeDatabase(Int_t version)
         return kFALSE;
     }
 
+    // databases of other backends are always created using the latest version
+    if (strcmp(fBackend->GetType(), "mysql"))
+    {
+        Error("UpgradeDatabase", "Database upgrades are only supported by the MySQL backend!");
+        return kFALSE;
+    }
+
     // ask for user confirmation
     Char_t answer[256];
     printf("\nWARNING: You are about to update your existing CaLib database '%s' on '%s'\n"
@@ -1038,8 +2938,21 @@ Bool_t TCMySQLManager::UpgradeDatabase(Int_t version)
         }
     }
 
+    // pack the data tables
+    Bool_t packOk = kTRUE;
+    if (pack)
+    {
+        TIter next(fData);
+        TCCalibData* d;
+        while ((d = (TCCalibData*)next()))
+        {
+            if (IsPackedTable(d->GetTableName())) continue;
+            if (!PackDataTable(d->GetTableName())) packOk = kFALSE;
+        }
+    }
+
     // check final result
-    if (queryOk == nQuery)
+    if (queryOk == nQuery && packOk)
     {
         Info("UpgradeDatabase", "Performed upgrade of database");
         return kTRUE;
@@ -1056,7 +2969,8 @@ void TCMySQLManager::AddRunFiles(const Char_t* path, const Char_t* target,
                                  const Char_t* runPrefix)
 {
     // Look for raw ACQU files in 'path' and add all runs with the prefix 'runPrefix'
-    // to the database using the target specifier 'target'.
+    // to the database using the target specifier 'target'. The runs are written 
+    // in chunks using multi-row inserts (see InsertRows()).
 
     // read the raw files
     TCReadACQU r(path, runPrefix);
@@ -1075,46 +2989,55 @@ void TCMySQLManager::AddRunFiles(const Char_t* path, const Char_t* target,
         return;
     }
 
-    // loop over runs
-    Int_t nRunAdded = 0;
+    // prepare the values of the runs
+    TString* values = new TString[nRun];
     for (Int_t i = 0; i < nRun; i++)
     {
         TCACQUFile* f = r.GetFile(i);
         
-        // prepare the insert query
-        TString ins_query = TString::Format("INSERT INTO %s SET "
-                                            "run = %d, "
-                                            "path = \"%s\", "
-                                            "filename = \"%s\", "
-                                            "time = STR_TO_DATE(\"%s\", \"%%a %%b %%d %%H:%%i:%%S %%Y\"), "
-                                            "description = \"%s\", "
-                                            "run_note = \"%s\", "
-                                            "size = %lld,"
-                                            "target = \"%s\"",
-                                            TCConfig::kCalibMainTableName,
-                                            f->GetRun(),
-                                            path,
-                                            f->GetFileName(),
-                                            f->GetTime(),
-                                            f->GetDescription(),
-                                            f->GetRunNote(),
-                                            f->GetSize(),
-                                            target);
-
-        // try to write data to database
-        TSQLResult* res = SendQuery(ins_query.Data());
-        if (res == 0)
+        // convert the time of the file
+        TString runTime("NULL");
+        struct tm t;
+        memset(&t, 0, sizeof(t));
+        if (strptime(f->GetTime(), "%a %b %d %H:%M:%S %Y", &t))
         {
-            Warning("AddRunFiles", "Run %d of file '%s/%s' could not be added to the database!", 
-                    f->GetRun(), path, f->GetFileName());
+            Char_t tmp[32];
+            strftime(tmp, sizeof(tmp), "'%Y-%m-%d %H:%M:%S'", &t);
+            runTime = tmp;
         }
-        else
+
+        // prepare the values
+        values[i] = TString::Format("%d, %s, %s, %s, %s, %s, %lld, %s",
+                                    f->GetRun(),
+                                    fBackend->Quote(path).Data(),
+                                    fBackend->Quote(f->GetFileName()).Data(),
+                                    runTime.Data(),
+                                    fBackend->Quote(f->GetDescription()).Data(),
+                                    fBackend->Quote(f->GetRunNote()).Data(),
+                                    f->GetSize(),
+                                    fBackend->Quote(target).Data());
+    }
+
+    // write the runs to the database
+    Bool_t* ok = new Bool_t[nRun];
+    Int_t nRunAdded = InsertRows(TCConfig::kCalibMainTableName,
+                                 "run, path, filename, time, description, run_note, size, target",
+                                 nRun, values, ok);
+    
+    // report the runs that could not be added
+    for (Int_t i = 0; i < nRun; i++)
+    {
+        if (!ok[i])
         {
-            nRunAdded++;
-            delete res;
+            Warning("AddRunFiles", "Run %d of file '%s/%s' could not be added to the database!", 
+                    r.GetFile(i)->GetRun(), path, r.GetFile(i)->GetFileName());
         }
     }
 
+    // clean-up
+    delete [] values;
+    delete [] ok;
+
     // user information
     if (!fSilence) Info("AddRunFiles", "Added %d runs to the database", nRunAdded);
 }
@@ -1126,10 +3049,9 @@ void TCMySQLManager::AddRun(Int_t run, const Char_t* target, const Char_t* desc)
     // identifier 'target' and the description 'desc'.
 
     // prepare the insert query
-    TString ins_query = TString::Format("INSERT INTO %s SET "
-                                        "run = %d, "
-                                        "description = '%s', "
-                                        "target = '%s'",
+    TString ins_query = TString::Format("INSERT INTO %s "
+                                        "(run, description, target) "
+                                        "VALUES (%d, '%s', '%s')",
                                         TCConfig::kCalibMainTableName, 
                                         run,
                                         desc,
@@ -1292,6 +3214,9 @@ Bool_t TCMySQLManager::ContainsCalibration(const Char_t* calibration)
 {
     // Check if the calibration 'calibration' exists in the database.
     
+    // check overlay calibrations
+    if (GetParentCalibration(calibration).Length()) return kTRUE;
+
     // loop over calibration data
     TIter next(fData);
     TCCalibData* d;
@@ -1330,7 +3255,7 @@ Bool_t TCMySQLManager::ContainsCalibration(const Char_t* calibration)
 Bool_t TCMySQLManager::ChangeCalibrationName(const Char_t* calibration, const Char_t* newCalibration)
 {
     // Change the calibration identifer 'calibration' in all calibration sets
-    // to 'newCalibration'.
+    // to 'newCalibration'. All calibration sets are renamed in one transaction.
     
     Char_t query[256];
     
@@ -1342,10 +3267,14 @@ Bool_t TCMySQLManager::ChangeCalibrationName(const Char_t* calibration, const Ch
         return kFALSE;
     }
 
+    // start the transaction
+    if (!StartTransaction()) return kFALSE;
+
     // loop over calibration data
+    Bool_t ok = kTRUE;
     TIter next(fData);
     TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
+    while (ok && (d = (TCCalibData*)next()))
     {
         // create the query
         sprintf(query,
@@ -1357,21 +3286,39 @@ Bool_t TCMySQLManager::ChangeCalibrationName(const Char_t* calibration, const Ch
         TSQLResult* res = SendQuery(query);
         
         // check result
-        if (!res)
-        {
-            if (!fSilence) Error("ChangeCalibrationName", "Could not rename calibration '%s' to '%s'!",
-                                 calibration, newCalibration);
-            return kFALSE;
-        }
+        if (res) delete res;
+        else ok = kFALSE;
+    }
 
-        // clean-up
-        delete res;
+    // rename overlay calibrations and parents of overlay calibrations
+    // (if the parent table exists)
+    Bool_t parents = ContainsTable(TCConfig::kCalibParentTableName);
+    for (Int_t i = 0; ok && parents && i < 2; i++)
+    {
+        sprintf(query,
+                "UPDATE %s SET %s = '%s' "
+                "WHERE %s = '%s'",
+                TCConfig::kCalibParentTableName, i ? "parent" : "calibration", newCalibration,
+                i ? "parent" : "calibration", calibration);
+        TSQLResult* res = SendQuery(query);
+        if (res) delete res;
+        else ok = kFALSE;
     }
     
-    if (!fSilence) Info("ChangeCalibrationName", "Renamed calibration '%s' to '%s'",
-                        calibration, newCalibration);
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // user information
+    if (!fSilence)
+    {
+        if (ok) Info("ChangeCalibrationName", "Renamed calibration '%s' to '%s'",
+                     calibration, newCalibration);
+        else Error("ChangeCalibrationName", "Could not rename calibration '%s' to '%s'!",
+                   calibration, newCalibration);
+    }
  
-    return kTRUE;
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -1429,6 +3376,7 @@ Bool_t TCMySQLManager::ChangeCalibrationRunRange(const Char_t* calibration, cons
     // Change the run range in all sets of the calibration 'calibration' to start from 'firstRun'
     // and to end at 'lastRun'. The runs must be present in the run database.
     // If 'firstRun'/'lastRun' is zero, the current start/stop run are kept.
+    // The sets of all calibration data are changed in one transaction.
 
     Char_t query[256];
     Char_t tmp[256];
@@ -1472,63 +3420,90 @@ Bool_t TCMySQLManager::ChangeCalibrationRunRange(const Char_t* calibration, cons
         return kFALSE;
     }
  
-    // loop over calibration data
+    // change the run ranges of all calibration data in one transaction
+    if (!StartTransaction()) return kFALSE;
+
+    // copy inherited sets of overlay calibrations
+    Bool_t ok = MaterializeDataSets(fData, calibration);
+
+    // get the old first and last runs of all calibration data
+    Int_t nData = fData->GetSize();
+    Int_t* oldFirstRun = new Int_t[nData];
+    Int_t* oldLastRun = new Int_t[nData];
+    Int_t n = 0;
     TIter next(fData);
     TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
+    while (ok && (d = (TCCalibData*)next()))
     {
-        // 
-        // first run
-        //
-        
-        if (firstRun)
+        TCSetTable* sets = GetSetTable(d->GetName(), calibration);
+        if (sets && sets->GetNSet())
+        {
+            oldFirstRun[n] = sets->GetFirstRun(0);
+            oldLastRun[n] = sets->GetLastRun(sets->GetNSet()-1);
+        }
+        else
+        {
+            oldFirstRun[n] = 0;
+            oldLastRun[n] = 0;
+        }
+        if (sets) delete sets;
+        n++;
+    }
+
+    // change the run ranges
+    n = 0;
+    next.Reset();
+    while (ok && (d = (TCCalibData*)next()))
+    {
+        // skip calibration data without sets
+        if (!oldFirstRun[n])
         {
-            // get the first run of the first set
-            Int_t oldFirstRun = GetFirstRunOfSet(d->GetName(), calibration, 0);
+            n++;
+            continue;
+        }
 
-            // execute the query
+        // change the first run of the first set
+        if (firstRun)
+        {
             sprintf(query, "UPDATE %s SET first_run = %d WHERE calibration = '%s' and first_run = %d", 
-                           d->GetTableName(), firstRun, calibration, oldFirstRun);
+                           d->GetTableName(), firstRun, calibration, oldFirstRun[n]);
             TSQLResult* res = SendQuery(query);
-            
-            // check result
-            if (!res)
+            if (res) delete res;
+            else
             {
                 if (!fSilence) Error("ChangeCalibrationRunRange", "Could not change first run of calibration '%s' to %d!",
                                      calibration, firstRun);
-                return kFALSE;
+                ok = kFALSE;
             }
-
-            // clean-up
-            delete res;
         }
         
-        // 
-        // last run
-        //
-        
-        if (lastRun)
+        // change the last run of the last set
+        if (ok && lastRun)
         {
-           // get the last run of the last set
-            Int_t oldLastRun = GetLastRunOfSet(d->GetName(), calibration, GetNsets(d->GetName(), calibration)-1);
-
-            // execute the query
             sprintf(query, "UPDATE %s SET last_run = %d WHERE calibration = '%s' and last_run = %d", 
-                           d->GetTableName(), lastRun, calibration, oldLastRun);
+                           d->GetTableName(), lastRun, calibration, oldLastRun[n]);
             TSQLResult* res = SendQuery(query);
-            
-            // check result
-            if (!res)
+            if (res) delete res;
+            else
             {
                 if (!fSilence) Error("ChangeCalibrationRunRange", "Could not change last run of calibration '%s' to %d!",
                                      calibration, lastRun);
-                return kFALSE;
+                ok = kFALSE;
             }
-
-            // clean-up
-            delete res;
         }
+
+        n++;
     }
+
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // clean-up
+    delete [] oldFirstRun;
+    delete [] oldLastRun;
+
+    if (!ok) return kFALSE;
     
     if (!fSilence) Info("ChangeCalibrationRunRange", "Changed run range of calibration '%s' to [%d,%d]",
                         calibration, firstRun, lastRun);
@@ -1540,6 +3515,8 @@ Bool_t TCMySQLManager::ChangeCalibrationRunRange(const Char_t* calibration, cons
 Bool_t TCMySQLManager::RemoveCalibration(const Char_t* calibration, const Char_t* data)
 {
     // Remove the calibration data 'data' of the calibration 'calibration'.
+    // If 'calibration' is an overlay calibration, only its own sets of 'data'
+    // are removed and the sets of the parent calibration are inherited again.
     
     Char_t query[256];
     
@@ -1573,6 +3550,13 @@ Bool_t TCMySQLManager::RemoveCalibration(const Char_t* calibration, const Char_t
     
     if (!fSilence) Info("RemoveCalibration", "Removed calibration '%s' of calibration '%s'",
                         ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
+    if (!fSilence)
+    {
+        TString parent = GetParentCalibration(calibration);
+        if (parent.Length()) 
+            Info("RemoveCalibration", "Calibration '%s' of the overlay '%s' is inherited from '%s' again",
+                 ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration, parent.Data());
+    }
  
     return kTRUE;
 }
@@ -1581,19 +3565,223 @@ Bool_t TCMySQLManager::RemoveCalibration(const Char_t* calibration, const Char_t
 Int_t TCMySQLManager::RemoveAllCalibrations(const Char_t* calibration)
 {
     // Remove all calibrations with the calibration identifer 'calibration'.
+    // Calibrations that are the parent of an overlay calibration are not removed.
+    // All calibration data are removed in one transaction.
+    // Return the number of removed calibration data (0 if an error occurred).
 
+    Char_t query[256];
     Int_t nCalib = 0;
 
+    // check if calibration was not found
+    if (!ContainsCalibration(calibration))
+    {
+        if (!fSilence) Error("RemoveAllCalibrations", "Calibration '%s' was not found in database!",
+                             calibration);
+        return 0;
+    }
+
+    // check if the calibration is the parent of an overlay
+    GetParentCalibration(calibration);
+    fMutex->Lock();
+    TString overlay;
+    TIter nextOverlay(fParents);
+    TObject* o;
+    while ((o = nextOverlay()))
+    {
+        if (!strcmp(o->GetTitle(), calibration))
+        {
+            overlay = o->GetName();
+            break;
+        }
+    }
+    fMutex->UnLock();
+    if (overlay.Length())
+    {
+        if (!fSilence) Error("RemoveAllCalibrations", "Calibration '%s' is the parent of the overlay '%s'!",
+                             calibration, overlay.Data());
+        return 0;
+    }
+
+    // start the transaction
+    if (!StartTransaction()) return 0;
+
     // loop over calibration data
+    Bool_t ok = kTRUE;
     TIter next(fData);
     TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
+    while (ok && (d = (TCCalibData*)next()))
     {
         // remove calibration
-        if (RemoveCalibration(calibration, d->GetName())) nCalib++;
+        sprintf(query, "DELETE FROM %s WHERE calibration = '%s'",
+                d->GetTableName(), calibration);
+        TSQLResult* res = SendQuery(query);
+        if (res)
+        {
+            delete res;
+            nCalib++;
+        }
+        else
+        {
+            if (!fSilence) Error("RemoveAllCalibrations", "Could not remove calibration '%s' of calibration '%s'!",
+                                 d->GetTitle(), calibration);
+            ok = kFALSE;
+        }
+    }
+
+    // remove the parent of overlay calibrations (if the parent table exists)
+    if (ok && ContainsTable(TCConfig::kCalibParentTableName))
+    {
+        sprintf(query, "DELETE FROM %s WHERE calibration = '%s'", 
+                TCConfig::kCalibParentTableName, calibration);
+        TSQLResult* res = SendQuery(query);
+        if (res) delete res;
+        else ok = kFALSE;
+    }
+
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // user information
+    if (!fSilence)
+    {
+        if (ok) Info("RemoveAllCalibrations", "Removed %d calibration data of calibration '%s'",
+                     nCalib, calibration);
+        else Error("RemoveAllCalibrations", "Could not remove calibration '%s'!", calibration);
+    }
+
+    return ok ? nCalib : 0;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::CreateOverlay(const Char_t* calibration, const Char_t* parent)
+{
+    // Create the overlay calibration 'calibration' of the calibration 'parent'.
+    // The overlay calibration initially has no own sets and reads all sets from
+    // its parent calibration. The sets of a calibration data are copied to the 
+    // overlay when they are modified for the first time (copy-on-write).
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    Char_t query[256];
+
+    // check if the parent calibration exists
+    if (!ContainsCalibration(parent))
+    {
+        if (!fSilence) Error("CreateOverlay", "Parent calibration '%s' does not exist!", parent);
+        return kFALSE;
+    }
+    
+    // check if the calibration exists
+    if (ContainsCalibration(calibration))
+    {
+        if (!fSilence) Error("CreateOverlay", "Calibration '%s' exists already!", calibration);
+        return kFALSE;
+    }
+
+    // check the parent table
+    if (!ContainsTable(TCConfig::kCalibParentTableName))
+    {
+        if (!fSilence) Error("CreateOverlay", "Overlay calibrations need the database version 6 "
+                             "(see macros/Upgrade_6.C)!");
+        return kFALSE;
+    }
+
+    // create the query
+    sprintf(query,
+            "INSERT INTO %s (calibration,parent) VALUES ('%s','%s')",
+            TCConfig::kCalibParentTableName, calibration, parent);
+
+    // write to database
+    TSQLResult* res = SendQuery(query);
+
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("CreateOverlay", "Could not create the overlay '%s' of calibration '%s'!",
+                             calibration, parent);
+        return kFALSE;
+    }
+    else
+    {
+        if (!fSilence) Info("CreateOverlay", "Created the overlay '%s' of calibration '%s'",
+                            calibration, parent);
+        delete res;
+        return kTRUE;
+    }
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::FlattenCalibration(const Char_t* calibration)
+{
+    // Copy all sets inherited by the overlay calibration 'calibration' from its 
+    // parent calibrations to the overlay and remove the link to its parent,
+    // i.e. convert the overlay into a normal calibration. All sets are copied
+    // in one transaction.
+    // Return kFALSE if an error occurred, otherwise kTRUE.
+
+    Char_t query[256];
+
+    // check if the calibration is an overlay
+    TString parent = GetParentCalibration(calibration);
+    if (!parent.Length())
+    {
+        if (!fSilence) Error("FlattenCalibration", "Calibration '%s' is not an overlay!", calibration);
+        return kFALSE;
+    }
+
+    // get the calibrations of the inherited sets
+    Int_t nData = fData->GetSize();
+    TString* owner = new TString[nData];
+    Int_t n = 0;
+    TIter next(fData);
+    TCCalibData* d;
+    while ((d = (TCCalibData*)next()))
+    {
+        TCSetTable* own = GetSetTable(d->GetName(), calibration, kFALSE);
+        TCSetTable* sets = GetSetTable(d->GetName(), calibration);
+        if (own && !own->GetNSet() && sets && sets->GetNSet()) owner[n] = sets->GetCalibration();
+        if (own) delete own;
+        if (sets) delete sets;
+        n++;
+    }
+
+    // copy the inherited sets and remove the parent in one transaction
+    Bool_t ok = StartTransaction();
+    Int_t nCopied = 0;
+    n = 0;
+    next.Reset();
+    while (ok && (d = (TCCalibData*)next()))
+    {
+        if (owner[n].Length()) 
+        {
+            ok = CopyDataSets(d->GetName(), owner[n].Data(), calibration);
+            nCopied++;
+        }
+        n++;
+    }
+    if (ok)
+    {
+        sprintf(query, "DELETE FROM %s WHERE calibration = '%s'", 
+                TCConfig::kCalibParentTableName, calibration);
+        TSQLResult* res = SendQuery(query);
+        if (res) delete res;
+        else ok = kFALSE;
+    }
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // clean-up
+    delete [] owner;
+
+    // user information
+    if (!fSilence)
+    {
+        if (ok) Info("FlattenCalibration", "Flattened the overlay '%s' of calibration '%s' (%d data copied)",
+                     calibration, parent.Data(), nCopied);
+        else Error("FlattenCalibration", "Could not flatten the overlay '%s'!", calibration);
     }
 
-    return nCalib;
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -1604,7 +3792,10 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
     // Read the calibration for the detector 'det' from the AcquRoot calibration
     // file 'calibFileAR' and create calibration sets for the runs 'first_run'
     // to 'last_run' using the calibration name 'calib' and the description
-    // 'desc'.
+    // 'desc'. The sets of the different calibration data are written in
+    // parallel using the pooled connections with one transaction per connection.
+    // If the transactions were only partially committed, the added sets are 
+    // removed again.
 
     // read the calibration file
     TCReadARCalib r(calibFileAR, kFALSE);
@@ -1624,11 +3815,11 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
     }
 
     // create generic parameter arrays
-    Double_t eL[nDet];
-    Double_t e0[nDet];
-    Double_t e1[nDet];
-    Double_t t0[nDet];
-    Double_t t1[nDet];
+    Double_t* eL = new Double_t[nDet];
+    Double_t* e0 = new Double_t[nDet];
+    Double_t* e1 = new Double_t[nDet];
+    Double_t* t0 = new Double_t[nDet];
+    Double_t* t1 = new Double_t[nDet];
 
     // read generic parameters
     for (Int_t i = 0; i < nDet; i++)
@@ -1640,25 +3831,33 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
         t1[i] = r.GetElement(i)->GetTDCGain();
     }
 
+    // sets to add
+    const Char_t* data[7];
+    Double_t* par[7];
+    Int_t length[7];
+    Int_t result[7];
+    Int_t nSet = 0;
+    Double_t* e0SG = 0;
+    Double_t* e1SG = 0;
+    Double_t* phi = 0;
+
     // read detector specific calibration values
-    // and write the data to the database (depends also
+    // and collect the sets to add (depends also
     // on the detector)
     switch (det)
     {
         // tagger
         case kDETECTOR_TAGG:
         {
-            // write to database
-            AddDataSet("Data.Tagger.T0", calib, desc, first_run, last_run, t0, nDet);
+            data[nSet] = "Data.Tagger.T0"; par[nSet] = t0; length[nSet++] = nDet;
             
             break;
         }
         // CB
         case kDETECTOR_CB:
         {
-            // write to database
-            AddDataSet("Data.CB.E1", calib, desc, first_run, last_run, e1, nDet);
-            AddDataSet("Data.CB.T0", calib, desc, first_run, last_run, t0, nDet);
+            data[nSet] = "Data.CB.E1"; par[nSet] = e1; length[nSet++] = nDet;
+            data[nSet] = "Data.CB.T0"; par[nSet] = t0; length[nSet++] = nDet;
             
             break;
         }
@@ -1675,12 +3874,17 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
             if (!nDetSG) 
             {
                 if (!fSilence) Error("AddCalibAR", "No TAPS SG detector elements found in calibration file!");
+                delete [] eL;
+                delete [] e0;
+                delete [] e1;
+                delete [] t0;
+                delete [] t1;
                 return;
             }
 
             // create SG parameter arrays
-            Double_t e0SG[nDetSG];
-            Double_t e1SG[nDetSG];
+            e0SG = new Double_t[nDetSG];
+            e1SG = new Double_t[nDetSG];
                 
             // read SG parameters
             for (Int_t i = 0; i < nDetSG; i++)
@@ -1689,14 +3893,13 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
                 e1SG[i] = rSG.GetElement(i)->GetADCGain();
             }
 
-            // write to database
-            AddDataSet("Data.TAPS.CFD", calib, desc, first_run, last_run, eL, nDet);
-            AddDataSet("Data.TAPS.LG.E0", calib, desc, first_run, last_run, e0, nDet);
-            AddDataSet("Data.TAPS.LG.E1", calib, desc, first_run, last_run, e1, nDet);
-            AddDataSet("Data.TAPS.SG.E0", calib, desc, first_run, last_run, e0SG, nDetSG);
-            AddDataSet("Data.TAPS.SG.E1", calib, desc, first_run, last_run, e1SG, nDetSG);
-            AddDataSet("Data.TAPS.T0", calib, desc, first_run, last_run, t0, nDet);
-            AddDataSet("Data.TAPS.T1", calib, desc, first_run, last_run, t1, nDet);
+            data[nSet] = "Data.TAPS.CFD"; par[nSet] = eL; length[nSet++] = nDet;
+            data[nSet] = "Data.TAPS.LG.E0"; par[nSet] = e0; length[nSet++] = nDet;
+            data[nSet] = "Data.TAPS.LG.E1"; par[nSet] = e1; length[nSet++] = nDet;
+            data[nSet] = "Data.TAPS.SG.E0"; par[nSet] = e0SG; length[nSet++] = nDetSG;
+            data[nSet] = "Data.TAPS.SG.E1"; par[nSet] = e1SG; length[nSet++] = nDetSG;
+            data[nSet] = "Data.TAPS.T0"; par[nSet] = t0; length[nSet++] = nDet;
+            data[nSet] = "Data.TAPS.T1"; par[nSet] = t1; length[nSet++] = nDet;
             
             break;
         }
@@ -1704,7 +3907,7 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
         case kDETECTOR_PID:
         {
             // create special parameter arrays
-            Double_t phi[nDet];
+            phi = new Double_t[nDet];
 
             // read special parameters
             for (Int_t i = 0; i < nDet; i++)
@@ -1712,33 +3915,73 @@ void TCMySQLManager::AddCalibAR(CalibDetector_t det, const Char_t* calibFileAR,
                 phi[i] = r.GetElement(i)->GetZ();
             }
 
-            // write to database
-            AddDataSet("Data.PID.Phi", calib, desc, first_run, last_run, phi, nDet);
-            AddDataSet("Data.PID.E0", calib, desc, first_run, last_run, e0, nDet);
-            AddDataSet("Data.PID.E1", calib, desc, first_run, last_run, e1, nDet);
-            AddDataSet("Data.PID.T0", calib, desc, first_run, last_run, t0, nDet);
+            data[nSet] = "Data.PID.Phi"; par[nSet] = phi; length[nSet++] = nDet;
+            data[nSet] = "Data.PID.E0"; par[nSet] = e0; length[nSet++] = nDet;
+            data[nSet] = "Data.PID.E1"; par[nSet] = e1; length[nSet++] = nDet;
+            data[nSet] = "Data.PID.T0"; par[nSet] = t0; length[nSet++] = nDet;
             
             break;
         }
         // Veto
         case kDETECTOR_VETO:
         {
-            // write to database
-            AddDataSet("Data.Veto.LED", calib, desc, first_run, last_run, eL, nDet);
-            AddDataSet("Data.Veto.E0", calib, desc, first_run, last_run, e0, nDet);
-            AddDataSet("Data.Veto.E1", calib, desc, first_run, last_run, e1, nDet);
-            AddDataSet("Data.Veto.T0", calib, desc, first_run, last_run, t0, nDet);
-            AddDataSet("Data.Veto.T1", calib, desc, first_run, last_run, t1, nDet);
+            data[nSet] = "Data.Veto.LED"; par[nSet] = eL; length[nSet++] = nDet;
+            data[nSet] = "Data.Veto.E0"; par[nSet] = e0; length[nSet++] = nDet;
+            data[nSet] = "Data.Veto.E1"; par[nSet] = e1; length[nSet++] = nDet;
+            data[nSet] = "Data.Veto.T0"; par[nSet] = t0; length[nSet++] = nDet;
+            data[nSet] = "Data.Veto.T1"; par[nSet] = t1; length[nSet++] = nDet;
             
             break;
         }
         // no detector
         case kDETECTOR_NODET:
         {
-            // do nothing
-            break;
+            // do nothing
+            break;
+        }
+    }
+
+    // write the sets to the database in parallel
+    TCMySQLManagerTask task;
+    task.fCalibration = calib;
+    task.fDesc = desc;
+    task.fFirstRun = first_run;
+    task.fLastRun = last_run;
+    task.fData = data;
+    task.fPar = par;
+    task.fLength = length;
+    task.fResult = result;
+    Int_t nOK = RunParallel(kTaskAdd, nSet, (void*) &task, kTRUE);
+
+    // remove the sets of partially committed transactions
+    if (nOK == -1)
+    {
+        for (Int_t i = 0; i < nSet; i++)
+        {
+            TCCalibData* d = (TCCalibData*) fData->FindObject(data[i]);
+            TSQLResult* res = SendQuery(TString::Format("DELETE FROM %s WHERE calibration = '%s' AND first_run = %d",
+                                                        d->GetTableName(), calib, first_run).Data());
+            if (res) delete res;
+            else if (!fSilence) Error("AddCalibAR", "Could not remove the set of '%s'!", d->GetTitle());
         }
     }
+
+    // user information
+    if (!fSilence)
+    {
+        if (nOK == nSet) Info("AddCalibAR", "Added %d sets to calibration '%s'", nSet, calib);
+        else Error("AddCalibAR", "Could not add the sets to calibration '%s'!", calib);
+    }
+
+    // clean-up
+    delete [] eL;
+    delete [] e0;
+    delete [] e1;
+    delete [] t0;
+    delete [] t1;
+    if (e0SG) delete [] e0SG;
+    if (e1SG) delete [] e1SG;
+    if (phi) delete [] phi;
 }
 
 //______________________________________________________________________________
@@ -1754,9 +3997,45 @@ void TCMySQLManager::CreateMainTable()
     delete res;
 
     // create the table
-    res = SendQuery(TString::Format("CREATE TABLE %s ( %s )", 
-                                     TCConfig::kCalibMainTableName, TCConfig::kCalibMainTableFormat).Data());
+    TString query = TString::Format("CREATE TABLE %s ( %s )", 
+                                    TCConfig::kCalibMainTableName, TCConfig::kCalibMainTableFormat);
+    res = SendQuery(fBackend->GetTableFormat(query.Data()).Data());
+    delete res;
+
+    // create the trigger of the table if needed
+    TString trigger = fBackend->GetTableTrigger(TCConfig::kCalibMainTableName);
+    if (trigger.Length())
+    {
+        res = SendQuery(trigger.Data());
+        delete res;
+    }
+}
+
+//______________________________________________________________________________
+void TCMySQLManager::CreateParentTable()
+{
+    // Create the table of the parent calibrations of the overlay calibrations.
+    
+    // user information
+    if (!fSilence) Info("CreateParentTable", "Creating the table of the parent calibrations");
+
+    // delete the old table if it exists
+    TSQLResult* res = SendQuery(TString::Format("DROP TABLE IF EXISTS %s", TCConfig::kCalibParentTableName).Data());
+    delete res;
+
+    // create the table
+    TString query = TString::Format("CREATE TABLE %s ( %s )", 
+                                    TCConfig::kCalibParentTableName, TCConfig::kCalibParentTableFormat);
+    res = SendQuery(fBackend->GetTableFormat(query.Data()).Data());
     delete res;
+
+    // create the trigger of the table if needed
+    TString trigger = fBackend->GetTableTrigger(TCConfig::kCalibParentTableName);
+    if (trigger.Length())
+    {
+        res = SendQuery(trigger.Data());
+        delete res;
+    }
 }
 
 //______________________________________________________________________________
@@ -1779,24 +4058,26 @@ void TCMySQLManager::CreateDataTable(const Char_t* data, Int_t nElem)
     TSQLResult* res = SendQuery(TString::Format("DROP TABLE IF EXISTS %s", table));
     delete res;
 
-    // prepare CREATE TABLE query
+    // prepare CREATE TABLE query (parameters packed in one BLOB)
     TString query;
     query.Append(TString::Format("CREATE TABLE %s ( %s ", table, TCConfig::kCalibDataTableHeader));
-
-    // loop over elements
-    for (Int_t j = 0; j < nElem; j++)
-    {
-        query.Append(TString::Format("par_%03d DOUBLE DEFAULT 0", j));
-        if (j != nElem - 1) query.Append(", ");
-    }
+    query.Append("par BLOB");
 
     // finish preparing the query
     query.Append(TCConfig::kCalibDataTableSettings);
     query.Append(" )");
     
     // submit the query
-    res = SendQuery(query.Data());
+    res = SendQuery(fBackend->GetTableFormat(query.Data()).Data());
     delete res;
+
+    // create the trigger of the table if needed
+    TString trigger = fBackend->GetTableTrigger(table);
+    if (trigger.Length())
+    {
+        res = SendQuery(trigger.Data());
+        delete res;
+    }
 }
 
 //______________________________________________________________________________
@@ -1861,11 +4142,118 @@ TList* TCMySQLManager::GetAllTargets()
 TList* TCMySQLManager::GetAllCalibrations(const Char_t* data)
 {
     // Return a list of TStrings containing all calibration identifiers in the database
-    // for the calibration data 'data'.
+    // for the calibration data 'data' including the overlay calibrations inheriting
+    // sets of 'data' from their parent calibrations.
     // If no calibrations were found 0 is returned.
     // NOTE: The list must be destroyed by the caller.
 
-    return SearchDistinctEntries("calibration", ((TCCalibData*) fData->FindObject(data))->GetTableName());
+    // get the calibrations having sets
+    TList* list = SearchDistinctEntries("calibration", ((TCCalibData*) fData->FindObject(data))->GetTableName());
+
+    // get the overlay calibrations
+    GetParentCalibration("");
+    fMutex->Lock();
+    TList overlays;
+    overlays.SetOwner(kTRUE);
+    TIter next(fParents);
+    TObject* o;
+    while ((o = next())) overlays.Add(new TObjString(o->GetName()));
+    fMutex->UnLock();
+
+    // add the overlay calibrations inheriting sets
+    TIter nextOverlay(&overlays);
+    while ((o = nextOverlay()))
+    {
+        if (list && list->FindObject(o->GetName())) continue;
+        TCSetTable* sets = GetSetTable(data, o->GetName());
+        Int_t nSet = sets ? sets->GetNSet() : 0;
+        if (sets) delete sets;
+        if (!nSet) continue;
+        if (!list) 
+        {
+            list = new TList();
+            list->SetOwner(kTRUE);
+        }
+        list->Add(new TObjString(o->GetName()));
+    }
+
+    return list;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::CheckSetRunRange(TList* data, const Char_t* calibration, 
+                                        Int_t first_run, Int_t last_run)
+{
+    // Check if new sets of the calibration data in the list 'data' with the 
+    // calibration identifier 'calibration' can be created for the runs 
+    // 'first_run' to 'last_run', i.e. if the runs exist and the new sets do
+    // not overlap with existing sets. All data tables are checked using a
+    // single query.
+    // Return kTRUE if the sets can be created, otherwise kFALSE.
+
+    Char_t tmp[256];
+
+    // check first run
+    if (!SearchRunEntry(first_run, "run", tmp))
+    {
+        if (!fSilence) Error("CheckSetRunRange", "First run has no valid run number!");
+        return kFALSE;
+    }
+    
+    // check last run
+    if (!SearchRunEntry(last_run, "run", tmp))
+    {
+        if (!fSilence) Error("CheckSetRunRange", "Last run has no valid run number!");
+        return kFALSE;
+    }
+
+    // check if first run is smaller than last run
+    if (first_run > last_run)
+    {
+        if (!fSilence) Error("CheckSetRunRange", "First run of set has to be smaller than last run!");
+        return kFALSE;
+    }
+
+    // create the query looking for overlapping sets in all data tables
+    TString query;
+    TIter next(data);
+    TCCalibData* d;
+    while ((d = (TCCalibData*)next()))
+    {
+        if (query.Length()) query.Append(" UNION ALL ");
+        query.Append(TString::Format("SELECT '%s', first_run, last_run FROM %s "
+                                     "WHERE calibration = '%s' AND "
+                                     "first_run <= %d AND last_run >= %d",
+                                     d->GetName(), d->GetTableName(), calibration, 
+                                     last_run, first_run));
+    }
+    if (!query.Length()) return kTRUE;
+
+    // read from database
+    TSQLResult* res = SendQuery(query.Data());
+
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("CheckSetRunRange", "Could not check the existing sets!");
+        return kFALSE;
+    }
+
+    // check for an overlapping set
+    Bool_t ok = kTRUE;
+    if (TSQLRow* row = res->Next())
+    {
+        d = (TCCalibData*) fData->FindObject(GetField(row, 0));
+        if (!fSilence) Error("CheckSetRunRange", "Run overlap with the set of runs %s to %s in '%s'",
+                             GetField(row, 1), GetField(row, 2), d ? d->GetTitle() : GetField(row, 0));
+        delete row;
+        ok = kFALSE;
+    }
+
+    // clean-up
+    delete res;
+
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -1881,100 +4269,53 @@ Bool_t TCMySQLManager::AddDataSet(const Char_t* data, const Char_t* calibration,
  
     Char_t table[256];
     
-    // do some checks concerning the run numbers
-    if (!skipChecks)
+    // get the data table
+    if (!SearchTable(data, table))
     {
-        //
-        // check if first and last run exist
-        //
-        
-        // check first run
-        if (!SearchRunEntry(first_run, "run", table))
-        {
-            if (!fSilence) Error("AddDataSet", "First run has no valid run number!");
-            return kFALSE;
-        }
-        
-        // check last run
-        if (!SearchRunEntry(last_run, "run", table))
-        {
-            if (!fSilence) Error("AddDataSet", "Last run has no valid run number!");
-            return kFALSE;
-        }
-
-        //
-        // check if the run range is ok
-        //
-
-        // check if first run is smaller than last run
-        if (first_run > last_run)
-        {
-            if (!fSilence) Error("AddDataSet", "First run of set has to be smaller than last run!");
-            return kFALSE;
-        }
-
-        // get number of existing sets
-        Int_t nSet = GetNsets(data, calibration);
-
-        // loop over sets
-        for (Int_t i = 0; i < nSet; i++)
-        {
-            // get first and last runs of set
-            Int_t setLow = GetFirstRunOfSet(data, calibration, i);
-            Int_t setHigh = GetLastRunOfSet(data, calibration, i);
-
-            // check if first run is member of this set
-            if (first_run >= setLow && first_run <= setHigh)
-            {
-                if (!fSilence) Error("AddDataSet", "First run is already member of set %d", i);
-                return kFALSE;
-            }
+        if (!fSilence) Error("AddDataSet", "No data table found!");
+        return kFALSE;
+    }
 
-            // check if last run is member of this set
-            if (last_run >= setLow && last_run <= setHigh)
-            {
-                if (!fSilence) Error("AddDataSet", "Last run is already member of set %d", i);
-                return kFALSE;
-            }
+    // copy inherited sets of overlay calibrations
+    if (!MaterializeDataSets(data, calibration)) return kFALSE;
 
-            // check if sets are not overlapping
-            if ((setLow >= first_run && setLow <= last_run) ||
-                (setHigh >= first_run && setHigh <= last_run))
-            {
-                if (!fSilence) Error("AddDataSet", "Run overlap with set %d", i);
-                return kFALSE;
-            }
-        }
+    // do some checks concerning the run numbers
+    if (!skipChecks)
+    {
+        TList list;
+        list.Add(fData->FindObject(data));
+        if (!CheckSetRunRange(&list, calibration, first_run, last_run)) return kFALSE;
     }
 
     //
     // create the set
     //
     
-    // get the data table
-    if (!SearchTable(data, table))
-    {
-        if (!fSilence) Error("AddDataSet", "No data table found!");
-        return kFALSE;
-    }
+    // prepare the statement
+    TString sql;
+    TSQLStatement* stmt = PrepareStatement("insert", table, length, 1, &sql);
 
-    // prepare the insert query
-    TString ins_query = TString::Format("INSERT INTO %s SET calibration = '%s', description = '%s', first_run = %d, last_run = %d,",
-                                        table, calibration, desc, first_run, last_run);
-    
-    // read all parameters and write them to new query
-    for (Int_t j = 0; j < length; j++)
+    // write data to database
+    Bool_t ok = kFALSE;
+    if (stmt && stmt->NextIteration())
     {
-        // append parameter to query
-        ins_query.Append(TString::Format("par_%03d = %.17g", j, par[j]));
-        if (j != length - 1) ins_query.Append(",");
+        stmt->SetString(0, calibration);
+        stmt->SetString(1, desc, 1024);
+        stmt->SetInt(2, first_run);
+        stmt->SetInt(3, last_run);
+        SetParameters(stmt, 4, IsPackedTable(table), par, length);
+        ok = ProcessStatement(stmt, sql.Data());
     }
 
-    // write data to database
-    TSQLResult* res = SendQuery(ins_query.Data());
+    // clean-up
+    if (stmt) delete stmt;
+
+    // a set was added (replacing cached parameters of a removed set)
+    ClearSetTables(table);
+    fParCache->Remove(table, calibration, first_run);
     
     // check result
-    if (!res)
+    if (!ok)
     {
         if (!fSilence) Error("AddDataSet", "Could not add the set of '%s' for runs %d to %d!", 
                         ((TCCalibData*) fData->FindObject(data))->GetTitle(), first_run, last_run);
@@ -1982,7 +4323,6 @@ Bool_t TCMySQLManager::AddDataSet(const Char_t* data, const Char_t* calibration,
     }
     else
     {
-        delete res;
         if (!fSilence) Info("AddDataSet", "Added set of '%s' for runs %d to %d", 
                                       ((TCCalibData*) fData->FindObject(data))->GetTitle(), first_run, last_run);
         return kTRUE;
@@ -2002,11 +4342,16 @@ Bool_t TCMySQLManager::AddDataSet(const Char_t* data, const Char_t* calibration,
     Int_t length = ((TCCalibData*) fData->FindObject(data))->GetSize();
     
     // create and fill parameter array
-    Double_t par_array[length];
+    Double_t* par_array = new Double_t[length];
     for (Int_t i = 0; i < length; i++) par_array[i] = par;
 
     // set parameters
-    return AddDataSet(data, calibration, desc, first_run, last_run, par_array, length);
+    Bool_t ok = AddDataSet(data, calibration, desc, first_run, last_run, par_array, length);
+
+    // clean-up
+    delete [] par_array;
+
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -2016,10 +4361,9 @@ Bool_t TCMySQLManager::AddSet(const Char_t* type, const Char_t* calibration, con
     // Create new sets for the calibration type 'type' with the calibration identifier
     // 'calibration' for the runs 'first_run' to 'last_run'. Use 'desc' as a 
     // description. Set all parameters to the value 'par'.
+    // The sets of all calibration data are created in one transaction.
     // Return kFALSE when an error occurred, otherwise kTRUE.
     
-    Bool_t ret = kTRUE;
-    
     // create and fill parameter array
     Double_t par_array[TCConfig::kMaxCrystal];
     for (Int_t i = 0; i < TCConfig::kMaxCrystal; i++) par_array[i] = par;
@@ -2028,17 +4372,29 @@ Bool_t TCMySQLManager::AddSet(const Char_t* type, const Char_t* calibration, con
     TCCalibType* t = (TCCalibType*) fTypes->FindObject(type);
     TList* data = t->GetData();
     
+    // start the transaction
+    if (!StartTransaction()) return kFALSE;
+
+    // copy inherited sets of overlay calibrations and check the run range
+    // of the new sets
+    Bool_t ok = MaterializeDataSets(data, calibration) &&
+                CheckSetRunRange(data, calibration, first_run, last_run);
+
     // loop over calibration data of this calibration type
     TIter next(data);
     TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
+    while (ok && (d = (TCCalibData*)next()))
     {
         // add set
-        if (AddDataSet(d->GetName(), calibration, desc, first_run, last_run, par_array, 
-                       d->GetSize())) ret = kFALSE;
+        ok = AddDataSet(d->GetName(), calibration, desc, first_run, last_run, par_array, 
+                        d->GetSize(), kTRUE);
     }
 
-    return ret;
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -2046,6 +4402,8 @@ Bool_t TCMySQLManager::RemoveDataSet(const Char_t* data, const Char_t* calibrati
 {
     // Remove the set 'set' from the calibration 'calibration' of the calibration data
     // 'data'.
+    // The last set of an overlay calibration cannot be removed because the
+    // sets of the parent calibration would be inherited again afterwards.
     
     Char_t query[256];
     Char_t table[256];
@@ -2057,6 +4415,24 @@ Bool_t TCMySQLManager::RemoveDataSet(const Char_t* data, const Char_t* calibrati
         return kFALSE;
     }
 
+    // copy inherited sets of overlay calibrations
+    if (!MaterializeDataSets(data, calibration)) return kFALSE;
+
+    // check for the last set of an overlay calibration
+    TString parent = GetParentCalibration(calibration);
+    if (parent.Length())
+    {
+        TCSetTable* own = GetSetTable(data, calibration, kFALSE);
+        Int_t nOwn = own ? own->GetNSet() : 0;
+        if (own) delete own;
+        if (nOwn <= 1)
+        {
+            if (!fSilence) Error("RemoveDataSet", "Cannot delete the last set in '%s' of the overlay calibration '%s'!",
+                                 ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
+            return kFALSE;
+        }
+    }
+
     // get the first run of the set
     Int_t first_run = GetFirstRunOfSet(data, calibration, set);
     
@@ -2094,38 +4470,210 @@ Bool_t TCMySQLManager::RemoveDataSet(const Char_t* data, const Char_t* calibrati
     }
 }
 
+//______________________________________________________________________________
+Bool_t TCMySQLManager::CloneDataSet(const Char_t* data, const Char_t* calibration, const Char_t* newCalibration,
+                                    const Char_t* desc, Int_t first_run, Int_t last_run)
+{
+    // Create a set of the calibration data 'data' with the calibration identifier
+    // 'newCalibration' for the runs 'first_run' to 'last_run' and the description
+    // 'desc' using the parameters of the last set of the calibration 'calibration'.
+    // The set is copied by the database server using a single query. The run
+    // range is not checked (see CheckSetRunRange()).
+    // Return kFALSE when an error occurred, otherwise kTRUE.
+ 
+    Char_t table[256];
+    
+    // get the data table
+    if (!SearchTable(data, table))
+    {
+        if (!fSilence) Error("CloneDataSet", "No data table found!");
+        return kFALSE;
+    }
+
+    // get the calibration of the original sets
+    TCSetTable* sets = GetSetTable(data, calibration);
+    TString owner = sets ? sets->GetCalibration() : calibration;
+    if (sets) delete sets;
+
+    // create the query
+    TCCalibData* d = (TCCalibData*) fData->FindObject(data);
+    TString cols = GetParameterColumns(table, d->GetSize());
+    TString query = TString::Format("INSERT INTO %s (calibration,description,first_run,last_run,%s) "
+                                    "SELECT %s,%s,%d,%d,%s FROM %s WHERE calibration = %s "
+                                    "ORDER BY first_run DESC LIMIT 1",
+                                    table, cols.Data(), fBackend->Quote(newCalibration).Data(), 
+                                    fBackend->Quote(desc).Data(), first_run, last_run,
+                                    cols.Data(), table, fBackend->Quote(owner.Data()).Data());
+
+    // copy the set
+    TSQLStatement* stmt = IsConnected() ? GetConnection()->Statement(query.Data()) : 0;
+    Bool_t ok = stmt && ProcessStatement(stmt, query.Data()) && stmt->GetNumAffectedRows() == 1;
+    
+    // clean-up
+    if (stmt) delete stmt;
+
+    // a set was added
+    ClearSetTables(table);
+    fParCache->Clear(table);
+
+    // check result
+    if (!ok)
+    {
+        if (!fSilence) Error("CloneDataSet", "Could not clone the last set of '%s' of calibration '%s'!",
+                             d->GetTitle(), calibration);
+        return kFALSE;
+    }
+    else
+    {
+        if (!fSilence) Info("CloneDataSet", "Added set of '%s' for runs %d to %d", 
+                            d->GetTitle(), first_run, last_run);
+        return kTRUE;
+    }
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::CopyDataSets(const Char_t* data, const Char_t* calibration, const Char_t* newCalibration)
+{
+    // Copy all sets of the calibration data 'data' of the calibration 'calibration'
+    // to the calibration 'newCalibration'. The sets are copied by the database 
+    // server using a single query.
+    // Return kFALSE when an error occurred, otherwise kTRUE.
+ 
+    Char_t table[256];
+    
+    // get the data table
+    if (!SearchTable(data, table))
+    {
+        if (!fSilence) Error("CopyDataSets", "No data table found!");
+        return kFALSE;
+    }
+
+    // create the query
+    TCCalibData* d = (TCCalibData*) fData->FindObject(data);
+    TString cols = GetParameterColumns(table, d->GetSize());
+    TString query = TString::Format("INSERT INTO %s (calibration,description,first_run,last_run,%s) "
+                                    "SELECT '%s',description,first_run,last_run,%s FROM %s "
+                                    "WHERE calibration = '%s'",
+                                    table, cols.Data(), newCalibration, cols.Data(), table, calibration);
+
+    // copy the sets
+    TSQLResult* res = SendQuery(query.Data());
+
+    // check result
+    if (!res)
+    {
+        if (!fSilence) Error("CopyDataSets", "Could not copy the sets of '%s' of calibration '%s' to '%s'!",
+                             d->GetTitle(), calibration, newCalibration);
+        return kFALSE;
+    }
+    
+    // clean-up
+    delete res;
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::MaterializeDataSets(const Char_t* data, const Char_t* calibration)
+{
+    // Copy the sets of the calibration data 'data' inherited by the overlay 
+    // calibration 'calibration' from its parent calibrations to the overlay
+    // before they are modified (copy-on-write). Nothing is done for other
+    // calibrations or if the overlay has own sets of 'data'.
+    // Return kFALSE when an error occurred, otherwise kTRUE.
+
+    // check if the calibration is an overlay
+    if (!GetParentCalibration(calibration).Length()) return kTRUE;
+
+    // check for own sets
+    TCSetTable* sets = GetSetTable(data, calibration, kFALSE);
+    if (!sets) return kFALSE;
+    Int_t nSet = sets->GetNSet();
+    delete sets;
+    if (nSet) return kTRUE;
+
+    // get the inherited sets
+    sets = GetSetTable(data, calibration);
+    if (!sets) return kFALSE;
+    nSet = sets->GetNSet();
+    TString owner = sets->GetCalibration();
+    delete sets;
+    if (!nSet) return kTRUE;
+
+    // copy the sets
+    if (!CopyDataSets(data, owner.Data(), calibration)) return kFALSE;
+    
+    // user information
+    if (!fSilence) Info("MaterializeDataSets", "Copied the sets of '%s' of calibration '%s' to the overlay '%s'",
+                        ((TCCalibData*) fData->FindObject(data))->GetTitle(), owner.Data(), calibration);
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TCMySQLManager::MaterializeDataSets(TList* data, const Char_t* calibration)
+{
+    // Copy the sets of the calibration data in the list 'data' inherited by the
+    // overlay calibration 'calibration' from its parent calibrations to the 
+    // overlay (see MaterializeDataSets(const Char_t*, const Char_t*)).
+    // Return kFALSE when an error occurred, otherwise kTRUE.
+
+    // check if the calibration is an overlay
+    if (!GetParentCalibration(calibration).Length()) return kTRUE;
+
+    // loop over calibration data
+    TIter next(data);
+    TCCalibData* d;
+    while ((d = (TCCalibData*)next()))
+        if (!MaterializeDataSets(d->GetName(), calibration)) return kFALSE;
+
+    return kTRUE;
+}
+
 //______________________________________________________________________________
 Bool_t TCMySQLManager::RemoveSet(const Char_t* type, const Char_t* calibration, Int_t set)
 {
     // Remove all sets 'set' from the calibration 'calibration' that are needed by the
-    // calibration type 'type'.
-    
-    Bool_t ret = kTRUE;
+    // calibration type 'type'. The sets of all calibration data are removed 
+    // in one transaction. The last set of an overlay calibration cannot be
+    // removed (see RemoveDataSet()).
     
     // get calibration type and data list
     TCCalibType* t = (TCCalibType*) fTypes->FindObject(type);
     TList* data = t->GetData();
  
+    // start the transaction
+    if (!StartTransaction()) return kFALSE;
+
+    // copy inherited sets of overlay calibrations
+    Bool_t ok = MaterializeDataSets(data, calibration);
+
     // loop over calibration data of this calibration type
     TIter next(data);
     TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
+    while (ok && (d = (TCCalibData*)next()))
     {
         // remove set of calibration data
-        if (!RemoveDataSet(d->GetName(), calibration, set))
-            ret = kFALSE;
+        ok = RemoveDataSet(d->GetName(), calibration, set);
     }
 
-    return ret;
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    return ok;
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::SplitDataSet(const Char_t* data, const Char_t* calibration, Int_t set,
-                                    Int_t lastRunFirstSet)
+Bool_t TCMySQLManager::SplitDataSets(TList* data, const Char_t* calibration, Int_t set,
+                                     Int_t lastRunFirstSet)
 {
-    // Split the set 'set' of the calibration data 'data' and the calibration identifier
-    // 'calibration' into two sets. 'lastRunFirstSet' will be the last run of the first 
-    // set. The first run of the second set will be the next found run in the database.
+    // Split the sets 'set' of the calibration data in the list 'data' and the 
+    // calibration identifier 'calibration' into two sets. 'lastRunFirstSet' 
+    // will be the last run of the first set. The first run of the second set 
+    // will be the next found run in the database. The second sets are copied
+    // from the first sets by the database server and all sets are split in 
+    // one transaction.
     
     Char_t query[256];
     Char_t tmp[256];
@@ -2133,21 +4681,12 @@ Bool_t TCMySQLManager::SplitDataSet(const Char_t* data, const Char_t* calibratio
     // check if splitting run exists
     if (!SearchRunEntry(lastRunFirstSet, "run", tmp))
     {
-        if (!fSilence) Error("SplitDataSet", "Splitting run has no valid run number!");
+        if (!fSilence) Error("SplitDataSets", "Splitting run has no valid run number!");
         return kFALSE;
     }
  
-    // check if splitting run is in set
-    Int_t first_run = GetFirstRunOfSet(data, calibration, set);
-    Int_t last_run = GetLastRunOfSet(data, calibration, set);
-    if (lastRunFirstSet < first_run || lastRunFirstSet > last_run)
-    {
-        if (!fSilence) Error("SplitDataSet", "Splitting run has to be in set!");
-        return kFALSE;
-    }
-
     //
-    // get the first and last run of the second set
+    // get the first run of the second set
     //
     
     // create the query
@@ -2157,94 +4696,117 @@ Bool_t TCMySQLManager::SplitDataSet(const Char_t* data, const Char_t* calibratio
             "ORDER by run LIMIT 1",
             TCConfig::kCalibMainTableName, lastRunFirstSet);
 
-    // read from database
-    TSQLResult* res = SendQuery(query);
-    if (!res)
-    {
-        if (!fSilence) Error("SplitDataSet", "Cannot find first run of second set!");
-        return kFALSE;
-    }
-    if (!res->GetRowCount())
+    // read from database
+    TSQLResult* res = SendQuery(query);
+    if (!res)
     {
-        if (!fSilence) Error("SplitDataSet", "Cannot find first run of second set!");
-        delete res;
+        if (!fSilence) Error("SplitDataSets", "Cannot find first run of second set!");
         return kFALSE;
     }
     
-    // get row
-    TSQLRow* row = res->Next();
-  
     // get the first run of the second set
     Int_t firstRunSecondSet = 0;
-    const Char_t* field = row->GetField(0);
-    if (!field) 
+    if (TSQLRow* row = res->Next())
     {
-        if (!fSilence) Error("SplitDataSet", "Cannot find first run of second set!");
-        return kFALSE;
+        if (row->GetField(0)) firstRunSecondSet = atoi(row->GetField(0));
+        delete row;
     }
-    else firstRunSecondSet = atoi(field);
-    
-    // clean-up
-    delete row;
     delete res;
-    
-    // get the last run of the second set
-    Int_t lastRunSecondSet = last_run;
-
-    // 
-    // backup values
-    //
-
-    // backup the description
-    Char_t desc[256];
-    if (!SearchSetEntry(data, calibration, set, "description", desc))
+    if (!firstRunSecondSet)
     {
-        if (!fSilence) Error("SplitDataSet", "Cannot read description of set %d in '%s' of calibration '%s'",
-                          set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
+        if (!fSilence) Error("SplitDataSets", "Cannot find first run of second set!");
         return kFALSE;
     }
 
-    // get number of parameters
-    Int_t nPar = ((TCCalibData*) fData->FindObject(data))->GetSize();
+    // start the transaction
+    if (!StartTransaction()) return kFALSE;
 
-    // backup parameters
-    Double_t par[nPar];
-    if (!ReadParameters(data, calibration, set, par, nPar))
-    {
-        if (!fSilence) Error("SplitDataSet", "Cannot backup parameters of set %d in '%s' of calibration '%s'",
-                          set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
-    }
+    // copy inherited sets of overlay calibrations
+    Bool_t ok = MaterializeDataSets(data, calibration);
 
-    // 
-    // modify first set
+    //
+    // get the sets to split
     //
 
-    // change the last run of the first set
-    sprintf(tmp, "%d", lastRunFirstSet);
-    if (!ChangeSetEntry(data, calibration, set, "last_run", tmp))
-    {
-        if (!fSilence) Error("SplitDataSet", "Cannot change last run of set %d in '%s' of calibration '%s'",
-                          set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
-        return kFALSE;
-    }
-    else
+    Int_t* first_run = new Int_t[data->GetSize()];
+    Int_t n = 0;
+    TIter next(data);
+    TCCalibData* d;
+    while (ok && (d = (TCCalibData*)next()))
     {
-        if (!fSilence) Info("SplitDataSet", "Changed last run of set %d in '%s' of calibration '%s' to %d",
-                                        set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration, lastRunFirstSet);
+        // get the sets
+        TCSetTable* sets = GetSetTable(d->GetName(), calibration);
+        
+        // check the set
+        if (!sets || set < 0 || set >= sets->GetNSet())
+        {
+            if (!fSilence) Error("SplitDataSets", "Could not find set %d in '%s' of calibration '%s'!",
+                                 set, d->GetTitle(), calibration);
+            ok = kFALSE;
+        }
+        
+        // check if the splitting run is in the set
+        else if (lastRunFirstSet < sets->GetFirstRun(set) || firstRunSecondSet > sets->GetLastRun(set))
+        {
+            if (!fSilence) Error("SplitDataSets", "Splitting run has to be in set %d of '%s' and "
+                                 "cannot be its last run!", set, d->GetTitle());
+            ok = kFALSE;
+        }
+        else first_run[n++] = sets->GetFirstRun(set);
+
+        // clean-up
+        if (sets) delete sets;
     }
-    
+
     //
-    // add second set
+    // split the sets
     //
-    
-    if (!AddDataSet(data, calibration, desc, firstRunSecondSet, lastRunSecondSet, par, nPar))
-    {
-        if (!fSilence) Error("SplitDataSet", "Cannot split set %d in '%s' of calibration '%s'",
-                             set, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
-        return kFALSE;
+
+    n = 0;
+    next.Reset();
+    while (ok && (d = (TCCalibData*)next()))
+    {
+        // copy the set as second set
+        TString cols = GetParameterColumns(d->GetTableName(), d->GetSize());
+        TString q = TString::Format("INSERT INTO %s (calibration,description,first_run,last_run,%s) "
+                                    "SELECT calibration,description,%d,last_run,%s FROM %s "
+                                    "WHERE calibration = '%s' AND first_run = %d",
+                                    d->GetTableName(), cols.Data(), firstRunSecondSet, cols.Data(),
+                                    d->GetTableName(), calibration, first_run[n]);
+        res = SendQuery(q.Data());
+
+        // change the last run of the first set
+        if (res)
+        {
+            delete res;
+            q = TString::Format("UPDATE %s SET last_run = %d WHERE calibration = '%s' AND first_run = %d",
+                                d->GetTableName(), lastRunFirstSet, calibration, first_run[n]);
+            res = SendQuery(q.Data());
+        }
+
+        // check result
+        if (res) delete res;
+        else
+        {
+            if (!fSilence) Error("SplitDataSets", "Cannot split set %d in '%s' of calibration '%s'",
+                                 set, d->GetTitle(), calibration);
+            ok = kFALSE;
+        }
+        n++;
     }
+
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // clean-up
+    delete [] first_run;
+
+    // user information
+    if (ok && !fSilence) Info("SplitDataSets", "Split set %d of %d calibration data of calibration '%s' after run %d",
+                              set, data->GetSize(), calibration, lastRunFirstSet);
     
-    return kTRUE;
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -2255,36 +4817,22 @@ Bool_t TCMySQLManager::SplitSet(const Char_t* type, const Char_t* calibration, I
     // 'calibration' into two sets. 'lastRunFirstSet' will be the last run of the first 
     // set. The first run of the second set will be the next found run in the database.
     
-    Bool_t ret = kTRUE;
-    
     // get calibration type and data list
     TCCalibType* t = (TCCalibType*) fTypes->FindObject(type);
-    TList* data = t->GetData();
     
-    // loop over calibration data of this calibration type
-    TIter next(data);
-    TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
-    {
-        // split set of calibration data
-        if (!SplitDataSet(d->GetName(), calibration, set, lastRunFirstSet))
-            ret = kFALSE;
-    }
-
-    return ret;
+    // split the sets of all calibration data of this calibration type
+    return SplitDataSets(t->GetData(), calibration, set, lastRunFirstSet);
 }
 
 //______________________________________________________________________________
-Bool_t TCMySQLManager::MergeDataSets(const Char_t* data, const Char_t* calibration, 
+Bool_t TCMySQLManager::MergeDataSets(TList* data, const Char_t* calibration, 
                                      Int_t set1, Int_t set2)
 {
-    // Merge the two adjacent sets 'set1' and 'set2' of the calibration data 'data' and the 
-    // calibration identifier 'calibration' into one set. Description and parameters
-    // of 'set1' will be used in the merged set.
-    // get the first run of the set
+    // Merge the two adjacent sets 'set1' and 'set2' of the calibration data in the
+    // list 'data' and the calibration identifier 'calibration' into one set. 
+    // Description and parameters of 'set1' will be used in the merged set.
+    // The sets of all calibration data are merged in one transaction.
     
-    Char_t tmp[256];
-
     // check if the two sets are adjacent 
     if (TMath::Abs(set2 - set1) != 1)
     {
@@ -2292,61 +4840,95 @@ Bool_t TCMySQLManager::MergeDataSets(const Char_t* data, const Char_t* calibrati
         return kFALSE;
     }
 
-    // get information of set 1
-    Int_t firstSet1 = GetFirstRunOfSet(data, calibration, set1);
-    Int_t lastSet1 = GetLastRunOfSet(data, calibration, set1);
-    
-    // get information of set 2
-    Int_t firstSet2 = GetFirstRunOfSet(data, calibration, set2);
-    Int_t lastSet2 = GetLastRunOfSet(data, calibration, set2);
+    // start the transaction
+    if (!StartTransaction()) return kFALSE;
 
-    // check set 1
-    if (!firstSet1 || !lastSet1)
-    {
-        if (!fSilence) Error("MergeDataSets", "Could not find set %d in '%s' of calibration '%s'!",
-                             set1, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
-        return kFALSE;
-    }
+    // copy inherited sets of overlay calibrations
+    Bool_t ok = MaterializeDataSets(data, calibration);
 
-    // check set 2
-    if (!firstSet2 || !lastSet2)
-    {
-        if (!fSilence) Error("MergeDataSets", "Could not find set %d in '%s' of calibration '%s'!",
-                             set2, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
-        return kFALSE;
-    }
+    //
+    // get the sets to merge
+    //
 
-    // delete set 2
-    if (!RemoveDataSet(data, calibration, set2))
-    {
-        if (!fSilence) Error("MergeDataSets", "Could not remove set %d!", set2);
-        return kFALSE;
-    }
-    
-    // adjust run interval
-    // check if set 2 was in front of set 1
-    if (firstSet2 < firstSet1)
+    Int_t* first1 = new Int_t[data->GetSize()];
+    Int_t* first2 = new Int_t[data->GetSize()];
+    Int_t* last = new Int_t[data->GetSize()];
+    Int_t n = 0;
+    TIter next(data);
+    TCCalibData* d;
+    while (ok && (d = (TCCalibData*)next()))
     {
-        // adjust first run of remaining set
-        sprintf(tmp, "%d", firstSet2);
-        if (!ChangeSetEntry(data, calibration, set1-1, "first_run", tmp))
+        // get the sets
+        TCSetTable* sets = GetSetTable(d->GetName(), calibration);
+        
+        // check the sets
+        if (!sets || set1 < 0 || set1 >= sets->GetNSet() || set2 < 0 || set2 >= sets->GetNSet())
         {
-            if (!fSilence) Error("MergeDataSets", "Could not adjust run interval of set %d!", set1-1);
-            return kFALSE;
+            if (!fSilence) Error("MergeDataSets", "Could not find sets %d and %d in '%s' of calibration '%s'!",
+                                 set1, set2, d->GetTitle(), calibration);
+            ok = kFALSE;
         }
+        else
+        {
+            first1[n] = sets->GetFirstRun(set1);
+            first2[n] = sets->GetFirstRun(set2);
+            last[n] = TMath::Max(sets->GetLastRun(set1), sets->GetLastRun(set2));
+            n++;
+        }
+
+        // clean-up
+        if (sets) delete sets;
     }
-    else
+
+    //
+    // merge the sets
+    //
+
+    n = 0;
+    next.Reset();
+    while (ok && (d = (TCCalibData*)next()))
     {
-        // adjust last run of remaining set
-        sprintf(tmp, "%d", lastSet2);
-        if (!ChangeSetEntry(data, calibration, set1, "last_run", tmp))
+        // delete set 2
+        TString q = TString::Format("DELETE FROM %s WHERE calibration = '%s' AND first_run = %d",
+                                    d->GetTableName(), calibration, first2[n]);
+        TSQLResult* res = SendQuery(q.Data());
+
+        // adjust the run interval of set 1
+        if (res)
         {
-            if (!fSilence) Error("MergeDataSets", "Could not adjust run interval of set %d!", set1);
-            return kFALSE;
+            delete res;
+            q = TString::Format("UPDATE %s SET first_run = %d, last_run = %d "
+                                "WHERE calibration = '%s' AND first_run = %d",
+                                d->GetTableName(), TMath::Min(first1[n], first2[n]), last[n], 
+                                calibration, first1[n]);
+            res = SendQuery(q.Data());
+        }
+
+        // check result
+        if (res) delete res;
+        else
+        {
+            if (!fSilence) Error("MergeDataSets", "Could not merge sets %d and %d in '%s' of calibration '%s'!",
+                                 set1, set2, d->GetTitle(), calibration);
+            ok = kFALSE;
         }
+        n++;
     }
 
-    return kTRUE;
+    // finish the transaction
+    if (ok) ok = CommitTransaction();
+    else RollbackTransaction();
+
+    // clean-up
+    delete [] first1;
+    delete [] first2;
+    delete [] last;
+
+    // user information
+    if (ok && !fSilence) Info("MergeDataSets", "Merged sets %d and %d of %d calibration data of calibration '%s'",
+                              set1, set2, data->GetSize(), calibration);
+
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -2356,25 +4938,12 @@ Bool_t TCMySQLManager::MergeSets(const Char_t* type, const Char_t* calibration,
     // Merge all adjacent pairs of the sets 'set1' and 'set2' of the calibration type 'type' and the 
     // calibration identifier 'calibration' into one set. Description and parameters
     // of 'set1' will be used in the merged set.
-    // get the first run of the set
-    
-    Bool_t ret = kTRUE;
     
     // get calibration type and data list
     TCCalibType* t = (TCCalibType*) fTypes->FindObject(type);
-    TList* data = t->GetData();
     
-    // loop over calibration data of this calibration type
-    TIter next(data);
-    TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
-    {
-        // merge sets of calibration data
-        if (!MergeDataSets(d->GetName(), calibration, set1, set2))
-            ret = kFALSE;
-    }
-
-    return ret;
+    // merge the sets of all calibration data of this calibration type
+    return MergeDataSets(t->GetData(), calibration, set1, set2);
 }
 
 //______________________________________________________________________________
@@ -2383,100 +4952,90 @@ Int_t TCMySQLManager::DumpRuns(TCContainer* container, Int_t first_run, Int_t la
     // Dump the run information from run 'first_run' to run 'last_run' to 
     // the CaLib container 'container'.
     // If first_run and last_run is zero all available runs will be dumped.
+    // All run information is read with one query per chunk of 
+    // TCConfig::kDumpChunkSize runs to keep the memory usage bounded.
     // Return the number of dumped runs.
 
-    Char_t query[256];
-    Char_t tmp[65536];
-
-    // create the query
+    // select all runs
     if (!first_run && !last_run)
     {
-        sprintf(query,
-                "SELECT run FROM %s "
-                "ORDER by run",
-                TCConfig::kCalibMainTableName);
-    }
-    else
-    {
-        sprintf(query,
-                "SELECT run FROM %s "
-                "WHERE run >= %d "
-                "AND run <= %d "
-                "ORDER by run",
-                TCConfig::kCalibMainTableName, first_run, last_run);
+        first_run = kMinInt;
+        last_run = kMaxInt;
     }
 
-    // read from database
-    TSQLResult* res = SendQuery(query);
-
-    // get number of runs
-    Int_t nruns = res->GetRowCount();
-
-    // loop over runs
-    for (Int_t i = 0; i < nruns; i++)
+    // loop over chunks
+    Int_t nruns = 0;
+    Int_t next_run = first_run;
+    while (kTRUE)
     {
-        // get next run
-        TSQLRow* row = res->Next();
-        
-        // get run number
-        Int_t run_number = atoi(row->GetField(0));
+        // create the query
+        TString query = TString::Format("SELECT run, path, filename, time, description, run_note, "
+                                        "size, scr_n, scr_bad, target, target_pol, target_pol_deg, "
+                                        "beam_pol, beam_pol_deg FROM %s "
+                                        "WHERE run >= %d "
+                                        "AND run <= %d "
+                                        "ORDER by run LIMIT %d",
+                                        TCConfig::kCalibMainTableName, next_run, last_run,
+                                        TCConfig::kDumpChunkSize);
 
-        // add new run
-        TCRun* run = container->AddRun(run_number);
-        
-        // set path
-        if (SearchRunEntry(run_number, "path", tmp)) run->SetPath(tmp);
-        
-        // set filename
-        if (SearchRunEntry(run_number, "filename", tmp)) run->SetFileName(tmp);
-        
-        // set time
-        if (SearchRunEntry(run_number, "time", tmp)) run->SetTime(tmp);
-        
-        // set description
-        if (SearchRunEntry(run_number, "description", tmp)) run->SetDescription(tmp);
-        
-        // set run_note
-        if (SearchRunEntry(run_number, "run_note", tmp)) run->SetRunNote(tmp);
+        // read from database
+        TSQLResult* res = SendQuery(query.Data());
+
+        // check result
+        if (!res)
+        {
+            if (!fSilence) Error("DumpRuns", "Could not read the runs starting at run %d!", next_run);
+            break;
+        }
         
-        // set size
-        if (SearchRunEntry(run_number, "size", tmp)) 
+        // loop over runs
+        Int_t nChunk = res->GetRowCount();
+        Int_t run_number = 0;
+        for (Int_t i = 0; i < nChunk; i++)
         {
-            Long64_t size;
-            sscanf(tmp, "%lld", &size);
+            // get next run
+            TSQLRow* row = res->Next();
+            
+            // get run number
+            run_number = atoi(row->GetField(0));
+
+            // add new run
+            TCRun* run = container->AddRun(run_number);
+            
+            // set information
+            run->SetPath(GetField(row, 1));
+            run->SetFileName(GetField(row, 2));
+            run->SetTime(GetField(row, 3));
+            run->SetDescription(GetField(row, 4));
+            run->SetRunNote(GetField(row, 5));
+            Long64_t size = 0;
+            sscanf(GetField(row, 6), "%lld", &size);
             run->SetSize(size);
+            run->SetNScalerReads(atoi(GetField(row, 7)));
+            run->SetBadScalerReads(GetField(row, 8));
+            run->SetTarget(GetField(row, 9));
+            run->SetTargetPol(GetField(row, 10));
+            run->SetTargetPolDeg(atof(GetField(row, 11)));
+            run->SetBeamPol(GetField(row, 12));
+            run->SetBeamPolDeg(atof(GetField(row, 13)));
+            
+            // clean-up
+            delete row;
         }
         
-        // set scaler reads
-        if (SearchRunEntry(run_number, "scr_n", tmp)) run->SetNScalerReads(atoi(tmp));
-        
-        // set bad scaler reads
-        if (SearchRunEntry(run_number, "scr_bad", tmp)) run->SetBadScalerReads(tmp);
-        
-        // set target
-        if (SearchRunEntry(run_number, "target", tmp)) run->SetTarget(tmp);
-        
-        // set target polarization
-        if (SearchRunEntry(run_number, "target_pol", tmp)) run->SetTargetPol(tmp);
-        
-        // set target polarization degree
-        if (SearchRunEntry(run_number, "target_pol_deg", tmp)) run->SetTargetPolDeg(atof(tmp));
-        
-        // set beam polarization
-        if (SearchRunEntry(run_number, "beam_pol", tmp)) run->SetBeamPol(tmp);
+        // clean-up
+        delete res;
 
-        // set beam polarization degree
-        if (SearchRunEntry(run_number, "beam_pol_deg", tmp)) run->SetBeamPolDeg(atof(tmp));
-        
-        // user information
-        if (!fSilence) Info("DumpRuns", "Dumped run %d", run_number);
+        // count runs
+        nruns += nChunk;
 
-        // clean-up
-        delete row;
+        // check for last chunk
+        if (nChunk < TCConfig::kDumpChunkSize || run_number == kMaxInt) break;
+        next_run = run_number + 1;
     }
     
-    // clean-up
-    delete res;
+    // user information
+    if (!fSilence) Info("DumpRuns", "Dumped %d runs", nruns);
 
     return nruns;
 }
@@ -2494,9 +5053,6 @@ Int_t TCMySQLManager::DumpCalibrations(TCContainer* container, const Char_t* cal
     // get number of parameters
     Int_t nPar = ((TCCalibData*) fData->FindObject(data))->GetSize();
 
-    // create the parameter array
-    Double_t par[nPar];
-
     // get the number of sets
     Int_t nSet = GetNsets(data, calibration);
     
@@ -2508,6 +5064,9 @@ Int_t TCMySQLManager::DumpCalibrations(TCContainer* container, const Char_t* cal
         return 0;
     }
 
+    // create the parameter array
+    Double_t* par = new Double_t[nPar];
+
     // loop over sets
     for (Int_t i = 0; i < nSet; i++)
     {
@@ -2536,6 +5095,9 @@ Int_t TCMySQLManager::DumpCalibrations(TCContainer* container, const Char_t* cal
         c->SetParameters(nPar, par);
     }
 
+    // clean-up
+    delete [] par;
+
     // user information
     if (!fSilence) Info("DumpCalibrations", "Dumped %d sets of '%s' of the calibration '%s'",
                         nSet, ((TCCalibData*) fData->FindObject(data))->GetTitle(), calibration);
@@ -2548,19 +5110,46 @@ Int_t TCMySQLManager::DumpAllCalibrations(TCContainer* container, const Char_t*
 {
     // Dump all calibrations with the calibration identifier 'calibration' to
     // the CaLib container 'container'.
+    // The calibration data are dumped in parallel to temporary containers 
+    // using the pooled connections and merged in the order of the data.
     // Return the number of dumped calibrations.
     
-    Int_t nDump = 0;
+    // create one task per calibration data
+    Int_t nData = fData->GetSize();
+    const Char_t** data = new const Char_t*[nData];
+    TCContainer** cont = new TCContainer*[nData];
+    Int_t* result = new Int_t[nData];
+    for (Int_t i = 0; i < nData; i++) 
+    {
+        data[i] = fData->At(i)->GetName();
+        cont[i] = new TCContainer("tmp");
+    }
+    TCMySQLManagerTask task;
+    task.fCalibration = calibration;
+    task.fData = data;
+    task.fContainer = cont;
+    task.fResult = result;
+    
+    // dump calibrations
+    RunParallel(kTaskDump, nData, (void*) &task);
 
-    // loop over calibration data
-    TIter next(fData);
-    TCCalibData* d;
-    while ((d = (TCCalibData*)next()))
+    // merge the calibrations
+    Int_t nDump = 0;
+    for (Int_t i = 0; i < nData; i++)
     {
-        // dump calibrations
-        if (Int_t nd = DumpCalibrations(container, calibration, d->GetName())) nDump += nd;
+        TIter next(cont[i]->GetCalibrations());
+        TObject* c;
+        while ((c = next())) container->GetCalibrations()->Add(c);
+        cont[i]->GetCalibrations()->Clear("nodelete");
+        delete cont[i];
+        nDump += result[i];
     }
 
+    // clean-up
+    delete [] data;
+    delete [] cont;
+    delete [] result;
+
     return nDump;
 }
 
@@ -2568,65 +5157,65 @@ Int_t TCMySQLManager::DumpAllCalibrations(TCContainer* container, const Char_t*
 Int_t TCMySQLManager::ImportRuns(TCContainer* container)
 {
     // Import all runs from the CaLib container 'container' to the database.
+    // The runs are written in chunks using multi-row inserts (see InsertRows()).
     // Return the number of imported runs.
 
     // get number of runs
     Int_t nRun = container->GetNRuns();
 
-    // loop over runs
-    Int_t nRunAdded = 0;
+    // prepare the values of the runs
+    TString* values = new TString[nRun];
     for (Int_t i = 0; i < nRun; i++)
     {
         // get the run
         TCRun* r = container->GetRun(i);
         
-        // prepare the insert query
-        TString ins_query = TString::Format("INSERT INTO %s SET "
-                                            "run = %d, "
-                                            "path = '%s', "
-                                            "filename = '%s', "
-                                            "time = '%s', "
-                                            "description = '%s', "
-                                            "run_note = '%s', "
-                                            "size = %lld, "
-                                            "scr_n = %d, "
-                                            "scr_bad = '%s', "
-                                            "target = '%s', "
-                                            "target_pol = '%s', "
-                                            "target_pol_deg = %lf, "
-                                            "beam_pol = '%s', "
-                                            "beam_pol_deg = %lf",
-                                            TCConfig::kCalibMainTableName, 
-                                            r->GetRun(),
-                                            r->GetPath(),
-                                            r->GetFileName(),
-                                            r->GetTime(),
-                                            r->GetDescription(),
-                                            r->GetRunNote(),
-                                            r->GetSize(),
-                                            r->GetNScalerReads(),
-                                            r->GetBadScalerReads(),
-                                            r->GetTarget(),
-                                            r->GetTargetPol(),
-                                            r->GetTargetPolDeg(),
-                                            r->GetBeamPol(),
-                                            r->GetBeamPolDeg());
-
-        // try to write data to database
-        TSQLResult* res = SendQuery(ins_query.Data());
-        if (res == 0)
+        // prepare the values
+        values[i] = TString::Format("%d, %s, %s, %s, %s, "
+                                    "%s, %lld, %d, %s, %s, "
+                                    "%s, %lf, %s, %lf",
+                                    r->GetRun(),
+                                    fBackend->Quote(r->GetPath()).Data(),
+                                    fBackend->Quote(r->GetFileName()).Data(),
+                                    fBackend->Quote(r->GetTime()).Data(),
+                                    fBackend->Quote(r->GetDescription()).Data(),
+                                    fBackend->Quote(r->GetRunNote()).Data(),
+                                    r->GetSize(),
+                                    r->GetNScalerReads(),
+                                    fBackend->Quote(r->GetBadScalerReads()).Data(),
+                                    fBackend->Quote(r->GetTarget()).Data(),
+                                    fBackend->Quote(r->GetTargetPol()).Data(),
+                                    r->GetTargetPolDeg(),
+                                    fBackend->Quote(r->GetBeamPol()).Data(),
+                                    r->GetBeamPolDeg());
+    }
+
+    // write the runs to the database
+    Bool_t* ok = new Bool_t[nRun];
+    Int_t nRunAdded = InsertRows(TCConfig::kCalibMainTableName,
+                                 "run, path, filename, time, description, "
+                                 "run_note, size, scr_n, scr_bad, target, "
+                                 "target_pol, target_pol_deg, beam_pol, beam_pol_deg",
+                                 nRun, values, ok);
+    
+    // report the results of the runs
+    for (Int_t i = 0; i < nRun; i++)
+    {
+        if (ok[i]) 
         {
-            Warning("ImportRuns", "Run %d could not be added to the database!", 
-                    r->GetRun());
+            if (!fSilence) Info("ImportRuns", "Added run %d to the database", container->GetRun(i)->GetRun());
         }
         else
         {
-            if (!fSilence) Info("ImportRuns", "Added run %d to the database", r->GetRun());
-            nRunAdded++;
-            delete res;
+            Warning("ImportRuns", "Run %d could not be added to the database!", 
+                    container->GetRun(i)->GetRun());
         }
     }
 
+    // clean-up
+    delete [] values;
+    delete [] ok;
+
     // user information
     if (!fSilence) Info("ImportRuns", "Added %d runs to the database", nRunAdded);
     
@@ -2640,40 +5229,40 @@ Int_t TCMySQLManager::ImportCalibrations(TCContainer* container, const Char_t* n
     // Import all calibrations from the CaLib container 'container' to the database.
     // If 'newCalibName' is non-zero rename the calibration to 'newCalibName'
     // If 'data' is not 0 import only calibrations of the data 'data'.
+    // The calibration data are imported in parallel using the pooled 
+    // connections.
     // Return the number of imported calibrations.
 
-    // get number of calibrations
-    Int_t nCalib = container->GetNCalibrations();
-
-    // loop over calibrations
-    Int_t nCalibAdded = 0;
-    for (Int_t i = 0; i < nCalib; i++)
+    // collect the calibration data to import
+    Int_t nData = 0;
+    const Char_t** imp = new const Char_t*[fData->GetSize()];
+    TIter next(fData);
+    TCCalibData* d;
+    while ((d = (TCCalibData*)next()))
     {
-        // get the calibration
-        TCCalibration* c = container->GetCalibration(i);
-        
         // skip unwanted calibration data
-        if (data != 0 && strcmp(c->GetCalibData(), data)) continue;
+        if (data != 0 && strcmp(d->GetName(), data)) continue;
+        imp[nData++] = d->GetName();
+    }
 
-        // add the set with new calibration identifer or the same
-        const Char_t* calibration;
-        if (newCalibName) calibration = newCalibName;
-        else calibration = c->GetCalibration();
+    // create one task per calibration data
+    Int_t* result = new Int_t[fData->GetSize()];
+    TCMySQLManagerTask task;
+    task.fNewCalibration = newCalibName;
+    task.fData = imp;
+    task.fContainer = &container;
+    task.fResult = result;
 
-        // add the set
-        if (AddDataSet(c->GetCalibData(), calibration, c->GetDescription(), 
-                       c->GetFirstRun(), c->GetLastRun(), c->GetParameters(), c->GetNParameters(), kTRUE))
-        {
-            if (!fSilence) Info("ImportCalibrations", "Added calibration '%s' of '%s' to the database",
-                                calibration, ((TCCalibData*) fData->FindObject(c->GetCalibData()))->GetTitle());
-            nCalibAdded++;
-        }
-        else
-        {
-            if (!fSilence) Error("ImportCalibrations", "Calibration '%s' of '%s' could not be added to the database!",
-                                 calibration, ((TCCalibData*) fData->FindObject(c->GetCalibData()))->GetTitle());
-        }
-    }
+    // import calibrations
+    RunParallel(kTaskImport, nData, (void*) &task);
+
+    // count the imported calibrations
+    Int_t nCalibAdded = 0;
+    for (Int_t i = 0; i < nData; i++) nCalibAdded += result[i];
+
+    // clean-up
+    delete [] imp;
+    delete [] result;
 
     // user information
     if (!fSilence) Info("ImportCalibrations", "Added %d calibrations to the database", nCalibAdded);
@@ -2683,12 +5272,20 @@ Int_t TCMySQLManager::ImportCalibrations(TCContainer* container, const Char_t* n
 
 //______________________________________________________________________________
 Bool_t TCMySQLManager::CloneCalibration(const Char_t* calibration, const Char_t* newCalibrationName,
-                                      const Char_t* newDesc, Int_t new_first_run, Int_t new_last_run)
+                                      const Char_t* newDesc, Int_t new_first_run, Int_t new_last_run,
+                                      Bool_t parallel)
 {
     // Create a clone of the calibration 'calibration' using 'newCalibrationName' as
     // the new calibration name and 'newDesc' as the calibration description.
     // For each calibration data one set from 'new_first_run' to 'new_last_run' 
     // is created with the values of the last set of the original calibration.
+    // The sets are copied by the database server in one transaction, i.e. 
+    // either all or no calibration data are cloned. If 'parallel' is kTRUE,
+    // the calibration data are cloned in parallel using the pooled connections
+    // with one transaction per connection (not supported by all backends).
+    // The parallel transactions are not atomic as a whole: if they were only
+    // partially committed, a new calibration 'newCalibrationName' is removed
+    // again.
     // Return kFALSE if an error occurred, otherwise kTRUE.
 
     // check if original calibration exists
@@ -2698,44 +5295,77 @@ Bool_t TCMySQLManager::CloneCalibration(const Char_t* calibration, const Char_t*
         return kFALSE;
     }
 
-    // loop over calibration data
-    TIter next(fData);
-    TCCalibData* d;
-    Bool_t error = kFALSE;
-    while ((d = (TCCalibData*)next()))
+    // check if the parallel transactions are supported
+    if (parallel && !fBackend->HasParallelTransactions())
     {
-        // get number of original sets
-        Int_t nSets = GetNsets(d->GetName(), calibration);
-        
-        // read parameters
-        Double_t par[d->GetSize()];
-        if (ReadParameters(d->GetName(), calibration, nSets-1, par, d->GetSize()))
-        {
-            // add new set
-            if (!AddDataSet(d->GetName(), newCalibrationName, newDesc, new_first_run, new_last_run, par, d->GetSize()))
-            {
-                if (!fSilence) Error("CloneCalibration", "Could not clone calibration data '%s'!", d->GetName());
-                error = kTRUE;
-            }
-        }
-        else
-        {
-            if (!fSilence) Error("CloneCalibration", "Could not read original data '%s'!", d->GetName());
-            error = kTRUE;
-        }
+        if (!fSilence) Warning("CloneCalibration", "Parallel cloning is not supported by the "
+                               "'%s' backend - cloning serially", fBackend->GetType());
+        parallel = kFALSE;
     }
-    
-    // check if an error occurred
-    if (error)
+
+    // check the runs and the sets of the new calibration (the sets are 
+    // copied by the database server without the checks of AddDataSet())
+    if (!CheckSetRunRange(fData, newCalibrationName, new_first_run, new_last_run))
     {
-        // remove partially cloned calibrations when an error occurred
-        RemoveAllCalibrations(newCalibrationName);
+        if (!fSilence) Error("CloneCalibration", "Could not clone calibration '%s'!", calibration);
         return kFALSE;
     }
+
+    // create one task per calibration data
+    Int_t nData = fData->GetSize();
+    const Char_t** data = new const Char_t*[nData];
+    Int_t* result = new Int_t[nData];
+    for (Int_t i = 0; i < nData; i++) data[i] = fData->At(i)->GetName();
+    TCMySQLManagerTask task;
+    task.fCalibration = calibration;
+    task.fNewCalibration = newCalibrationName;
+    task.fDesc = newDesc;
+    task.fFirstRun = new_first_run;
+    task.fLastRun = new_last_run;
+    task.fData = data;
+    task.fResult = result;
+
+    // clone the calibration data
+    Bool_t ok;
+    if (parallel) 
+    {
+        Bool_t exists = ContainsCalibration(newCalibrationName);
+        Int_t nOK = RunParallel(kTaskClone, nData, (void*) &task, kTRUE);
+        ok = nOK == nData;
+
+        // remove partially cloned new calibrations
+        if (nOK == -1)
+        {
+            if (!exists) RemoveAllCalibrations(newCalibrationName);
+            else if (!fSilence) Error("CloneCalibration", "Calibration '%s' contains partially cloned sets!",
+                                      newCalibrationName);
+        }
+    }
     else
     {
-        return kTRUE;
+        // clone serially in one transaction
+        ok = kFALSE;
+        if (StartTransaction())
+        {
+            ok = kTRUE;
+            for (Int_t i = 0; ok && i < nData; i++) ok = RunTask(kTaskClone, i, (void*) &task);
+            if (ok) ok = CommitTransaction();
+            else RollbackTransaction();
+        }
+    }
+
+    // clean-up
+    delete [] data;
+    delete [] result;
+
+    // user information
+    if (!fSilence)
+    {
+        if (ok) Info("CloneCalibration", "Cloned calibration '%s' to '%s'", calibration, newCalibrationName);
+        else Error("CloneCalibration", "Could not clone calibration '%s'!", calibration);
     }
+
+    return ok;
 }
 
 //______________________________________________________________________________
@@ -2788,6 +5418,29 @@ void TCMySQLManager::Export(const Char_t* filename, Int_t first_run, Int_t last_
     delete container;
 }
 
+//______________________________________________________________________________
+Bool_t TCMySQLManager::ExportSnapshot(const Char_t* filename, const Char_t* calibration)
+{
+    // Export all run information and the calibration 'calibration' to the
+    // read-only snapshot file 'filename' (see TCSnapshot).
+    // Return kTRUE on success, otherwise kFALSE.
+
+    // dump runs and calibrations
+    TCContainer container(TCConfig::kCaLibDumpName);
+    DumpRuns(&container);
+    DumpAllCalibrations(&container, calibration);
+
+    // check calibration
+    if (!container.GetNCalibrations())
+    {
+        if (!fSilence) Error("ExportSnapshot", "No sets of the calibration '%s' found!", calibration);
+        return kFALSE;
+    }
+
+    // write the snapshot
+    return TCSnapshot::Write(filename, &container, calibration);
+}
+
 //______________________________________________________________________________
 TCContainer* TCMySQLManager::LoadContainer(const Char_t* filename)
 {
@@ -0,0 +1,239 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCParameterCache                                                     //
+//                                                                      //
+// Client-side cache of calibration parameters.                         //
+//                                                                      //
+// The parameters of a set are cached together with the change time    //
+// of the set at the time they were read. A cached entry is only used   //
+// if the change time still matches the one found in the database.      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TCParameterCache.h"
+
+ClassImp(TCCachedParameters)
+ClassImp(TCParameterCache)
+
+
+//______________________________________________________________________________
+TCCachedParameters::TCCachedParameters(const Char_t* key, const Char_t* changed,
+                                       const Double_t* par, Int_t length)
+    : TNamed(key, changed)
+{
+    // Constructor caching the 'length' parameters 'par' of the set 'key'
+    // having the change time 'changed'.
+
+    fNPar = length;
+    fPar = new Double_t[fNPar];
+    for (Int_t i = 0; i < fNPar; i++) fPar[i] = par[i];
+}
+
+//______________________________________________________________________________
+TCParameterCache::TCParameterCache()
+    : TObject()
+{
+    // Constructor.
+
+    fEntries = new THashList();
+    fEntries->SetOwner(kTRUE);
+    fMutex = new TMutex();
+    fNHit = 0;
+    fNMiss = 0;
+}
+
+//______________________________________________________________________________
+TCParameterCache::~TCParameterCache()
+{
+    // Destructor.
+
+    if (fEntries) delete fEntries;
+    if (fMutex) delete fMutex;
+}
+
+//______________________________________________________________________________
+TString TCParameterCache::GetKey(const Char_t* table, const Char_t* calibration, Int_t first_run)
+{
+    // Return the cache key of the set starting at the run 'first_run' of the
+    // calibration 'calibration' in the data table 'table'.
+
+    return TString::Format("%s/%s/%d", table, calibration, first_run);
+}
+
+//______________________________________________________________________________
+Bool_t TCParameterCache::Get(const Char_t* table, const Char_t* calibration, Int_t first_run,
+                             const Char_t* changed, Double_t* par, Int_t length)
+{
+    // Copy the 'length' cached parameters of the set starting at the run
+    // 'first_run' of the calibration 'calibration' in the data table 'table'
+    // to 'par' if they were cached with the change time 'changed'.
+    // Return kTRUE on a cache hit, otherwise kFALSE.
+
+    Bool_t hit = kFALSE;
+
+    fMutex->Lock();
+    TCCachedParameters* c = (TCCachedParameters*) fEntries->FindObject(GetKey(table, calibration, first_run).Data());
+    if (c && c->GetNParameters() >= length && !strcmp(c->GetChangeTime(), changed))
+    {
+        for (Int_t i = 0; i < length; i++) par[i] = c->GetParameters()[i];
+        hit = kTRUE;
+        fNHit++;
+    }
+    else fNMiss++;
+    fMutex->UnLock();
+
+    return hit;
+}
+
+//______________________________________________________________________________
+void TCParameterCache::Set(const Char_t* table, const Char_t* calibration, Int_t first_run,
+                           const Char_t* changed, const Double_t* par, Int_t length)
+{
+    // Cache the 'length' parameters 'par' of the set starting at the run
+    // 'first_run' of the calibration 'calibration' in the data table 'table'
+    // having the change time 'changed'.
+
+    TString key = GetKey(table, calibration, first_run);
+
+    fMutex->Lock();
+    if (TObject* old = fEntries->FindObject(key.Data()))
+    {
+        fEntries->Remove(old);
+        delete old;
+    }
+    fEntries->Add(new TCCachedParameters(key.Data(), changed, par, length));
+    fMutex->UnLock();
+}
+
+//______________________________________________________________________________
+void TCParameterCache::Remove(const Char_t* table, const Char_t* calibration, Int_t first_run)
+{
+    // Remove the cached parameters of the set starting at the run 'first_run'
+    // of the calibration 'calibration' in the data table 'table'.
+
+    fMutex->Lock();
+    if (TObject* old = fEntries->FindObject(GetKey(table, calibration, first_run).Data()))
+    {
+        fEntries->Remove(old);
+        delete old;
+    }
+    fMutex->UnLock();
+}
+
+//______________________________________________________________________________
+void TCParameterCache::Clear(const Char_t* table)
+{
+    // Remove the cached parameters of the data table 'table' or all cached
+    // parameters if 'table' is 0.
+
+    fMutex->Lock();
+    if (!table) fEntries->Delete();
+    else
+    {
+        // collect the entries of the data table
+        TString prefix = TString::Format("%s/", table);
+        TList remove;
+        TIter next(fEntries);
+        TObject* o;
+        while ((o = next()))
+            if (TString(o->GetName()).BeginsWith(prefix)) remove.Add(o);
+
+        // remove them
+        TIter nextRemove(&remove);
+        while ((o = nextRemove()))
+        {
+            fEntries->Remove(o);
+            delete o;
+        }
+    }
+    fMutex->UnLock();
+}
+
+//______________________________________________________________________________
+Int_t TCParameterCache::Load(const Char_t* filename, const Char_t* db)
+{
+    // Add the cached parameters of the database 'db' saved in the ROOT file
+    // 'filename' to the cache. Entries are revalidated using their change 
+    // time when used.
+    // Return the number of loaded entries or -1 if the file was saved for 
+    // another database.
+
+    // open the file
+    TFile* f = TFile::Open(filename);
+    if (!f || f->IsZombie())
+    {
+        if (f) delete f;
+        return 0;
+    }
+
+    // check the database
+    TNamed* id = (TNamed*) f->Get("CaLib_ParameterCacheDB");
+    Bool_t same = id && !strcmp(id->GetTitle(), db) ? kTRUE : kFALSE;
+    if (id) delete id;
+    if (!same)
+    {
+        delete f;
+        return -1;
+    }
+
+    // load the entries
+    Int_t n = 0;
+    THashList* list = (THashList*) f->Get("CaLib_ParameterCache");
+    if (list)
+    {
+        fMutex->Lock();
+        TIter next(list);
+        TObject* o;
+        while ((o = next()))
+        {
+            if (!fEntries->FindObject(o->GetName()))
+            {
+                fEntries->Add(o);
+                n++;
+            }
+            else delete o;
+        }
+        fMutex->UnLock();
+        list->SetOwner(kFALSE);
+        delete list;
+    }
+
+    // clean-up
+    delete f;
+
+    return n;
+}
+
+//______________________________________________________________________________
+Bool_t TCParameterCache::Save(const Char_t* filename, const Char_t* db)
+{
+    // Save all cached parameters of the database 'db' to the ROOT file 
+    // 'filename'.
+    // Return kTRUE on success, otherwise kFALSE.
+
+    // create the file
+    TFile* f = new TFile(filename, "RECREATE");
+    if (f->IsZombie())
+    {
+        delete f;
+        return kFALSE;
+    }
+
+    // write the database and the entries
+    TNamed id("CaLib_ParameterCacheDB", db);
+    Int_t ok = id.Write();
+    fMutex->Lock();
+    if (ok > 0) ok = fEntries->Write("CaLib_ParameterCache", TObject::kSingleKey);
+    fMutex->UnLock();
+
+    // clean-up
+    delete f;
+
+    return ok > 0 ? kTRUE : kFALSE;
+}
+
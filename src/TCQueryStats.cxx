@@ -0,0 +1,269 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCQueryStats                                                         //
+//                                                                      //
+// Execution statistics of the database queries.                        //
+//                                                                      //
+// The queries are grouped by their shape, i.e. the query text with     //
+// all literals replaced by '?' and lists of literals collapsed (see    //
+// Normalize()). For every shape the number of calls, the total and     //
+// maximum execution time and the number of rows are recorded.          //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include <cctype>
+
+#include "TCQueryStats.h"
+
+ClassImp(TCQueryShape)
+ClassImp(TCQueryStats)
+
+
+//______________________________________________________________________________
+TCQueryShape::TCQueryShape(const Char_t* shape)
+    : TNamed(shape, "")
+{
+    // Constructor of the statistics of the query shape 'shape'.
+
+    fNCall = 0;
+    fNSlow = 0;
+    fNRow = 0;
+    fTotalTime = 0;
+    fMaxTime = 0;
+}
+
+//______________________________________________________________________________
+TCQueryShape::TCQueryShape(const TCQueryShape& s)
+    : TNamed(s)
+{
+    // Copy constructor.
+
+    fNCall = s.fNCall;
+    fNSlow = s.fNSlow;
+    fNRow = s.fNRow;
+    fTotalTime = s.fTotalTime;
+    fMaxTime = s.fMaxTime;
+}
+
+//______________________________________________________________________________
+void TCQueryShape::AddCall(Double_t time, Long64_t rows, Bool_t slow)
+{
+    // Add a call having the execution time 'time' [s] and the number of
+    // returned or affected rows 'rows'. 'slow' marks slow calls.
+
+    fNCall++;
+    if (slow) fNSlow++;
+    if (rows > 0) fNRow += rows;
+    fTotalTime += time;
+    if (time > fMaxTime) fMaxTime = time;
+}
+
+//______________________________________________________________________________
+Int_t TCQueryShape::Compare(const TObject* obj) const
+{
+    // Compare the total execution time to the one of the query shape 'obj'.
+    // Shapes having a longer total time are sorted first.
+
+    Double_t t = ((TCQueryShape*) obj)->GetTotalTime();
+
+    if (fTotalTime > t) return -1;
+    else if (fTotalTime < t) return 1;
+    else return 0;
+}
+
+//______________________________________________________________________________
+TCQueryStats::TCQueryStats()
+    : TObject()
+{
+    // Constructor.
+
+    fShapes = new THashList();
+    fShapes->SetOwner(kTRUE);
+    fMutex = new TMutex();
+}
+
+//______________________________________________________________________________
+TCQueryStats::~TCQueryStats()
+{
+    // Destructor.
+
+    if (fShapes) delete fShapes;
+    if (fMutex) delete fMutex;
+}
+
+//______________________________________________________________________________
+void TCQueryStats::Add(const Char_t* query, Double_t time, Long64_t rows, Bool_t slow)
+{
+    // Add a call of the query 'query' having the execution time 'time' [s]
+    // and the number of returned or affected rows 'rows' to the statistics
+    // of its shape. 'slow' marks slow calls.
+
+    TString shape = Normalize(query);
+
+    fMutex->Lock();
+    TCQueryShape* s = (TCQueryShape*) fShapes->FindObject(shape.Data());
+    if (!s)
+    {
+        s = new TCQueryShape(shape.Data());
+        fShapes->Add(s);
+    }
+    s->AddCall(time, rows, slow);
+    fMutex->UnLock();
+}
+
+//______________________________________________________________________________
+void TCQueryStats::Clear(Option_t* option)
+{
+    // Clear the statistics of all query shapes.
+
+    fMutex->Lock();
+    fShapes->Delete();
+    fMutex->UnLock();
+}
+
+//______________________________________________________________________________
+TList* TCQueryStats::GetShapes()
+{
+    // Return a copy of the statistics of all query shapes sorted by their
+    // total execution time.
+    // NOTE: The list must be destroyed by the caller.
+
+    TList* list = new TList();
+    list->SetOwner(kTRUE);
+
+    // copy the shapes
+    fMutex->Lock();
+    TIter next(fShapes);
+    TCQueryShape* s;
+    while ((s = (TCQueryShape*)next())) list->Add(new TCQueryShape(*s));
+    fMutex->UnLock();
+
+    // sort the shapes
+    list->Sort();
+
+    return list;
+}
+
+//______________________________________________________________________________
+void TCQueryStats::Print(Option_t* option) const
+{
+    // Print the statistics of all query shapes sorted by their total
+    // execution time.
+
+    TList* list = ((TCQueryStats*)this)->GetShapes();
+
+    // print header
+    printf("CaLib query statistics (%d query shapes)\n", list->GetSize());
+    printf("%10s %12s %10s %10s %12s %8s  %s\n",
+           "Calls", "Total [ms]", "Mean [ms]", "Max [ms]", "Rows", "Slow", "Query");
+
+    // print shapes
+    TIter next(list);
+    TCQueryShape* s;
+    while ((s = (TCQueryShape*)next()))
+    {
+        printf("%10lld %12.1f %10.3f %10.3f %12lld %8lld  %s\n",
+               s->GetNCall(), 1000*s->GetTotalTime(), 1000*s->GetMeanTime(),
+               1000*s->GetMaxTime(), s->GetNRow(), s->GetNSlow(), s->GetShape());
+    }
+
+    // clean-up
+    delete list;
+}
+
+//______________________________________________________________________________
+TString TCQueryStats::Normalize(const Char_t* query)
+{
+    // Return the shape of the query 'query', i.e. the query with all string
+    // and numeric literals (and NULL) replaced by '?', the numbers of the
+    // parameter columns replaced by '?', whitespace collapsed and lists of
+    // literals and parameter columns collapsed to one element.
+
+    TString shape;
+    Int_t n = strlen(query);
+    Char_t last = ' ';
+
+    // loop over the query
+    for (Int_t i = 0; i < n; i++)
+    {
+        Char_t c = query[i];
+
+        // collapse whitespace
+        if (isspace(c))
+        {
+            if (last != ' ') shape.Append(' ');
+            last = ' ';
+            continue;
+        }
+
+        // string literals
+        if (c == '\'' || c == '"')
+        {
+            for (i++; i < n; i++)
+            {
+                if (query[i] == '\\') i++;
+                else if (query[i] == c)
+                {
+                    if (i+1 < n && query[i+1] == c) i++;
+                    else break;
+                }
+            }
+            shape.Append('?');
+        }
+        // identifiers, keywords and numeric literals
+        else if (isalnum(c) || c == '_' ||
+                 (c == '-' && i+1 < n && isdigit(query[i+1]) && strchr(" (,=<>", last)))
+        {
+            Int_t start = i;
+            for (i++; i < n; i++)
+            {
+                Char_t d = query[i];
+                if (isalnum(d) || d == '_' || d == '.') continue;
+                if ((d == '-' || d == '+') && (query[i-1] == 'e' || query[i-1] == 'E') &&
+                    (isdigit(query[start]) || query[start] == '-')) continue;
+                break;
+            }
+            TString word(query+start, i-start);
+            i--;
+
+            // replace literals
+            if (isdigit(word[0]) || word[0] == '-' || !word.CompareTo("NULL", TString::kIgnoreCase))
+                shape.Append('?');
+            else if (word.BeginsWith("par_") && TString(word(4, word.Length()-4)).IsDigit())
+                shape.Append("par_?");
+            else shape.Append(word);
+        }
+        else shape.Append(c);
+
+        last = shape.Length() ? shape[shape.Length()-1] : ' ';
+    }
+    shape = shape.Strip(TString::kBoth);
+
+    // collapse lists
+    const Char_t* lists[][2] = { { "?, ?",                 "?"         },
+                                 { "?,?",                  "?"         },
+                                 { "(?), (?)",             "(?)"       },
+                                 { "(?),(?)",              "(?)"       },
+                                 { "par_? = ?, par_? = ?", "par_? = ?" },
+                                 { "par_? = ?,par_? = ?",  "par_? = ?" },
+                                 { "par_?, par_?",         "par_?"     },
+                                 { "par_?,par_?",          "par_?"     } };
+    Int_t nList = sizeof(lists) / sizeof(lists[0]);
+    for (Int_t i = 0; i < nList; i++)
+    {
+        Int_t length;
+        do
+        {
+            length = shape.Length();
+            shape.ReplaceAll(lists[i][0], lists[i][1]);
+        } while (shape.Length() != length);
+    }
+
+    return shape;
+}
+
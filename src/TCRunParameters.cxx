@@ -0,0 +1,184 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCRunParameters                                                      //
+//                                                                      //
+// Calibration parameters of many runs.                                 //
+//                                                                      //
+// The parameters of every set are stored only once and shared by all   //
+// runs belonging to this set.                                          //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include "TCRunParameters.h"
+
+ClassImp(TCRunParameters)
+
+
+//______________________________________________________________________________
+TCRunParameters::TCRunParameters(Int_t nData, const Char_t* const* data, 
+                                 Int_t nRun, const Int_t* runs)
+    : TObject()
+{
+    // Constructor for the 'nData' calibration data 'data' of the 'nRun' 
+    // runs 'runs'.
+    
+    // init data
+    fNData = nData;
+    fData = new TString[fNData];
+    fNPar = new Int_t[fNData];
+    fNSet = new Int_t[fNData];
+    fPar = new Double_t**[fNData];
+    for (Int_t i = 0; i < fNData; i++)
+    {
+        fData[i] = data[i];
+        fNPar[i] = 0;
+        fNSet[i] = 0;
+        fPar[i] = 0;
+    }
+
+    // init runs
+    fNRun = nRun;
+    fRun = new Int_t[fNRun];
+    for (Int_t i = 0; i < fNRun; i++) fRun[i] = runs[i];
+    fRunOrder = new Int_t[fNRun];
+    TMath::Sort(fNRun, fRun, fRunOrder, kFALSE);
+    fSet = new Int_t[fNData*fNRun];
+    for (Int_t i = 0; i < fNData*fNRun; i++) fSet[i] = -1;
+}
+
+//______________________________________________________________________________
+TCRunParameters::~TCRunParameters()
+{
+    // Destructor.
+
+    if (fPar)
+    {
+        for (Int_t i = 0; i < fNData; i++)
+        {
+            if (!fPar[i]) continue;
+            for (Int_t j = 0; j < fNSet[i]; j++)
+                if (fPar[i][j]) delete [] fPar[i][j];
+            delete [] fPar[i];
+        }
+        delete [] fPar;
+    }
+    if (fData) delete [] fData;
+    if (fNPar) delete [] fNPar;
+    if (fNSet) delete [] fNSet;
+    if (fRun) delete [] fRun;
+    if (fRunOrder) delete [] fRunOrder;
+    if (fSet) delete [] fSet;
+}
+
+//______________________________________________________________________________
+void TCRunParameters::SetData(Int_t d, Int_t nPar, Int_t nSet)
+{
+    // Set the number of parameters 'nPar' and the number of sets 'nSet' of 
+    // the calibration data with index 'd'.
+
+    // clean-up old parameters
+    if (fPar[d])
+    {
+        for (Int_t j = 0; j < fNSet[d]; j++)
+            if (fPar[d][j]) delete [] fPar[d][j];
+        delete [] fPar[d];
+    }
+    
+    // set new values
+    fNPar[d] = nPar;
+    fNSet[d] = nSet;
+    fPar[d] = new Double_t*[nSet];
+    for (Int_t j = 0; j < nSet; j++) fPar[d][j] = 0;
+}
+
+//______________________________________________________________________________
+void TCRunParameters::SetParameters(Int_t d, Int_t set, const Double_t* par)
+{
+    // Set the parameters 'par' of the set 'set' of the calibration data with 
+    // index 'd'.
+
+    if (!fPar[d][set]) fPar[d][set] = new Double_t[fNPar[d]];
+    for (Int_t i = 0; i < fNPar[d]; i++) fPar[d][set][i] = par[i];
+}
+
+//______________________________________________________________________________
+void TCRunParameters::ClearParameters(Int_t d, Int_t set)
+{
+    // Remove the parameters of the set 'set' of the calibration data with
+    // index 'd'.
+
+    if (fPar[d][set]) delete [] fPar[d][set];
+    fPar[d][set] = 0;
+}
+
+//______________________________________________________________________________
+const Double_t* TCRunParameters::GetParameters(Int_t d, Int_t i) const
+{
+    // Return the parameters of the calibration data with index 'd' valid for 
+    // the run with index 'i'. Return 0 if there are no parameters for this run.
+    
+    Int_t set = GetSet(d, i);
+    if (HasParameters(d, set)) return fPar[d][set];
+    else return 0;
+}
+
+//______________________________________________________________________________
+Bool_t TCRunParameters::GetParameters(const Char_t* data, Int_t run, 
+                                      Double_t* par, Int_t length) const
+{
+    // Copy 'length' parameters of the calibration data 'data' valid for the
+    // run 'run' to the value array 'par'.
+    // Return kFALSE if there are no such parameters, otherwise kTRUE.
+
+    // find data and run
+    Int_t d = FindData(data);
+    Int_t i = FindRun(run);
+    if (d == -1 || i == -1) return kFALSE;
+
+    // get parameters
+    const Double_t* p = GetParameters(d, i);
+    if (!p) return kFALSE;
+
+    // copy parameters
+    for (Int_t j = 0; j < length; j++) par[j] = j < fNPar[d] ? p[j] : 0;
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+Int_t TCRunParameters::FindData(const Char_t* data) const
+{
+    // Return the index of the calibration data 'data' or -1 if it was not 
+    // found.
+
+    for (Int_t i = 0; i < fNData; i++)
+        if (fData[i] == data) return i;
+
+    return -1;
+}
+
+//______________________________________________________________________________
+Int_t TCRunParameters::FindRun(Int_t run) const
+{
+    // Return the index of the run 'run' or -1 if it was not found.
+
+    // binary search in the sorted runs
+    Int_t lo = 0;
+    Int_t hi = fNRun;
+    while (lo < hi)
+    {
+        Int_t mid = (lo + hi) / 2;
+        if (fRun[fRunOrder[mid]] < run) lo = mid + 1;
+        else hi = mid;
+    }
+
+    // check run
+    if (lo < fNRun && fRun[fRunOrder[lo]] == run) return fRunOrder[lo];
+    else return -1;
+}
+
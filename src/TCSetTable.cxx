@@ -0,0 +1,110 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCSetTable                                                           //
+//                                                                      //
+// Run ranges and information of the sets of a calibration.             //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include <ctime>
+
+#include "TCSetTable.h"
+
+ClassImp(TCSetTable)
+
+
+//______________________________________________________________________________
+TCSetTable::TCSetTable(const Char_t* name, const Char_t* calibration, Int_t nSet)
+    : TNamed(name, name)
+{
+    // Constructor of a table named 'name' containing 'nSet' sets of the
+    // calibration identifier 'calibration'.
+    
+    fCalibration = calibration;
+    fNSet = nSet;
+    fFirstRun = new Int_t[fNSet];
+    fLastRun = new Int_t[fNSet];
+    fDesc = new TString[fNSet];
+    fChanged = new TString[fNSet];
+    fLoadTime = (Long_t) time(0);
+    for (Int_t i = 0; i < fNSet; i++)
+    {
+        fFirstRun[i] = 0;
+        fLastRun[i] = 0;
+    }
+}
+
+//______________________________________________________________________________
+TCSetTable::TCSetTable(const TCSetTable& t)
+    : TNamed(t)
+{
+    // Copy constructor.
+
+    fCalibration = t.fCalibration;
+    fNSet = t.fNSet;
+    fFirstRun = new Int_t[fNSet];
+    fLastRun = new Int_t[fNSet];
+    fDesc = new TString[fNSet];
+    fChanged = new TString[fNSet];
+    fLoadTime = t.fLoadTime;
+    for (Int_t i = 0; i < fNSet; i++)
+    {
+        fFirstRun[i] = t.fFirstRun[i];
+        fLastRun[i] = t.fLastRun[i];
+        fDesc[i] = t.fDesc[i];
+        fChanged[i] = t.fChanged[i];
+    }
+}
+
+//______________________________________________________________________________
+TCSetTable::~TCSetTable()
+{
+    // Destructor.
+
+    if (fFirstRun) delete [] fFirstRun;
+    if (fLastRun) delete [] fLastRun;
+    if (fDesc) delete [] fDesc;
+    if (fChanged) delete [] fChanged;
+}
+
+//______________________________________________________________________________
+void TCSetTable::SetSet(Int_t set, Int_t first_run, Int_t last_run,
+                        const Char_t* desc, const Char_t* changed)
+{
+    // Set the first run 'first_run', the last run 'last_run', the description
+    // 'desc' and the change time 'changed' of the set 'set'.
+    // NOTE: the sets have to be ordered by their first run.
+
+    fFirstRun[set] = first_run;
+    fLastRun[set] = last_run;
+    fDesc[set] = desc ? desc : "";
+    fChanged[set] = changed ? changed : "";
+}
+
+//______________________________________________________________________________
+Int_t TCSetTable::FindSet(Int_t run) const
+{
+    // Return the number of the set the run 'run' belongs to using a binary 
+    // search. Return -1 if there is no such set.
+
+    // find the last set starting before or at the run
+    Int_t lo = 0;
+    Int_t hi = fNSet;
+    while (lo < hi)
+    {
+        Int_t mid = (lo + hi) / 2;
+        if (fFirstRun[mid] <= run) lo = mid + 1;
+        else hi = mid;
+    }
+
+    // check if the run is in this set
+    Int_t set = lo - 1;
+    if (set >= 0 && run <= fLastRun[set]) return set;
+    else return -1;
+}
+
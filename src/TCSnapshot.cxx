@@ -0,0 +1,552 @@
+/*************************************************************************
+ * Author: Dominik Werthmueller
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCSnapshot                                                           //
+//                                                                      //
+// Read-only memory-mapped calibration snapshot file.                   //
+//                                                                      //
+// A snapshot contains all sets of all calibration data of one          //
+// calibration, the sets of all runs and the run information. The file  //
+// is written in the native byte order and consists of                  //
+//   - the header                                                       //
+//   - the data records (ordered by data name)                          //
+//   - the run records (ordered by run number)                          //
+//   - per data: the run ranges of the sets, the sets of the runs and   //
+//     the parameters of the sets                                       //
+// All sections are 8-byte aligned. The parameters are accessed         //
+// directly in the mapped file.                                         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "TMath.h"
+#include "TObjString.h"
+#include "TObjArray.h"
+
+#include "TCSnapshot.h"
+
+ClassImp(TCSnapshot)
+
+
+// snapshot file identification
+static const Char_t gSnapshotMagic[8] = { 'C', 'a', 'L', 'i', 'b', 'S', 'n', 'p' };
+static const Int_t gSnapshotVersion = 1;
+static const Int_t gSnapshotByteOrder = 0x01020304;
+
+
+// header of a snapshot file
+struct TCSnapshotHeader
+{
+    Char_t fMagic[8];               // file identification
+    Int_t fVersion;                 // format version
+    Int_t fByteOrder;               // byte order mark
+    Int_t fNData;                   // number of calibration data
+    Int_t fNRun;                    // number of runs
+    Long64_t fDataOffset;           // offset of the data records
+    Long64_t fRunOffset;            // offset of the run records
+    Long64_t fSize;                 // file size
+    Char_t fCalibration[256];       // calibration identifier
+};
+
+
+// calibration data record of a snapshot file
+struct TCSnapshotData
+{
+    Char_t fName[64];               // calibration data
+    Int_t fNPar;                    // number of parameters per set
+    Int_t fNSet;                    // number of sets
+    Long64_t fSetOffset;            // offset of the first and last runs of the sets
+    Long64_t fSetOfRunOffset;       // offset of the sets of the runs
+    Long64_t fParOffset;            // offset of the parameters of the sets
+};
+
+
+//______________________________________________________________________________
+static Long64_t Align(Long64_t n)
+{
+    // Return 'n' rounded up to a multiple of 8.
+
+    return (n + 7) & ~((Long64_t) 7);
+}
+
+//______________________________________________________________________________
+static Bool_t WritePadding(FILE* f, Long64_t n)
+{
+    // Write zeros to the file 'f' until the 'n' written bytes are 8-byte
+    // aligned.
+    // Return kTRUE on success, otherwise kFALSE.
+
+    static const Char_t zero[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    Long64_t pad = Align(n) - n;
+
+    return pad ? fwrite(zero, 1, pad, f) == (size_t) pad : kTRUE;
+}
+
+//______________________________________________________________________________
+static Bool_t IsInFile(Long64_t offset, Long64_t n, Long64_t size, Long64_t fileSize)
+{
+    // Check if the 'n' elements of the size 'size' at the offset 'offset'
+    // are inside the file of the size 'fileSize'.
+
+    if (offset < 0 || n < 0 || offset > fileSize) return kFALSE;
+    return n <= (fileSize - offset) / size ? kTRUE : kFALSE;
+}
+
+//______________________________________________________________________________
+static Bool_t CheckSections(const Char_t* map, Long64_t size)
+{
+    // Check if all sections of the snapshot file mapped to 'map' having the
+    // size 'size' are inside the file and if all strings are terminated.
+
+    // check the header
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) map;
+    if (h->fCalibration[sizeof(h->fCalibration)-1]) return kFALSE;
+    if (!IsInFile(h->fDataOffset, h->fNData, sizeof(TCSnapshotData), size)) return kFALSE;
+    if (!IsInFile(h->fRunOffset, h->fNRun, sizeof(TCSnapshotRun), size)) return kFALSE;
+
+    // check the data records
+    const TCSnapshotData* data = (const TCSnapshotData*) (map + h->fDataOffset);
+    for (Int_t d = 0; d < h->fNData; d++)
+    {
+        if (data[d].fName[sizeof(data[d].fName)-1]) return kFALSE;
+        if (data[d].fNPar < 0 || data[d].fNSet < 0) return kFALSE;
+        if (!IsInFile(data[d].fSetOffset, 2 * (Long64_t) data[d].fNSet, sizeof(Int_t), size)) return kFALSE;
+        if (!IsInFile(data[d].fSetOfRunOffset, h->fNRun, sizeof(Int_t), size)) return kFALSE;
+        if (!IsInFile(data[d].fParOffset, (Long64_t) data[d].fNSet * data[d].fNPar, 
+                      sizeof(Double_t), size)) return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+//______________________________________________________________________________
+static void CopyString(Char_t* dest, const Char_t* src, Int_t size)
+{
+    // Copy the string 'src' to the buffer 'dest' of the size 'size'.
+
+    strncpy(dest, src ? src : "", size - 1);
+    dest[size - 1] = '\0';
+}
+
+//______________________________________________________________________________
+TCSnapshot::TCSnapshot(const Char_t* filename)
+    : TObject()
+{
+    // Constructor mapping the snapshot file 'filename'.
+
+    // init members
+    fFileName = filename;
+    fMap = 0;
+    fSize = 0;
+    fNData = 0;
+    fNRun = 0;
+
+    // open the file
+    Int_t fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        Error("TCSnapshot", "Could not open the snapshot file '%s'!", filename);
+        return;
+    }
+
+    // map the file
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (!fstat(fd, &st) && st.st_size >= (off_t) sizeof(TCSnapshotHeader))
+        map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        Error("TCSnapshot", "Could not map the snapshot file '%s'!", filename);
+        return;
+    }
+
+    // check the header
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) map;
+    if (memcmp(h->fMagic, gSnapshotMagic, 8) || h->fVersion != gSnapshotVersion ||
+        h->fByteOrder != gSnapshotByteOrder || h->fSize != (Long64_t) st.st_size)
+    {
+        Error("TCSnapshot", "'%s' is not a valid snapshot file of this CaLib version and platform!", filename);
+        munmap(map, st.st_size);
+        return;
+    }
+
+    // check the sections
+    if (!CheckSections((const Char_t*) map, st.st_size))
+    {
+        Error("TCSnapshot", "The snapshot file '%s' is truncated or corrupted!", filename);
+        munmap(map, st.st_size);
+        return;
+    }
+
+    // set members
+    fMap = (Char_t*) map;
+    fSize = st.st_size;
+    fNData = h->fNData;
+    fNRun = h->fNRun;
+}
+
+//______________________________________________________________________________
+TCSnapshot::~TCSnapshot()
+{
+    // Destructor.
+
+    if (fMap) munmap(fMap, fSize);
+}
+
+//______________________________________________________________________________
+const Char_t* TCSnapshot::GetCalibration() const
+{
+    // Return the calibration identifier of the snapshot.
+
+    return fMap ? ((const TCSnapshotHeader*) fMap)->fCalibration : 0;
+}
+
+//______________________________________________________________________________
+const Char_t* TCSnapshot::GetData(Int_t d) const
+{
+    // Return the name of the calibration data with the index 'd'.
+
+    if (!fMap || d < 0 || d >= fNData) return 0;
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+    const TCSnapshotData* data = (const TCSnapshotData*) (fMap + h->fDataOffset);
+
+    return data[d].fName;
+}
+
+//______________________________________________________________________________
+Int_t TCSnapshot::FindData(const Char_t* data) const
+{
+    // Return the index of the calibration data 'data' or -1 if the data
+    // is not contained in the snapshot.
+
+    if (!fMap) return -1;
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+    const TCSnapshotData* d = (const TCSnapshotData*) (fMap + h->fDataOffset);
+
+    // binary search in the data records ordered by name
+    Int_t lo = 0;
+    Int_t hi = fNData - 1;
+    while (lo <= hi)
+    {
+        Int_t mid = (lo + hi) / 2;
+        Int_t cmp = strcmp(d[mid].fName, data);
+        if (!cmp) return mid;
+        else if (cmp < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+
+    return -1;
+}
+
+//______________________________________________________________________________
+Int_t TCSnapshot::GetNParameters(const Char_t* data) const
+{
+    // Return the number of parameters per set of the calibration data 'data'.
+
+    Int_t d = FindData(data);
+    if (d == -1) return 0;
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+
+    return ((const TCSnapshotData*) (fMap + h->fDataOffset))[d].fNPar;
+}
+
+//______________________________________________________________________________
+Int_t TCSnapshot::FindRun(Int_t run) const
+{
+    // Return the index of the run 'run' or -1 if the run is not contained
+    // in the snapshot.
+
+    if (!fMap) return -1;
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+    const TCSnapshotRun* r = (const TCSnapshotRun*) (fMap + h->fRunOffset);
+
+    // binary search in the run records ordered by run number
+    Int_t lo = 0;
+    Int_t hi = fNRun - 1;
+    while (lo <= hi)
+    {
+        Int_t mid = (lo + hi) / 2;
+        if (r[mid].fRun == run) return mid;
+        else if (r[mid].fRun < run) lo = mid + 1;
+        else hi = mid - 1;
+    }
+
+    return -1;
+}
+
+//______________________________________________________________________________
+const TCSnapshotRun* TCSnapshot::GetRun(Int_t run) const
+{
+    // Return the information of the run 'run' or 0 if the run is not
+    // contained in the snapshot.
+
+    Int_t i = FindRun(run);
+    if (i == -1) return 0;
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+
+    return ((const TCSnapshotRun*) (fMap + h->fRunOffset)) + i;
+}
+
+//______________________________________________________________________________
+Int_t TCSnapshot::GetSet(const Char_t* data, Int_t run) const
+{
+    // Return the set of the calibration data 'data' of the run 'run' or -1
+    // if the run has no set.
+
+    // find data and run
+    Int_t d = FindData(data);
+    Int_t i = FindRun(run);
+    if (d == -1 || i == -1) return -1;
+
+    // get the set
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+    const TCSnapshotData* rec = ((const TCSnapshotData*) (fMap + h->fDataOffset)) + d;
+
+    return ((const Int_t*) (fMap + rec->fSetOfRunOffset))[i];
+}
+
+//______________________________________________________________________________
+const Double_t* TCSnapshot::GetParameters(const Char_t* data, Int_t run, Int_t* outLength) const
+{
+    // Return the parameters of the calibration data 'data' valid for the run
+    // 'run' and write their number to 'outLength' if it is non-zero.
+    // The returned array points into the mapped file and is valid as long
+    // as this object exists.
+    // Return 0 if no parameters were found.
+
+    if (outLength) *outLength = 0;
+
+    // find data and run
+    Int_t d = FindData(data);
+    Int_t i = FindRun(run);
+    if (d == -1 || i == -1) return 0;
+
+    // get the set
+    const TCSnapshotHeader* h = (const TCSnapshotHeader*) fMap;
+    const TCSnapshotData* rec = ((const TCSnapshotData*) (fMap + h->fDataOffset)) + d;
+    Int_t set = ((const Int_t*) (fMap + rec->fSetOfRunOffset))[i];
+    if (set < 0 || set >= rec->fNSet) return 0;
+
+    // return the parameters
+    if (outLength) *outLength = rec->fNPar;
+    return ((const Double_t*) (fMap + rec->fParOffset)) + (Long64_t) set * rec->fNPar;
+}
+
+//______________________________________________________________________________
+Bool_t TCSnapshot::Write(const Char_t* filename, TCContainer* container, const Char_t* calibration)
+{
+    // Write all runs and all sets of the calibration 'calibration' of the
+    // CaLib container 'container' to the snapshot file 'filename'.
+    // The file is written to a temporary file first and renamed at the end
+    // so that readers never see incomplete snapshots.
+    // Return kTRUE on success, otherwise kFALSE.
+
+    //
+    // collect the data
+    //
+
+    // collect the calibration data
+    TList dataNames;
+    dataNames.SetOwner(kTRUE);
+    TIter nextCalib(container->GetCalibrations());
+    TCCalibration* c;
+    while ((c = (TCCalibration*)nextCalib()))
+    {
+        if (strcmp(c->GetCalibration(), calibration)) continue;
+        if (!dataNames.FindObject(c->GetCalibData())) dataNames.Add(new TObjString(c->GetCalibData()));
+    }
+    dataNames.Sort();
+    Int_t nData = dataNames.GetSize();
+
+    // collect the runs in ascending order
+    Int_t nRun = container->GetNRuns();
+    TCRun** runs = new TCRun*[nRun > 0 ? nRun : 1];
+    Int_t* runNumber = new Int_t[nRun > 0 ? nRun : 1];
+    Int_t* runOrder = new Int_t[nRun > 0 ? nRun : 1];
+    TIter nextRun(container->GetRuns());
+    TCRun* r;
+    Int_t nr = 0;
+    while ((r = (TCRun*)nextRun()))
+    {
+        runs[nr] = r;
+        runNumber[nr++] = r->GetRun();
+    }
+    TMath::Sort(nRun, runNumber, runOrder, kFALSE);
+
+    // collect the sets of the data in ascending order
+    TObjArray* sets = new TObjArray[nData > 0 ? nData : 1];
+    TCSnapshotData* data = new TCSnapshotData[nData > 0 ? nData : 1];
+    for (Int_t d = 0; d < nData; d++)
+    {
+        const Char_t* name = dataNames.At(d)->GetName();
+        memset(&data[d], 0, sizeof(TCSnapshotData));
+        CopyString(data[d].fName, name, sizeof(data[d].fName));
+
+        // collect the sets
+        TObjArray unsorted;
+        nextCalib.Reset();
+        while ((c = (TCCalibration*)nextCalib()))
+        {
+            if (strcmp(c->GetCalibration(), calibration) || strcmp(c->GetCalibData(), name)) continue;
+            unsorted.Add(c);
+            data[d].fNPar = TMath::Max(data[d].fNPar, c->GetNParameters());
+        }
+
+        // sort the sets by their first run
+        Int_t nSet = unsorted.GetEntriesFast();
+        Int_t* first = new Int_t[nSet > 0 ? nSet : 1];
+        Int_t* order = new Int_t[nSet > 0 ? nSet : 1];
+        for (Int_t i = 0; i < nSet; i++) first[i] = ((TCCalibration*) unsorted[i])->GetFirstRun();
+        TMath::Sort(nSet, first, order, kFALSE);
+        for (Int_t i = 0; i < nSet; i++) sets[d].Add(unsorted[order[i]]);
+        data[d].fNSet = nSet;
+        delete [] first;
+        delete [] order;
+    }
+
+    //
+    // calculate the layout of the file
+    //
+
+    TCSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.fMagic, gSnapshotMagic, 8);
+    header.fVersion = gSnapshotVersion;
+    header.fByteOrder = gSnapshotByteOrder;
+    header.fNData = nData;
+    header.fNRun = nRun;
+    CopyString(header.fCalibration, calibration, sizeof(header.fCalibration));
+    Long64_t offset = Align(sizeof(TCSnapshotHeader));
+    header.fDataOffset = offset;
+    offset += Align(nData * sizeof(TCSnapshotData));
+    header.fRunOffset = offset;
+    offset += Align(nRun * sizeof(TCSnapshotRun));
+    for (Int_t d = 0; d < nData; d++)
+    {
+        data[d].fSetOffset = offset;
+        offset += Align(2 * data[d].fNSet * sizeof(Int_t));
+        data[d].fSetOfRunOffset = offset;
+        offset += Align(nRun * sizeof(Int_t));
+        data[d].fParOffset = offset;
+        offset += (Long64_t) data[d].fNSet * data[d].fNPar * sizeof(Double_t);
+    }
+    header.fSize = offset;
+
+    //
+    // write the file
+    //
+
+    // open the temporary file
+    TString tmpName = TString::Format("%s.tmp", filename);
+    FILE* f = fopen(tmpName.Data(), "wb");
+    if (!f)
+    {
+        ::Error("TCSnapshot::Write", "Could not create the snapshot file '%s'!", tmpName.Data());
+        delete [] runs;
+        delete [] runNumber;
+        delete [] runOrder;
+        delete [] sets;
+        delete [] data;
+        return kFALSE;
+    }
+
+    // write header and data records
+    Bool_t ok = fwrite(&header, sizeof(header), 1, f) == 1 && WritePadding(f, sizeof(header));
+    if (nData) ok = ok && fwrite(data, sizeof(TCSnapshotData), nData, f) == (size_t) nData;
+    ok = ok && WritePadding(f, nData * sizeof(TCSnapshotData));
+
+    // write the run records
+    for (Int_t i = 0; ok && i < nRun; i++)
+    {
+        TCRun* run = runs[runOrder[i]];
+        TCSnapshotRun rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.fRun = run->GetRun();
+        rec.fNScR = run->GetNScalerReads();
+        rec.fSize = run->GetSize();
+        rec.fTargetPolDeg = run->GetTargetPolDeg();
+        rec.fBeamPolDeg = run->GetBeamPolDeg();
+        CopyString(rec.fTime, run->GetTime(), sizeof(rec.fTime));
+        CopyString(rec.fFileName, run->GetFileName(), sizeof(rec.fFileName));
+        CopyString(rec.fTarget, run->GetTarget(), sizeof(rec.fTarget));
+        CopyString(rec.fTargetPol, run->GetTargetPol(), sizeof(rec.fTargetPol));
+        CopyString(rec.fBeamPol, run->GetBeamPol(), sizeof(rec.fBeamPol));
+        ok = fwrite(&rec, sizeof(rec), 1, f) == 1;
+    }
+    ok = ok && WritePadding(f, nRun * sizeof(TCSnapshotRun));
+
+    // write the sets of the data
+    for (Int_t d = 0; ok && d < nData; d++)
+    {
+        Int_t nSet = data[d].fNSet;
+        Int_t nPar = data[d].fNPar;
+
+        // write the run ranges of the sets
+        Int_t* first = new Int_t[nSet > 0 ? nSet : 1];
+        for (Int_t i = 0; ok && i < nSet; i++)
+        {
+            TCCalibration* s = (TCCalibration*) sets[d][i];
+            Int_t range[2] = { s->GetFirstRun(), s->GetLastRun() };
+            first[i] = range[0];
+            ok = fwrite(range, sizeof(Int_t), 2, f) == 2;
+        }
+        ok = ok && WritePadding(f, 2 * nSet * sizeof(Int_t));
+
+        // write the sets of the runs
+        for (Int_t i = 0; ok && i < nRun; i++)
+        {
+            Int_t run = runNumber[runOrder[i]];
+            Int_t set = nSet ? TMath::BinarySearch(nSet, first, run) : -1;
+            if (set >= 0 && run > ((TCCalibration*) sets[d][set])->GetLastRun()) set = -1;
+            ok = fwrite(&set, sizeof(Int_t), 1, f) == 1;
+        }
+        ok = ok && WritePadding(f, nRun * sizeof(Int_t));
+
+        // write the parameters of the sets
+        Double_t* par = new Double_t[nPar > 0 ? nPar : 1];
+        for (Int_t i = 0; ok && i < nSet; i++)
+        {
+            TCCalibration* s = (TCCalibration*) sets[d][i];
+            for (Int_t j = 0; j < nPar; j++) par[j] = j < s->GetNParameters() ? s->GetParameters()[j] : 0;
+            if (nPar) ok = fwrite(par, sizeof(Double_t), nPar, f) == (size_t) nPar;
+        }
+
+        // clean-up
+        delete [] first;
+        delete [] par;
+    }
+
+    // clean-up
+    delete [] runs;
+    delete [] runNumber;
+    delete [] runOrder;
+    delete [] sets;
+    delete [] data;
+
+    // close and rename the file
+    if (fclose(f)) ok = kFALSE;
+    if (ok && rename(tmpName.Data(), filename)) ok = kFALSE;
+    if (!ok)
+    {
+        ::Error("TCSnapshot::Write", "Could not write the snapshot file '%s'!", filename);
+        remove(tmpName.Data());
+        return kFALSE;
+    }
+
+    // user information
+    ::Info("TCSnapshot::Write", "Wrote %d calibration data and %d runs of the calibration '%s' to '%s'",
+         nData, nRun, calibration, filename);
+
+    return kTRUE;
+}
+
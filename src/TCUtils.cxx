@@ -11,6 +11,8 @@
 //////////////////////////////////////////////////////////////////////////
 
 
+#include <cstring>
+
 #include "TCUtils.h"
 
 
@@ -304,3 +306,30 @@ Double_t TCUtils::GetDiffPercent(Double_t oldValue, Double_t newValue)
     else return 100 * diff / oldValue;
 }
 
+
+//______________________________________________________________________________
+void TCUtils::PackDoubles(const Double_t* in, Int_t n, UChar_t* out)
+{
+    // Pack the 'n' values of 'in' as little-endian doubles into the 8*n bytes
+    // of 'out'.
+
+    for (Int_t i = 0; i < n; i++)
+    {
+        ULong64_t v;
+        memcpy(&v, &in[i], 8);
+        for (Int_t j = 0; j < 8; j++) out[8*i+j] = (UChar_t) (v >> (8*j));
+    }
+}
+
+//______________________________________________________________________________
+void TCUtils::UnpackDoubles(const UChar_t* in, Int_t n, Double_t* out)
+{
+    // Unpack 'n' little-endian doubles from the 8*n bytes of 'in' to 'out'.
+
+    for (Int_t i = 0; i < n; i++)
+    {
+        ULong64_t v = 0;
+        for (Int_t j = 0; j < 8; j++) v |= ((ULong64_t) in[8*i+j]) << (8*j);
+        memcpy(&out[i], &v, 8);
+    }
+}
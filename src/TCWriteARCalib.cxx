@@ -16,6 +16,22 @@
 ClassImp(TCWriteARCalib)
 
 
+// calibration data of the detectors (the CB time walk data have to be 
+// the last gNCBWalkData entries of gCBData)
+static const Char_t* gTaggerData[] = { "Data.Tagger.T0" };
+static const Char_t* gCBData[] = { "Data.CB.T0", "Data.CB.E1", 
+                                   "Data.CB.Walk.Par0", "Data.CB.Walk.Par1",
+                                   "Data.CB.Walk.Par2", "Data.CB.Walk.Par3" };
+static const Int_t gNCBWalkData = 4;
+static const Char_t* gTAPSData[] = { "Data.TAPS.T0", "Data.TAPS.T1", 
+                                     "Data.TAPS.LG.E0", "Data.TAPS.LG.E1", "Data.TAPS.CFD",
+                                     "Data.TAPS.SG.E0", "Data.TAPS.SG.E1" };
+static const Char_t* gPIDData[] = { "Data.PID.Phi", "Data.PID.T0", 
+                                    "Data.PID.E0", "Data.PID.E1" };
+static const Char_t* gVetoData[] = { "Data.Veto.T0", "Data.Veto.T1", 
+                                     "Data.Veto.E0", "Data.Veto.E1", "Data.Veto.LED" };
+
+
 //______________________________________________________________________________
 TCWriteARCalib::TCWriteARCalib(CalibDetector_t det, const Char_t* templateFile)
 {
@@ -52,8 +68,40 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
     Int_t nDetSG = 0;
     if (rSG) nDetSG = rSG->GetNelements();
 
+    // get the calibration data of the detector
+    const Char_t* const* data = 0;
+    Int_t nData = 0;
+    switch (fDetector)
+    {
+        case kDETECTOR_TAGG: 
+            data = gTaggerData; nData = sizeof(gTaggerData) / sizeof(gTaggerData[0]); break;
+        case kDETECTOR_CB: 
+            data = gCBData; nData = sizeof(gCBData) / sizeof(gCBData[0]);
+            if (!nDetTW) nData -= gNCBWalkData;
+            break;
+        case kDETECTOR_TAPS: 
+            data = gTAPSData; nData = sizeof(gTAPSData) / sizeof(gTAPSData[0]); break;
+        case kDETECTOR_PID: 
+            data = gPIDData; nData = sizeof(gPIDData) / sizeof(gPIDData[0]); break;
+        case kDETECTOR_VETO: 
+            data = gVetoData; nData = sizeof(gVetoData) / sizeof(gVetoData[0]); break;
+        case kDETECTOR_NODET: break;
+    }
+
+    // read all parameters of the run at once
+    TCRunParameters* p = nData ? m->ReadParametersRuns(calibration, nData, data, 1, &run) : 0;
+    if (nData && !p)
+    {
+        Error("Write", "Could not read the parameters of run %d of calibration '%s'!", 
+              run, calibration);
+        delete r;
+        if (rSG) delete rSG;
+        return;
+    }
+
     // create parameter array
-    Double_t par[nDet];
+    Int_t nMax = TMath::Max(TMath::Max(nDet, nDetTW), nDetSG);
+    Double_t* par = new Double_t[nMax > 0 ? nMax : 1];
 
     // check the detetector
     switch (fDetector)
@@ -61,7 +109,7 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
         case kDETECTOR_TAGG:
         {
             // read time offset
-            if (m->ReadParametersRun("Data.Tagger.T0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.Tagger.T0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetOffset(par[i]);
 
             break;
@@ -70,29 +118,29 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
         case kDETECTOR_CB:
         {
             // read time offset
-            if (m->ReadParametersRun("Data.CB.T0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.CB.T0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetOffset(par[i]);
 
             // read ADC gain
-            if (m->ReadParametersRun("Data.CB.E1", calibration, run, par, nDet))
+            if (p->GetParameters("Data.CB.E1", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetADCGain(par[i]);
             
             if (nDetTW)
             {
                 // read time walk parameter 0
-                if (m->ReadParametersRun("Data.CB.Walk.Par0", calibration, run, par, nDetTW))
+                if (p->GetParameters("Data.CB.Walk.Par0", run, par, nDetTW))
                     for (Int_t i = 0; i < nDetTW; i++) r->GetTimeWalk(i)->SetPar0(par[i]);
 
                 // read time walk parameter 1
-                if (m->ReadParametersRun("Data.CB.Walk.Par1", calibration, run, par, nDetTW))
+                if (p->GetParameters("Data.CB.Walk.Par1", run, par, nDetTW))
                     for (Int_t i = 0; i < nDetTW; i++) r->GetTimeWalk(i)->SetPar1(par[i]);
 
                 // read time walk parameter 2
-                if (m->ReadParametersRun("Data.CB.Walk.Par2", calibration, run, par, nDetTW))
+                if (p->GetParameters("Data.CB.Walk.Par2", run, par, nDetTW))
                     for (Int_t i = 0; i < nDetTW; i++) r->GetTimeWalk(i)->SetPar2(par[i]);
 
                 // read time walk parameter 3
-                if (m->ReadParametersRun("Data.CB.Walk.Par3", calibration, run, par, nDetTW))
+                if (p->GetParameters("Data.CB.Walk.Par3", run, par, nDetTW))
                     for (Int_t i = 0; i < nDetTW; i++) r->GetTimeWalk(i)->SetPar3(par[i]);
             }
 
@@ -101,33 +149,33 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
         case kDETECTOR_TAPS:
         {
             // read time offset
-            if (m->ReadParametersRun("Data.TAPS.T0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.TAPS.T0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetOffset(par[i]);
 
             // read TDC gain
-            if (m->ReadParametersRun("Data.TAPS.T1", calibration, run, par, nDet))
+            if (p->GetParameters("Data.TAPS.T1", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetTDCGain(par[i]);
 
             // read ADC pedestal
-            if (m->ReadParametersRun("Data.TAPS.LG.E0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.TAPS.LG.E0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetPedestal(par[i]);
 
             // read ADC gain
-            if (m->ReadParametersRun("Data.TAPS.LG.E1", calibration, run, par, nDet))
+            if (p->GetParameters("Data.TAPS.LG.E1", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetADCGain(par[i]);
             
             // read CFD threshold
-            if (m->ReadParametersRun("Data.TAPS.CFD", calibration, run, par, nDet))
+            if (p->GetParameters("Data.TAPS.CFD", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetEnergyLow(par[i]);
              
             if (nDetSG)
             {
                 // read SG ADC pedestal
-                if (m->ReadParametersRun("Data.TAPS.SG.E0", calibration, run, par, nDetSG))
+                if (p->GetParameters("Data.TAPS.SG.E0", run, par, nDetSG))
                     for (Int_t i = 0; i < nDetSG; i++) rSG->GetElement(i)->SetPedestal(par[i]);
 
                 // read SG ADC gain
-                if (m->ReadParametersRun("Data.TAPS.SG.E1", calibration, run, par, nDetSG))
+                if (p->GetParameters("Data.TAPS.SG.E1", run, par, nDetSG))
                     for (Int_t i = 0; i < nDetSG; i++) rSG->GetElement(i)->SetADCGain(par[i]);
             }
 
@@ -136,19 +184,19 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
         case kDETECTOR_PID:
         {
             // read phi angle
-            if (m->ReadParametersRun("Data.PID.Phi", calibration, run, par, nDet))
+            if (p->GetParameters("Data.PID.Phi", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetZ(par[i]);
 
             // read time offset
-            if (m->ReadParametersRun("Data.PID.T0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.PID.T0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetOffset(par[i]);
 
             // read ADC pedestal
-            if (m->ReadParametersRun("Data.PID.E0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.PID.E0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetPedestal(par[i]);
 
             // read ADC gain
-            if (m->ReadParametersRun("Data.PID.E1", calibration, run, par, nDet))
+            if (p->GetParameters("Data.PID.E1", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetADCGain(par[i]);
 
             break;
@@ -156,23 +204,23 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
         case kDETECTOR_VETO:
         {
             // read time offset
-            if (m->ReadParametersRun("Data.Veto.T0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.Veto.T0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetOffset(par[i]);
 
             // read TDC gain
-            if (m->ReadParametersRun("Data.Veto.T1", calibration, run, par, nDet))
+            if (p->GetParameters("Data.Veto.T1", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetTDCGain(par[i]);
             
             // read ADC pedestal
-            if (m->ReadParametersRun("Data.Veto.E0", calibration, run, par, nDet))
+            if (p->GetParameters("Data.Veto.E0", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetPedestal(par[i]);
 
             // read ADC gain
-            if (m->ReadParametersRun("Data.Veto.E1", calibration, run, par, nDet))
+            if (p->GetParameters("Data.Veto.E1", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetADCGain(par[i]);
 
             // read LED thresholds
-            if (m->ReadParametersRun("Data.Veto.LED", calibration, run, par, nDet))
+            if (p->GetParameters("Data.Veto.LED", run, par, nDet))
                 for (Int_t i = 0; i < nDet; i++) r->GetElement(i)->SetEnergyLow(par[i]);
 
             break;
@@ -182,6 +230,10 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
             break;
         }
     }
+
+    // clean-up
+    delete [] par;
+    if (p) delete p;
     
     // open the template file
     std::ifstream ftemp;
@@ -191,6 +243,8 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
     if (!ftemp.is_open())
     {
         Error("Write", "Could not open template AcquRoot calibration file!");
+        delete r;
+        if (rSG) delete rSG;
         return;
     }
  
@@ -198,6 +252,9 @@ void TCWriteARCalib::Write(const Char_t* calibFile,
     FILE* fout = fopen(calibFile, "w");
     if (!fout)
     {   Error("Write", "Could not open new AcquRoot calibration file!");
+        ftemp.close();
+        delete r;
+        if (rSG) delete rSG;
         return;
     }
 